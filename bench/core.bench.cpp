@@ -0,0 +1,399 @@
+#include "corpus.hpp"
+#include "harness.hpp"
+
+#include <text/buffer.hpp>
+#include <text/coordinate.hpp>
+#include <text/diff.hpp>
+#include <text/json-index.hpp>
+#include <text/lexer.hpp>
+#include <text/position-map.hpp>
+#include <text/position.hpp>
+#include <text/token-table.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <utils/raise.hpp>
+
+using namespace Text;
+using namespace Text_Bench;
+
+#ifndef TEXT_BUFFER_BUILD_TYPE
+#    define TEXT_BUFFER_BUILD_TYPE "unknown"
+#endif
+
+
+/**************************************************************
+ * text_buffer_bench: Microbenchmarks of the core types.
+ *
+ *   coordinate/...  Coordinate arithmetic & comparisons
+ *   position/...    Position ordering
+ *   buffer/...      load, offset <-> position lookups & edits, per
+ *                   synthetic corpus (see corpus.hpp)
+ *   search/...      substring search over a Buffer's text
+ *   lex/...         tokenizing a Buffer into words, numbers & punctuation
+ *   json/...        JSON structural indexing & lazy Position resolution
+ *   map/...         PositionMap against std::unordered_map
+ *
+ * Lookups cycle through LOOKUPS precomputed random inputs, so the
+ * loop measures the operation rather than the random generator.
+ **************************************************************/
+static constexpr size_t LOOKUPS = 4096;  // Power of two
+
+
+
+
+/****************************************************************
+ * @returns <std::vector<size_t>> LOOKUPS random offsets into
+ *   `text` (including its end), each at a code-point boundary.
+ ****************************************************************/
+static std::vector<size_t> random_offsets(std::string_view text, uint64_t seed)
+{
+    CorpusRng           rng{ seed };
+    std::vector<size_t> offsets(LOOKUPS);
+
+    for (size_t &offset : offsets) {
+        offset = rng.below(text.size() + 1);
+        while (offset < text.size() && (static_cast<unsigned char>(text[offset]) & 0xC0) == 0x80) {
+            --offset;
+        }
+    }
+
+    return offsets;
+}
+
+
+
+
+static void add_coordinate_cases(std::vector<Case> &cases)
+{
+    static std::vector<Coordinate> coords;
+    CorpusRng                      rng{ 7 };
+    for (size_t i = 0; i < LOOKUPS; ++i) { coords.push_back(Coordinate(1 + rng.below(1u << 20))); }
+
+    cases.push_back({ "coordinate/add", 0, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            keep(coords[i & (LOOKUPS - 1)] + coords[(i + 1) & (LOOKUPS - 1)]);
+        }
+    } });
+
+    cases.push_back({ "coordinate/subtract", 0, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const Coordinate &a = coords[i & (LOOKUPS - 1)];
+            const Coordinate &b = coords[(i + 1) & (LOOKUPS - 1)];
+            keep(a >= b ? a - b : b - a);
+        }
+    } });
+
+    cases.push_back({ "coordinate/multiply", 0, [](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            keep(coords[i & (LOOKUPS - 1)] * Coordinate(3));
+        }
+    } });
+
+    cases.push_back({ "coordinate/compare", 0, [](size_t n) {
+        size_t less = 0;
+        for (size_t i = 0; i < n; ++i) {
+            less += coords[i & (LOOKUPS - 1)] < coords[(i + 7) & (LOOKUPS - 1)];
+        }
+        keep(less);
+    } });
+}
+
+
+
+
+static void add_position_cases(std::vector<Case> &cases)
+{
+    static std::vector<Position> positions;
+    CorpusRng                    rng{ 11 };
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        positions.push_back(Position(1 + rng.below(2000), 1 + rng.below(120)));
+    }
+
+    cases.push_back({ "position/compare", 0, [](size_t n) {
+        size_t less = 0;
+        for (size_t i = 0; i < n; ++i) {
+            less += positions[i & (LOOKUPS - 1)] < positions[(i + 7) & (LOOKUPS - 1)];
+        }
+        keep(less);
+    } });
+
+    // One op = copying & sorting all LOOKUPS positions.
+    cases.push_back({ "position/sort_4096", 0, [](size_t n) {
+        std::vector<Position> sorted;
+        for (size_t i = 0; i < n; ++i) {
+            sorted = positions;
+            std::sort(sorted.begin(), sorted.end());
+            keep(sorted.front());
+        }
+    } });
+}
+
+
+
+
+/****************************************************************
+ * @returns <Lexicon> Words (including non-ASCII bytes), numbers &
+ *   skipped whitespace; any other byte is a one-byte token.
+ ****************************************************************/
+static Lexicon word_lexicon()
+{
+    const CharSet word  = CharSet::range('a', 'z') | CharSet::range('A', 'Z') | CharSet::utf8();
+    const CharSet digit = CharSet::range('0', '9');
+    const CharSet space = CharSet::of(" \t\r\n");
+
+    Lexicon lexicon(0);
+    lexicon.run(1, word, word | digit).run(2, digit, digit).run(3, space, space).skip(3);
+    return lexicon;
+}
+
+
+
+static void add_buffer_cases(std::vector<Case> &cases, CorpusKind kind, size_t bytes)
+{
+    struct Fixture
+    {
+        std::string                 text;
+        Buffer                      buffer;
+        std::vector<size_t>         offsets;
+        std::vector<size_t>         sorted;
+        std::vector<Position>       positions;
+        std::unique_ptr<TokenTable> tokens;  /// Built by the first lex/update run
+        Buffer                      edited;  /// The corpus with lines added at 64 places
+    };
+
+    auto fixture     = std::make_shared<Fixture>();
+    fixture->text    = generate_corpus(kind, bytes);
+    fixture->buffer  = Buffer(fixture->text);
+    fixture->offsets = random_offsets(fixture->text, 3);
+    fixture->sorted  = fixture->offsets;
+    std::sort(fixture->sorted.begin(), fixture->sorted.end());
+    for (const size_t offset : fixture->offsets) {
+        fixture->positions.push_back(fixture->buffer.positionOf(offset));
+    }
+
+    fixture->edited = fixture->buffer;
+    for (size_t i = 0; i < 64; ++i) {
+        fixture->edited.insert(fixture->offsets[i * (LOOKUPS / 64)], "edited\n");
+    }
+
+    const std::string suffix = "/" + std::string(corpus_name(kind));
+    const size_t      size   = fixture->text.size();
+
+    cases.push_back({ "buffer/load" + suffix, size, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            Buffer buffer(fixture->text);
+            keep(buffer);
+        }
+    } });
+
+    cases.push_back({ "buffer/position_of" + suffix, 0, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            keep(fixture->buffer.positionOf(fixture->offsets[i & (LOOKUPS - 1)]));
+        }
+    } });
+
+    cases.push_back({ "buffer/offset_of" + suffix, 0, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            keep(fixture->buffer.offsetOf(fixture->positions[i & (LOOKUPS - 1)]));
+        }
+    } });
+
+    // One op = resolving all LOOKUPS sorted offsets in one batch.
+    cases.push_back({ "buffer/positions_of_sorted_4096" + suffix, 0, [fixture](size_t n) {
+        std::vector<Position> out(LOOKUPS);
+        for (size_t i = 0; i < n; ++i) {
+            fixture->buffer.positionsOf(fixture->sorted, out);
+            keep(out.back());
+        }
+    } });
+
+    cases.push_back({ "buffer/utf16_position_of" + suffix, 0, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            keep(fixture->buffer.utf16PositionOf(fixture->offsets[i & (LOOKUPS - 1)]));
+        }
+    } });
+
+    // One op = inserting a line break & erasing it again, leaving the text as it was.
+    cases.push_back({ "buffer/edit" + suffix, 0, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const size_t offset = fixture->offsets[i & (LOOKUPS - 1)];
+            fixture->buffer.insert(offset, "edit\n");
+            fixture->buffer.erase(offset, 5);
+        }
+        keep(fixture->buffer);
+    } });
+
+    // One op = walking every row, against splitting the text into a vector of strings.
+    cases.push_back({ "lines/view" + suffix, size, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            size_t bytes = 0;
+            for (const BufferLine line : fixture->buffer.lines()) { bytes += line.text.size(); }
+            keep(bytes);
+        }
+    } });
+
+    cases.push_back({ "lines/split_strings" + suffix, size, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            std::vector<std::string> lines;
+            std::string_view         rest = fixture->buffer.text();
+            for (size_t eol; (eol = rest.find('\n')) != rest.npos; rest.remove_prefix(eol + 1)) {
+                lines.emplace_back(rest.substr(0, eol));
+            }
+            lines.emplace_back(rest);
+            keep(lines.size());
+        }
+    } });
+
+    // Buffer has no search of its own; this is the scan a caller runs over `text()`.
+    cases.push_back({ "search/find_absent" + suffix, size, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            keep(fixture->buffer.text().find("needle-not-in-corpus"));
+        }
+    } });
+
+    // One op = lexing the whole Buffer, Positions included.
+    cases.push_back({ "lex/words" + suffix, size, [fixture](size_t n) {
+        static const Lexicon lexicon = word_lexicon();
+        for (size_t i = 0; i < n; ++i) {
+            size_t tokens = 0;
+            for (const Token &token : Lexer(fixture->buffer, lexicon)) {
+                tokens += token.end.getRow().get();
+            }
+            keep(tokens);
+        }
+    } });
+
+    // One op = typing a byte & deleting it again, bringing a TokenTable up to date after each.
+    cases.push_back({ "lex/update" + suffix, 0, [fixture](size_t n) {
+        static const Lexicon lexicon = word_lexicon();
+        if (!fixture->tokens) {
+            fixture->tokens = std::make_unique<TokenTable>(fixture->buffer, lexicon);
+        }
+
+        TokenTable &table = *fixture->tokens;
+        for (size_t i = 0; i < n; ++i) {
+            const size_t offset = fixture->offsets[i & (LOOKUPS - 1)];
+            fixture->buffer.insert(offset, "x");
+            keep(table.update(fixture->buffer, offset, 0, 1));
+            fixture->buffer.erase(offset, 1);
+            keep(table.update(fixture->buffer, offset, 1, 0));
+        }
+    } });
+
+    // One op = diffing the corpus against a copy with a few scattered edits.
+    cases.push_back({ "diff/scattered_edits" + suffix, 2 * size, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) { keep(diff(fixture->buffer, fixture->edited).size()); }
+    } });
+}
+
+
+
+
+static void add_json_cases(std::vector<Case> &cases, size_t bytes)
+{
+    struct Fixture
+    {
+        Buffer                buffer;
+        std::vector<Position> positions;
+    };
+
+    auto fixture    = std::make_shared<Fixture>();
+    fixture->buffer = Buffer(generate_json(bytes));
+
+    const size_t size = fixture->buffer.size();
+
+    cases.push_back({ "json/index", size, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const JsonIndex index(fixture->buffer);
+            keep(index.size());
+        }
+    } });
+
+    // One op = resolving every tape entry to a Position in one sweep.
+    cases.push_back({ "json/positions", 0, [fixture](size_t n) {
+        const JsonIndex index(fixture->buffer);
+        fixture->positions.resize(index.size());
+        for (size_t i = 0; i < n; ++i) {
+            index.positions(0, fixture->positions);
+            keep(fixture->positions.back());
+        }
+    } });
+}
+
+
+
+static void add_map_cases(std::vector<Case> &cases)
+{
+    static constexpr size_t ENTRIES = size_t(1) << 18;
+
+    struct Fixture
+    {
+        std::unordered_map<Position, uint32_t> reference;
+        PositionMap<uint32_t>                  map;
+        std::vector<Position>                  keys;
+    };
+
+    auto      fixture = std::make_shared<Fixture>();
+    CorpusRng rng{ 5 };
+
+    fixture->map.reserve(ENTRIES);
+    fixture->reference.reserve(ENTRIES);
+    for (uint32_t i = 0; i < ENTRIES; ++i) {
+        const Position pos(1 + rng.below(100000), 1 + rng.below(200));
+        fixture->map.insert(pos, i);
+        fixture->reference.emplace(pos, i);
+        if (i % (ENTRIES / LOOKUPS) == 0) { fixture->keys.push_back(pos); }
+    }
+
+    cases.push_back({ "map/unordered_map_find", 0, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            keep(fixture->reference.find(fixture->keys[i & (LOOKUPS - 1)]));
+        }
+    } });
+
+    cases.push_back({ "map/position_map_find", 0, [fixture](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            keep(fixture->map.find(fixture->keys[i & (LOOKUPS - 1)]));
+        }
+    } });
+}
+
+
+
+
+int main(int argc, char **argv)
+{
+    const Options options = parse_options(argc, argv);
+
+#if !defined(__OPTIMIZE__) && !defined(NDEBUG)
+    std::fputs("warning: text_buffer_bench was built without optimizations.\n", stderr);
+#endif
+
+    std::vector<Case> cases;
+    add_coordinate_cases(cases);
+    add_position_cases(cases);
+    for (const CorpusKind kind : ALL_CORPORA) { add_buffer_cases(cases, kind, options.corpusBytes); }
+    add_json_cases(cases, options.corpusBytes);
+    add_map_cases(cases);
+
+    const std::vector<std::pair<std::string, std::string>> context = {
+        { "library", "text_buffer" },
+        { "build_type", TEXT_BUFFER_BUILD_TYPE },
+#if defined(__clang__) || defined(__GNUC__)
+        { "compiler", __VERSION__ },
+#endif
+        { "exceptions", TEXT_BUFFER_THROWS ? "on" : "off" },
+        { "corpus_bytes", std::to_string(options.corpusBytes) },
+        { "samples", std::to_string(options.samples) },
+    };
+
+    return run_cases(cases, options, context);
+}
@@ -0,0 +1,190 @@
+#pragma once
+#ifndef BENCH_CORPUS_HPP
+#define BENCH_CORPUS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Text_Bench {
+
+/**************************************************************
+ * Synthetic corpora: deterministic text shaped like the inputs
+ * the Buffer sees in practice. The same seed & size give the
+ * same bytes on every platform, so runs stay comparable.
+ *
+ *  - SHORT_LINES: source-code-like ASCII, 0-80 bytes per line.
+ *  - MINIFIED:    one very long line of JavaScript-like tokens.
+ *  - CJK:         lines of mostly 3-byte UTF-8 (CJK ideographs)
+ *                 with some ASCII & 4-byte (astral) characters.
+ *  - CRLF:        SHORT_LINES with `\r\n` terminators.
+ **************************************************************/
+enum class CorpusKind { SHORT_LINES, MINIFIED, CJK, CRLF };
+
+inline constexpr std::array<CorpusKind, 4> ALL_CORPORA = {
+    CorpusKind::SHORT_LINES, CorpusKind::MINIFIED, CorpusKind::CJK, CorpusKind::CRLF
+};
+
+
+
+
+inline constexpr std::string_view corpus_name(CorpusKind kind) noexcept
+{
+    switch (kind) {
+        case CorpusKind::SHORT_LINES: return "short_lines";
+        case CorpusKind::MINIFIED: return "minified";
+        case CorpusKind::CJK: return "cjk";
+        case CorpusKind::CRLF: return "crlf";
+    }
+    return "unknown";
+}
+
+
+
+
+/****************************************************************
+ * @private
+ * SplitMix64; unlike the <random> distributions its output is
+ * specified, so corpora do not depend on the standard library.
+ ****************************************************************/
+struct CorpusRng
+{
+    uint64_t state;
+
+    uint64_t next() noexcept
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    size_t below(size_t bound) noexcept { return size_t(next() % bound); }
+};
+
+
+
+
+/****************************************************************
+ * @private
+ * Append one UTF-8 encoded code point.
+ ****************************************************************/
+inline void append_utf8(std::string &out, char32_t cp)
+{
+    if (cp < 0x80) { out += char(cp); }
+    else if (cp < 0x800) {
+        out += char(0xC0 | (cp >> 6));
+        out += char(0x80 | (cp & 0x3F));
+    }
+    else if (cp < 0x10000) {
+        out += char(0xE0 | (cp >> 12));
+        out += char(0x80 | ((cp >> 6) & 0x3F));
+        out += char(0x80 | (cp & 0x3F));
+    }
+    else {
+        out += char(0xF0 | (cp >> 18));
+        out += char(0x80 | ((cp >> 12) & 0x3F));
+        out += char(0x80 | ((cp >> 6) & 0x3F));
+        out += char(0x80 | (cp & 0x3F));
+    }
+}
+
+
+
+
+/****************************************************************
+ * @returns <std::string> About `bytes` bytes of the given kind.
+ *   Lines are never split, so the result may run a line over.
+ ****************************************************************/
+inline std::string generate_corpus(CorpusKind kind, size_t bytes, uint64_t seed = 1)
+{
+    static constexpr std::string_view WORDS[] = {
+        "auto", "const", "return", "if", "else", "for", "while", "value", "index", "buffer",
+        "row", "col", "size_t", "std::string", "=", "==", "+", "(", ")", "{", "}", ";", "->",
+        "0", "1", "42", "\"text\"", "// note", "position", "offset",
+    };
+
+    CorpusRng   rng{ seed };
+    std::string out;
+    out.reserve(bytes + 128);
+
+    const auto codeLine = [&](std::string_view eol) {
+        const size_t indent = rng.below(4) * 4;
+        const size_t target = indent + rng.below(77);
+
+        out.append(indent, ' ');
+        for (size_t start = out.size(); out.size() - start < target;) {
+            out += WORDS[rng.below(std::size(WORDS))];
+            out += ' ';
+        }
+        out += eol;
+    };
+
+    while (out.size() < bytes) {
+        switch (kind) {
+            case CorpusKind::SHORT_LINES: codeLine("\n"); break;
+            case CorpusKind::CRLF: codeLine("\r\n"); break;
+
+            case CorpusKind::MINIFIED:
+                out += WORDS[rng.below(std::size(WORDS))];
+                out += "();,.:"[rng.below(6)];
+                break;
+
+            case CorpusKind::CJK: {
+                const size_t chars = 10 + rng.below(60);
+                for (size_t i = 0; i < chars; ++i) {
+                    const size_t roll = rng.below(100);
+                    if (roll < 80) { append_utf8(out, char32_t(0x4E00 + rng.below(0x5200))); }
+                    else if (roll < 95) { out += char('a' + rng.below(26)); }
+                    else { append_utf8(out, char32_t(0x1F600 + rng.below(0x50))); }
+                }
+                out += '\n';
+                break;
+            }
+        }
+    }
+
+    return out;
+}
+
+
+
+
+/****************************************************************
+ * @returns <std::string> A pretty-printed JSON array of records
+ *   (strings with escapes, numbers, literals, nested arrays) of
+ *   about `bytes` bytes.
+ ****************************************************************/
+inline std::string generate_json(size_t bytes, uint64_t seed = 1)
+{
+    static constexpr std::string_view NAMES[] = {
+        "\"row\"", "\"path \\\"quoted\\\"\"", "\"caf\xC3\xA9\"", "\"tab\\there\"", "\"\\u00e9t\\u00e9\"",
+    };
+
+    CorpusRng   rng{ seed };
+    std::string out = "[\n";
+    out.reserve(bytes + 256);
+
+    for (size_t id = 0; out.size() < bytes; ++id) {
+        if (id > 0) { out += ",\n"; }
+        out += "  {\"id\": " + std::to_string(id);
+        out += ", \"name\": ";
+        out += NAMES[rng.below(std::size(NAMES))];
+        out += ", \"score\": -" + std::to_string(rng.below(1000));
+        out += "." + std::to_string(rng.below(100));
+        out += ", \"active\": ";
+        out += rng.below(2) ? "true" : "false";
+        out += ", \"tags\": [";
+        for (size_t i = 0, n = rng.below(4); i < n; ++i) { out += i ? ", null" : "null"; }
+        out += "]}";
+    }
+    out += "\n]\n";
+
+    return out;
+}
+
+}  // namespace Text_Bench
+
+#endif
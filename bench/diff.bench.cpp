@@ -0,0 +1,160 @@
+#include <text/buffer.hpp>
+#include <text/diff.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Text;
+
+
+/**************************************************************
+ * text_buffer_diff: `Text::diff` as a command, to time against
+ * GNU diff on the same files:
+ *
+ *     time text_buffer_diff OLD NEW > ours.txt
+ *     time diff OLD NEW > theirs.txt
+ *
+ * Prints the hunks in diff's normal format & exits 1 if the files
+ * differ, as diff does; the hunks may differ from diff's where
+ * several scripts are equally short. The time spent loading the
+ * files & diffing them goes to stderr.
+ **************************************************************/
+struct Options
+{
+    std::string oldPath;
+    std::string newPath;
+    size_t      threads = 0;
+    bool        quiet   = false;  /// Count the hunks, print none
+};
+
+
+
+
+static std::string read_file(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "cannot read %s\n", path.c_str());
+        std::exit(2);
+    }
+
+    std::string text(size_t(in.seekg(0, std::ios::end).tellg()), '\0');
+    in.seekg(0).read(text.data(), std::streamsize(text.size()));
+    return text;
+}
+
+
+
+
+static void print_lines(std::FILE *out, const Buffer &buffer, size_t row, size_t count, char mark)
+{
+    // Lines are printed with their carriage returns, as diff prints them.
+    for (size_t i = row; i < row + count; ++i) {
+        const size_t start = buffer.offsetOf(Position(i, 1));
+        const size_t end = i < buffer.lineCount() ? buffer.offsetOf(Position(i + 1, 1))
+                                                  : buffer.size();
+
+        std::string_view line = buffer.text().substr(start, end - start);
+
+        const bool broken = line.ends_with('\n');
+        if (broken) { line.remove_suffix(1); }
+
+        std::fprintf(out, "%c %.*s\n", mark, int(line.size()), line.data());
+        if (!broken) { std::fputs("\\ No newline at end of file\n", out); }
+    }
+}
+
+
+
+
+static void print_range(std::FILE *out, size_t first, size_t count)
+{
+    // An empty range is named by the line before it.
+    if (count <= 1) { std::fprintf(out, "%zu", count ? first : first - 1); }
+    else { std::fprintf(out, "%zu,%zu", first, first + count - 1); }
+}
+
+
+
+
+static void print_hunk(std::FILE *out, const Buffer &from, const Buffer &to, const DiffHunk &hunk)
+{
+    const size_t oldRow = hunk.oldStart.getRow().get();
+    const size_t newRow = hunk.newStart.getRow().get();
+
+    print_range(out, oldRow, hunk.oldLines);
+    std::fputc(hunk.oldLines == 0 ? 'a' : hunk.newLines == 0 ? 'd' : 'c', out);
+    print_range(out, newRow, hunk.newLines);
+    std::fputc('\n', out);
+
+    print_lines(out, from, oldRow, hunk.oldLines, '<');
+    if (hunk.oldLines && hunk.newLines) { std::fputs("---\n", out); }
+    print_lines(out, to, newRow, hunk.newLines, '>');
+}
+
+
+
+
+static Options parse_options(int argc, char **argv)
+{
+    Options                  options;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg.starts_with("--threads=")) { options.threads = std::stoul(argv[i] + 10); }
+        else if (arg == "--quiet") { options.quiet = true; }
+        else if (!arg.starts_with("--")) { paths.emplace_back(arg); }
+        else { paths.clear(), paths.resize(3); }
+    }
+
+    if (paths.size() != 2) {
+        std::fprintf(stderr, "usage: %s [--threads=N] [--quiet] OLD NEW\n", argv[0]);
+        std::exit(2);
+    }
+    options.oldPath = paths[0];
+    options.newPath = paths[1];
+    return options;
+}
+
+
+
+
+int main(int argc, char **argv)
+{
+    using clock = std::chrono::steady_clock;
+
+    const Options options = parse_options(argc, argv);
+    const auto    start   = clock::now();
+
+    const Buffer from(read_file(options.oldPath));
+    const Buffer to(read_file(options.newPath));
+    const auto   loaded = clock::now();
+
+    const std::vector<DiffHunk> hunks = diff(from, to, options.threads);
+    const auto                  diffed = clock::now();
+
+    if (!options.quiet) {
+        for (const DiffHunk &hunk : hunks) { print_hunk(stdout, from, to, hunk); }
+    }
+
+    size_t edits = 0;
+    for (const DiffHunk &hunk : hunks) { edits += hunk.oldLines + hunk.newLines; }
+
+    std::fprintf(
+      stderr,
+      "%zu + %zu bytes: loaded in %.3f s, diffed in %.3f s; %zu hunks, %zu lines changed\n",
+      from.size(),
+      to.size(),
+      std::chrono::duration<double>(loaded - start).count(),
+      std::chrono::duration<double>(diffed - loaded).count(),
+      hunks.size(),
+      edits);
+
+    return hunks.empty() ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include <text/coordinate.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <format>
+#include <string>
+#include <utils/err.hpp>
+#include <utils/exception.hpp>
+
+using namespace Text;
+using namespace Text_Buffer;
+
+
+/**************************************************************
+ * Cost of constructing, throwing & catching the library's error
+ * types, the way a validation pass that rejects many inputs does.
+ *
+ * Each error is raised two ways, so one run gives the before &
+ * after of building reports lazily:
+ *   - eager: the message is formatted with std::format & the
+ *     report built when the error is raised, as the library used
+ *     to do;
+ *   - lazy: the raw arguments are stored & nothing is formatted,
+ *     as the library does now. The report is never printed, so
+ *     `what()` is not called.
+ **************************************************************/
+template <typename Fn>
+static double measure(size_t iterations, Fn &&fn)
+{
+    using clock = std::chrono::steady_clock;
+
+    size_t     caught = 0;
+    const auto start  = clock::now();
+
+    for (size_t i = 0; i < iterations; ++i) { caught += fn(i); }
+
+    const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start);
+    if (caught != iterations) { std::fprintf(stderr, "only %zu errors caught\n", caught); }
+
+    return elapsed.count() / double(iterations);
+}
+
+
+template <typename Eager, typename Lazy>
+static void compare(const char *name, size_t iterations, Eager &&eager, Lazy &&lazy)
+{
+    const double before = measure(iterations, eager);
+    const double after  = measure(iterations, lazy);
+
+    std::printf("%-30s %10.1f %10.1f %8.1fx\n", name, before, after, before / after);
+}
+
+
+
+
+int main(int argc, char **argv)
+{
+    const size_t iterations = argc > 1 ? std::stoul(argv[1]) : 200000;
+
+    std::printf("%-30s %10s %10s %9s\n", "ns/op", "eager", "lazy", "speedup");
+
+    compare(
+      "Coordinate subtraction (X_)",
+      iterations,
+      [](size_t i) {
+          try {
+              X_ error(
+                ERR_ID::INVALID_NUMBER_SIGN,
+                std::format("ILLEGAL OPERATION:  '{} {} {}'", i % 7, "-", 10));
+              error.what();
+              throw error;
+          }
+          catch (const X_ &) {
+              return size_t(1);
+          }
+      },
+      [](size_t i) {
+          try {
+              const auto result = Coordinate(i % 7) - Coordinate(10);
+              return size_t(result.get() == 0);
+          }
+          catch (const X_ &) {
+              return size_t(1);
+          }
+      });
+
+    compare(
+      "Coordinate(int) sign (X_)",
+      iterations,
+      [](size_t i) {
+          try {
+              X_ error(
+                ERR_ID::INVALID_NUMBER_SIGN,
+                std::format("Coordinate cannot be constructed from {}.", -int(i % 7) - 1));
+              error.what();
+              throw error;
+          }
+          catch (const X_ &) {
+              return size_t(1);
+          }
+      },
+      [](size_t i) {
+          try {
+              const Coordinate coord(-int(i % 7) - 1);
+              return size_t(coord.get() == 0);
+          }
+          catch (const X_ &) {
+              return size_t(1);
+          }
+      });
+
+    compare(
+      "out_of_range (Exception)",
+      iterations,
+      [](size_t i) {
+          try {
+              Exception error = generate_out_of_range_exception(
+                std::format("Offset {} is past the end of the Buffer.", i));
+              error.what();
+              throw error;
+          }
+          catch (const Exception &) {
+              return size_t(1);
+          }
+      },
+      [](size_t i) {
+          try {
+              throw generate_out_of_range_exception("Offset {} is past the end of the Buffer.", i);
+          }
+          catch (const Exception &) {
+              return size_t(1);
+          }
+      });
+
+    compare(
+      "negative_number (Exception)",
+      iterations,
+      [](size_t i) {
+          try {
+              Exception error = generate_negative_number_exception(
+                std::format("Row {} cannot be shifted by {}.", i, -int(i % 7) - 1));
+              error.what();
+              throw error;
+          }
+          catch (const Exception &) {
+              return size_t(1);
+          }
+      },
+      [](size_t i) {
+          try {
+              throw generate_negative_number_exception(
+                "Row {} cannot be shifted by {}.", i, -int(i % 7) - 1);
+          }
+          catch (const Exception &) {
+              return size_t(1);
+          }
+      });
+
+    return 0;
+}
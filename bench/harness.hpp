@@ -0,0 +1,263 @@
+#pragma once
+#ifndef BENCH_HARNESS_HPP
+#define BENCH_HARNESS_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Text_Bench {
+
+/**************************************************************
+ * A small, self-contained benchmark harness (no third-party
+ * library, no network fetch).
+ *
+ * Each case is a function running its operation `n` times. The
+ * harness doubles `n` until one run lasts `minTime / samples`,
+ * then times `samples` runs of that length & reports the median
+ * & fastest per-operation time. Results print as a table & can
+ * be written as JSON to track regressions between builds.
+ **************************************************************/
+struct Options
+{
+    std::string filter;             /// Run cases whose name contains this
+    std::string jsonPath;           /// Write JSON results here ("-" = stdout)
+    double      minTimeMs   = 200;  /// Time budget of each case
+    size_t      samples     = 5;
+    size_t      corpusBytes = size_t(1) << 20;
+    bool        list        = false;
+};
+
+
+struct Result
+{
+    std::string name;
+    size_t      iterations = 0;  /// Per sample
+    double      nsPerOp    = 0;  /// Median of the samples
+    double      minNsPerOp = 0;
+    size_t      bytesPerOp = 0;  /// 0 unless the case measures throughput
+};
+
+
+struct Case
+{
+    std::string                 name;
+    size_t                      bytesPerOp = 0;
+    std::function<void(size_t)> body;
+};
+
+
+
+
+/****************************************************************
+ * Keep the compiler from discarding a value, or the computation
+ * producing it, as unused.
+ ****************************************************************/
+template <typename T>
+inline void keep(const T &value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const void *volatile sink;
+    sink = &value;
+#endif
+}
+
+
+
+
+/****************************************************************
+ * @returns <Options> Options parsed from the command line:
+ *   --filter=SUBSTR  --json=PATH  --min-time=MS  --samples=N
+ *   --corpus-bytes=N  --list  --help
+ ****************************************************************/
+inline Options parse_options(int argc, char **argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const auto value = [&](std::string_view flag) -> const char * {
+            return arg.starts_with(flag) ? argv[i] + flag.size() : nullptr;
+        };
+
+        if (const char *v = value("--filter=")) { options.filter = v; }
+        else if (const char *v = value("--json=")) { options.jsonPath = v; }
+        else if (const char *v = value("--min-time=")) { options.minTimeMs = std::stod(v); }
+        else if (const char *v = value("--samples=")) { options.samples = std::stoul(v); }
+        else if (const char *v = value("--corpus-bytes=")) { options.corpusBytes = std::stoul(v); }
+        else if (arg == "--list") { options.list = true; }
+        else {
+            const bool help = arg == "--help";
+            std::fprintf(
+              help ? stdout : stderr,
+              "usage: %s [--filter=SUBSTR] [--json=PATH|-] [--min-time=MS] [--samples=N]"
+              " [--corpus-bytes=N] [--list]\n",
+              argv[0]);
+            std::exit(help ? 0 : 2);
+        }
+    }
+
+    options.samples = std::max<size_t>(options.samples, 1);
+    return options;
+}
+
+
+
+
+/****************************************************************
+ * Time one case as described above.
+ ****************************************************************/
+inline Result measure(const Case &bench, const Options &options)
+{
+    using clock = std::chrono::steady_clock;
+
+    const auto timeRun = [&](size_t n) {
+        const auto start = clock::now();
+        bench.body(n);
+        return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    };
+
+    const double target = options.minTimeMs * 1e6 / double(options.samples);
+    size_t       n      = 1;
+
+    for (double elapsed = timeRun(n); elapsed < target && n < (size_t(1) << 40);) {
+        // Grow geometrically, but jump close to the target once a run is measurable.
+        const double guess = elapsed > 1e5 ? target / elapsed * 1.2 : 10.0;
+        n                  = size_t(double(n) * std::clamp(guess, 2.0, 10.0));
+        elapsed            = timeRun(n);
+    }
+
+    std::vector<double> perOp;
+    for (size_t s = 0; s < options.samples; ++s) { perOp.push_back(timeRun(n) / double(n)); }
+    std::sort(perOp.begin(), perOp.end());
+
+    return Result{ bench.name, n, perOp[perOp.size() / 2], perOp.front(), bench.bytesPerOp };
+}
+
+
+
+
+/****************************************************************
+ * Print results as an aligned table, one row per case.
+ ****************************************************************/
+inline void print_header(std::FILE *out)
+{
+    std::fprintf(out, "%-44s %12s %12s %10s %12s\n", "case", "ns/op", "min ns/op", "MB/s", "iters");
+}
+
+
+inline void print_row(std::FILE *out, const Result &r)
+{
+    char throughput[32] = "-";
+    if (r.bytesPerOp) {
+        std::snprintf(throughput, sizeof throughput, "%.1f", double(r.bytesPerOp) / r.nsPerOp * 1e3);
+    }
+
+    std::fprintf(
+      out, "%-44s %12.1f %12.1f %10s %12zu\n", r.name.c_str(), r.nsPerOp, r.minNsPerOp,
+      throughput, r.iterations);
+}
+
+
+
+
+/****************************************************************
+ * Write results as JSON:
+ *   { "context": {...}, "benchmarks": [ { "name", "iterations",
+ *     "ns_per_op", "min_ns_per_op", "bytes_per_second" }, ... ] }
+ * `bytes_per_second` is null for cases without a byte count.
+ ****************************************************************/
+inline void write_json(
+  std::FILE                                              *out,
+  const std::vector<Result>                              &results,
+  const std::vector<std::pair<std::string, std::string>> &context)
+{
+    const auto quoted = [](std::string_view text) {
+        std::string str = "\"";
+        for (const char c : text) {
+            if (c == '"' || c == '\\') { str += '\\'; }
+            if (static_cast<unsigned char>(c) >= 0x20) { str += c; }
+        }
+        return str + '"';
+    };
+
+    std::fputs("{\n  \"context\": {", out);
+    for (size_t i = 0; i < context.size(); ++i) {
+        std::fprintf(
+          out, "%s\n    %s: %s", i ? "," : "", quoted(context[i].first).c_str(),
+          quoted(context[i].second).c_str());
+    }
+
+    std::fputs("\n  },\n  \"benchmarks\": [", out);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        std::fprintf(
+          out,
+          "%s\n    { \"name\": %s, \"iterations\": %zu, \"ns_per_op\": %.3f, "
+          "\"min_ns_per_op\": %.3f, \"bytes_per_second\": ",
+          i ? "," : "", quoted(r.name).c_str(), r.iterations, r.nsPerOp, r.minNsPerOp);
+
+        if (r.bytesPerOp) { std::fprintf(out, "%.0f }", double(r.bytesPerOp) / r.nsPerOp * 1e9); }
+        else { std::fputs("null }", out); }
+    }
+    std::fputs("\n  ]\n}\n", out);
+}
+
+
+
+
+/****************************************************************
+ * Run every case matching the filter; print & optionally save
+ * the results.
+ * @returns <int> The process exit code.
+ ****************************************************************/
+inline int run_cases(
+  const std::vector<Case>                                &cases,
+  const Options                                          &options,
+  const std::vector<std::pair<std::string, std::string>> &context)
+{
+    std::vector<Result> results;
+    const bool          table = !options.list && options.jsonPath != "-";
+
+    if (table) { print_header(stdout); }
+
+    for (const Case &bench : cases) {
+        if (!options.filter.empty() && bench.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        if (options.list) {
+            std::printf("%s\n", bench.name.c_str());
+            continue;
+        }
+
+        results.push_back(measure(bench, options));
+        if (table) { print_row(stdout, results.back()); }
+    }
+
+    if (options.list || options.jsonPath.empty()) { return 0; }
+
+    std::FILE *out = options.jsonPath == "-" ? stdout : std::fopen(options.jsonPath.c_str(), "w");
+    if (out == nullptr) {
+        std::fprintf(stderr, "cannot write %s: %s\n", options.jsonPath.c_str(), std::strerror(errno));
+        return 1;
+    }
+
+    write_json(out, results, context);
+    if (out != stdout) { std::fclose(out); }
+    return 0;
+}
+
+}  // namespace Text_Bench
+
+#endif
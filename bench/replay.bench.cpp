@@ -0,0 +1,491 @@
+#include "corpus.hpp"
+
+#include <text/buffer.hpp>
+#include <text/position.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Text;
+using namespace Text_Bench;
+
+
+/**************************************************************
+ * text_buffer_replay: Differential replayer for storage engines.
+ *
+ * Applies one edit stream, recorded or randomly generated, to
+ * every storage engine & to a reference `std::string`, checking
+ * after each step that the engine's text & its offset <-> Position
+ * mappings match the reference. Each engine is then timed on the
+ * same stream without checks, so one run yields both correctness
+ * & throughput.
+ *
+ * A storage engine is any type satisfying `StorageEngine`; adding
+ * one (piece table, rope, gap buffer) is one line in `main()`.
+ *
+ * Streams are text files, one edit per line:
+ *     <offset> <length> <replacement>
+ * with `\n`, `\r`, `\t`, `\\` & `\xHH` escapes in the replacement.
+ **************************************************************/
+struct Edit
+{
+    size_t      offset = 0;
+    size_t      length = 0;
+    std::string text;
+};
+
+
+template <typename E>
+concept StorageEngine = std::constructible_from<E, const std::string &>
+                     && requires(E &engine, const E &view, size_t n, const Position &pos) {
+                            engine.replace(n, n, std::string_view());
+                            { view.text() } -> std::convertible_to<std::string_view>;
+                            { view.positionOf(n) } -> std::same_as<Position>;
+                            { view.offsetOf(pos) } -> std::same_as<size_t>;
+                        };
+
+
+
+
+/****************************************************************
+ * The reference: a plain string whose Positions are found by
+ * scanning from the start, too simple to be wrong.
+ ****************************************************************/
+class ReferenceText
+{
+    std::string internal;
+
+  public:
+    explicit ReferenceText(const std::string &text)
+    : internal(text)
+    {}
+
+    void replace(size_t offset, size_t length, std::string_view text)
+    { internal.replace(offset, length, text); }
+
+    std::string_view text() const noexcept { return internal; }
+
+    Position positionOf(size_t offset) const
+    {
+        const auto   head = std::string_view(internal).substr(0, offset);
+        const size_t rows = size_t(std::count(head.begin(), head.end(), '\n'));
+        const size_t nl   = head.rfind('\n');
+
+        return Position(rows + 1, nl == head.npos ? offset + 1 : offset - nl);
+    }
+
+    size_t offsetOf(const Position &pos) const
+    {
+        size_t start = 0;
+        for (size_t row = 1; row < pos.getRow().get(); ++row) {
+            start = internal.find('\n', start) + 1;
+        }
+        return start + pos.getCol().get() - 1;
+    }
+};
+
+static_assert(StorageEngine<Buffer>);
+static_assert(StorageEngine<ReferenceText>);
+
+
+
+
+struct Options
+{
+    std::string corpus      = "short_lines";
+    size_t      corpusBytes = size_t(64) << 10;
+    std::string initialPath;
+    std::string streamPath;
+    std::string recordPath;
+    size_t      edits      = 20000;
+    uint64_t    seed       = 1;
+    size_t      checkEvery = 1;
+    size_t      rounds     = 3;
+};
+
+
+
+
+/****************************************************************
+ * Edit stream files.
+ ****************************************************************/
+static std::string escape(std::string_view text)
+{
+    std::string out;
+    for (const char c : text) {
+        switch (c) {
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\\': out += "\\\\"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char hex[5];
+                    std::snprintf(hex, sizeof hex, "\\x%02X", unsigned(c & 0xFF));
+                    out += hex;
+                }
+                else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+
+static int hex_digit(char c)
+{
+    if ('0' <= c && c <= '9') { return c - '0'; }
+    if ('a' <= c && c <= 'f') { return c - 'a' + 10; }
+    if ('A' <= c && c <= 'F') { return c - 'A' + 10; }
+    return -1;
+}
+
+
+// False if a `\x` escape is not followed by two hex digits.
+static bool unescape(std::string_view text, std::string &out)
+{
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '\\' || i + 1 == text.size()) {
+            out += text[i];
+            continue;
+        }
+
+        switch (text[++i]) {
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'x': {
+                const int high = i + 1 < text.size() ? hex_digit(text[i + 1]) : -1;
+                const int low  = i + 2 < text.size() ? hex_digit(text[i + 2]) : -1;
+                if (high < 0 || low < 0) { return false; }
+
+                out += char(high * 16 + low);
+                i += 2;
+                break;
+            }
+            default: out += text[i];
+        }
+    }
+    return true;
+}
+
+
+static std::vector<Edit> read_stream(const std::string &path)
+{
+    std::ifstream     in(path);
+    std::vector<Edit> edits;
+
+    if (!in) {
+        std::fprintf(stderr, "cannot read %s\n", path.c_str());
+        std::exit(2);
+    }
+
+    for (std::string line; std::getline(in, line);) {
+        if (line.empty() || line[0] == '#') { continue; }
+
+        const size_t first  = line.find(' ');
+        const size_t second = line.find(' ', first + 1);
+
+        const size_t digits = line.find_first_not_of("0123456789 ");
+        if (first == line.npos || digits < std::min(second, line.size())) {
+            std::fprintf(stderr, "%s: malformed edit: %s\n", path.c_str(), line.c_str());
+            std::exit(2);
+        }
+
+        Edit edit;
+        edit.offset = std::stoul(line.substr(0, first));
+        edit.length = std::stoul(line.substr(first + 1, second - first - 1));
+        if (second != line.npos && !unescape(std::string_view(line).substr(second + 1), edit.text)) {
+            std::fprintf(stderr, "%s: malformed edit: %s\n", path.c_str(), line.c_str());
+            std::exit(2);
+        }
+        edits.push_back(std::move(edit));
+    }
+
+    return edits;
+}
+
+
+static void write_stream(const std::string &path, const std::vector<Edit> &edits)
+{
+    std::ofstream out(path);
+    out << "# <offset> <length> <replacement>\n";
+    for (const Edit &edit : edits) {
+        out << edit.offset << ' ' << edit.length << ' ' << escape(edit.text) << '\n';
+    }
+}
+
+
+
+
+/****************************************************************
+ * @returns <bool> false, after reporting it, if an edit of the
+ *   stream does not fit the text left by the edits before it.
+ ****************************************************************/
+static bool validate_stream(size_t size, const std::vector<Edit> &edits)
+{
+    for (size_t step = 0; step < edits.size(); ++step) {
+        const Edit &edit = edits[step];
+
+        if (edit.offset > size || edit.length > size - edit.offset) {
+            std::fprintf(
+              stderr, "edit #%zu replaces [%zu, %zu) of a %zu byte text\n", step, edit.offset,
+              edit.offset + edit.length, size);
+            return false;
+        }
+
+        size = size - edit.length + edit.text.size();
+    }
+
+    return true;
+}
+
+
+
+
+/****************************************************************
+ * @returns <std::vector<Edit>> A random stream shaped like editor
+ *   use: mostly typing & backspacing at a cursor, with pastes,
+ *   range deletions & cursor jumps.
+ ****************************************************************/
+static std::vector<Edit> random_stream(size_t initialSize, size_t count, uint64_t seed)
+{
+    static constexpr std::string_view TYPED    = "etaoin shrdlu\n{}();";
+    static constexpr std::string_view SNIPPETS
+      = "if (x) {\n    return y;\n}\n// \xE6\x96\x87\xE5\xAD\x97\r\n";
+
+    CorpusRng         rng{ seed };
+    std::vector<Edit> edits;
+    size_t            size   = initialSize;
+    size_t            cursor = rng.below(size + 1);
+
+    while (edits.size() < count) {
+        const size_t roll = rng.below(100);
+        Edit         edit;
+
+        if (roll < 55) {
+            edit = { cursor, 0, std::string(1, TYPED[rng.below(TYPED.size())]) };
+        }
+        else if (roll < 70) {
+            if (cursor == 0) { continue; }
+            edit = { cursor - 1, 1, "" };
+        }
+        else if (roll < 80) {
+            const size_t from = rng.below(SNIPPETS.size());
+            const size_t take = 1 + rng.below(SNIPPETS.size() - from);
+            edit              = { cursor, 0, std::string(SNIPPETS.substr(from, take)) };
+        }
+        else if (roll < 90) {
+            edit = { cursor, std::min(size - cursor, rng.below(100)), "" };
+        }
+        else {
+            cursor = rng.below(size + 1);
+            continue;
+        }
+
+        size   = size - edit.length + edit.text.size();
+        cursor = edit.offset + edit.text.size();
+        edits.push_back(std::move(edit));
+    }
+
+    return edits;
+}
+
+
+
+
+/****************************************************************
+ * Apply `edits` to an engine & the reference in lock step.
+ * @returns <bool> false, after reporting it, at the first step
+ *   where the engine disagrees with the reference.
+ ****************************************************************/
+template <StorageEngine Engine>
+static bool check_engine(
+  const char              *name,
+  const std::string       &initial,
+  const std::vector<Edit> &edits,
+  const Options           &options)
+{
+    Engine        engine(initial);
+    ReferenceText reference(initial);
+    CorpusRng     rng{ options.seed ^ 0xC0FFEE };
+
+    const auto fail = [&](size_t step, const std::string &what) {
+        std::fprintf(stderr, "%s: diverged at edit #%zu: %s\n", name, step, what.c_str());
+        if (step < edits.size()) {
+            std::fprintf(
+              stderr, "  edit: %zu %zu %s\n", edits[step].offset, edits[step].length,
+              escape(edits[step].text).c_str());
+        }
+        return false;
+    };
+
+    for (size_t step = 0; step < edits.size(); ++step) {
+        const Edit &edit = edits[step];
+
+        engine.replace(edit.offset, edit.length, edit.text);
+        reference.replace(edit.offset, edit.length, edit.text);
+
+        if ((step + 1) % options.checkEvery != 0 && step + 1 != edits.size()) { continue; }
+
+        const std::string_view actual = engine.text();
+        if (actual != reference.text()) {
+            const auto diff = std::mismatch(
+              actual.begin(), actual.end(), reference.text().begin(), reference.text().end());
+            return fail(step, std::format("text differs at byte {}", diff.first - actual.begin()));
+        }
+
+        const size_t probes[] = {
+            edit.offset, edit.offset + edit.text.size(), actual.size(), rng.below(actual.size() + 1)
+        };
+
+        for (const size_t offset : probes) {
+            const Position expected = reference.positionOf(offset);
+            const Position position = engine.positionOf(offset);
+
+            if (!(position == expected)) {
+                return fail(step, std::format(
+                  "positionOf({}) is ({}, {}), expected ({}, {})", offset, position.getRow().get(),
+                  position.getCol().get(), expected.getRow().get(), expected.getCol().get()));
+            }
+            const size_t expectedOffset = reference.offsetOf(expected);
+            if (engine.offsetOf(expected) != expectedOffset) {
+                return fail(step, std::format(
+                  "offsetOf({}, {}) is {}, expected {}", expected.getRow().get(),
+                  expected.getCol().get(), engine.offsetOf(expected), expectedOffset));
+            }
+        }
+    }
+
+    return true;
+}
+
+
+
+
+/****************************************************************
+ * @returns <double> The engine's best throughput over the rounds,
+ *   in edits per second, applying the stream without checks.
+ ****************************************************************/
+template <StorageEngine Engine>
+static double time_engine(const std::string &initial, const std::vector<Edit> &edits, size_t rounds)
+{
+    using clock = std::chrono::steady_clock;
+
+    double best = 0;
+    for (size_t round = 0; round < std::max<size_t>(rounds, 1); ++round) {
+        Engine     engine(initial);
+        const auto start = clock::now();
+
+        for (const Edit &edit : edits) { engine.replace(edit.offset, edit.length, edit.text); }
+
+        // A stream shorter than the clock's tick is timed as one tick, not as 0 seconds.
+        const auto   elapsed = std::max(clock::now() - start, clock::duration(1));
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        best                 = std::max(best, double(edits.size()) / seconds);
+    }
+
+    return best;
+}
+
+
+
+
+static Options parse_options(int argc, char **argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const auto value = [&](std::string_view flag) -> const char * {
+            return arg.starts_with(flag) ? argv[i] + flag.size() : nullptr;
+        };
+
+        if (const char *v = value("--corpus=")) { options.corpus = v; }
+        else if (const char *v = value("--corpus-bytes=")) { options.corpusBytes = std::stoul(v); }
+        else if (const char *v = value("--initial=")) { options.initialPath = v; }
+        else if (const char *v = value("--stream=")) { options.streamPath = v; }
+        else if (const char *v = value("--record=")) { options.recordPath = v; }
+        else if (const char *v = value("--edits=")) { options.edits = std::stoul(v); }
+        else if (const char *v = value("--seed=")) { options.seed = std::stoull(v); }
+        else if (const char *v = value("--check-every=")) { options.checkEvery = std::stoul(v); }
+        else if (const char *v = value("--rounds=")) { options.rounds = std::stoul(v); }
+        else {
+            const bool help = arg == "--help";
+            std::fprintf(
+              help ? stdout : stderr,
+              "usage: %s [--corpus=short_lines|minified|cjk|crlf] [--corpus-bytes=N]\n"
+              "          [--initial=PATH] [--stream=PATH | --edits=N --seed=S] [--record=PATH]\n"
+              "          [--check-every=K] [--rounds=N]\n",
+              argv[0]);
+            std::exit(help ? 0 : 2);
+        }
+    }
+
+    options.checkEvery = std::max<size_t>(options.checkEvery, 1);
+    return options;
+}
+
+
+
+
+int main(int argc, char **argv)
+{
+    const Options options = parse_options(argc, argv);
+
+    std::string initial;
+    if (!options.initialPath.empty()) {
+        std::ifstream in(options.initialPath, std::ios::binary);
+        initial.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    else {
+        const auto kind = std::find_if(ALL_CORPORA.begin(), ALL_CORPORA.end(), [&](CorpusKind k) {
+            return corpus_name(k) == options.corpus;
+        });
+        if (kind == ALL_CORPORA.end()) {
+            std::fprintf(stderr, "unknown corpus %s\n", options.corpus.c_str());
+            return 2;
+        }
+        initial = generate_corpus(*kind, options.corpusBytes, options.seed);
+    }
+
+    const std::vector<Edit> edits = options.streamPath.empty()
+                                    ? random_stream(initial.size(), options.edits, options.seed)
+                                    : read_stream(options.streamPath);
+
+    if (!options.recordPath.empty()) { write_stream(options.recordPath, edits); }
+    if (!validate_stream(initial.size(), edits)) { return 2; }
+
+    std::printf(
+      "%zu edits on %zu bytes, checked every %zu\n",
+      edits.size(),
+      initial.size(),
+      options.checkEvery);
+    std::printf("%-12s %10s %14s\n", "engine", "result", "edits/s");
+
+    bool ok = true;
+
+    const auto run = [&]<StorageEngine Engine>(const char *name) {
+        // A diverged engine may not survive the stream, so it is not timed.
+        const bool   same = check_engine<Engine>(name, initial, edits, options);
+        const double rate = same ? time_engine<Engine>(initial, edits, options.rounds) : 0;
+
+        std::printf("%-12s %10s %14.0f\n", name, same ? "ok" : "DIVERGED", rate);
+        ok = ok && same;
+    };
+
+    run.operator()<ReferenceText>("reference");
+    run.operator()<Buffer>("buffer");
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#pragma once
+#ifndef BRACKET_INDEX_HPP
+#define BRACKET_INDEX_HPP
+
+#include <text/lexer.hpp>
+#include <text/token-table.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+
+namespace Text {
+
+class Buffer;
+
+
+/**************************************************************
+ * BracketPair: The token kinds, as produced by the classifying
+ * Lexicon, of a pair of brackets, e.g. `(` & `)`.
+ **************************************************************/
+struct BracketPair
+{
+    TokenKind open  = 0;
+    TokenKind close = 0;
+};
+
+
+
+
+/**************************************************************
+ * BracketIndex Class: The brackets of a Buffer's text as a
+ * balanced-parenthesis sequence, kept current across edits.
+ *
+ * Which bytes are brackets is decided by a classifying Lexicon:
+ * tokens of the kinds named by the BracketPairs are brackets, so
+ * the Lexicon's string & comment rules keep the brackets inside
+ * them out. The tokens are held in a TokenTable, which re-lexes
+ * only the rows an edit can change; the brackets of those rows
+ * are replaced & every bracket after them is shifted lazily.
+ *
+ * Brackets live in a treap ordered by offset. Each node counts
+ * +1 for an opening & -1 for a closing bracket & keeps the sum &
+ * the smallest prefix sum of its subtree, so the partner of a
+ * bracket, the pair enclosing an offset & the nesting depth at
+ * an offset are found by a single descent in O(log n).
+ *
+ * Depth counts the brackets of every pair together; a bracket
+ * whose partner by depth is of another pair is unmatched.
+ **************************************************************/
+class BracketIndex
+{
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node
+    {
+        size_t   offset   = 0;
+        int64_t  add      = 0;  /// Pending shift for the children
+        int64_t  sum      = 0;  /// Depth change over the subtree
+        int64_t  low      = 0;  /// Smallest depth after any bracket of the subtree
+        uint32_t priority = 0;
+        uint32_t left     = NIL;
+        uint32_t right    = NIL;
+        uint16_t pair     = 0;
+        int8_t   step     = 0;  /// +1 for an opening, -1 for a closing bracket
+    };
+
+    std::optional<TokenTable> tokens;
+    std::vector<BracketPair>  pairs;
+    std::vector<Node>         nodes;
+    std::vector<uint32_t>     freeNodes;
+    uint32_t                  root  = NIL;
+    uint32_t                  seed  = 0x27D4EB2Fu;
+    size_t                    count = 0;
+
+  public:
+    BracketIndex() = default;
+
+    void track(const Buffer &buffer, const Lexicon &rules, std::span<const BracketPair> kinds);
+    void clear() noexcept;
+
+    bool   tracking() const noexcept { return tokens.has_value(); }
+    size_t size() const noexcept { return count; }
+    size_t memoryUsage() const noexcept;
+    void   shrinkToFit();
+    void   update(const Buffer &buffer, size_t offset, size_t removed, size_t inserted);
+
+    std::optional<size_t>                    match(size_t offset) const;
+    std::optional<std::pair<size_t, size_t>> enclosing(size_t offset) const;
+    int64_t                                  depth(size_t offset) const noexcept;
+
+  private:
+    struct Found
+    {
+        uint32_t node   = NIL;
+        size_t   offset = 0;
+        int64_t  before = 0;  /// Depth before the bracket
+    };
+
+    uint32_t nextPriority() noexcept;
+    uint32_t make(size_t offset, uint16_t pair, int8_t step);
+    void     release(uint32_t n);
+    void     apply(uint32_t n, int64_t add) noexcept;
+    void     push(uint32_t n) noexcept;
+    void     pull(uint32_t n) noexcept;
+    void     split(uint32_t n, size_t key, uint32_t &lo, uint32_t &hi);
+    uint32_t merge(uint32_t lo, uint32_t hi);
+    uint32_t collect(const Buffer &buffer, size_t first, size_t rows);
+
+    int64_t sumOf(uint32_t n) const noexcept;
+    Found   find(size_t offset) const noexcept;
+    Found   atOrAfter(size_t offset) const noexcept;
+    Found   firstAfter(size_t offset, int64_t depth) const noexcept;
+    Found   firstAfter(uint32_t n, int64_t shift, int64_t base, size_t offset, int64_t depth)
+      const noexcept;
+    Found   firstIn(uint32_t n, int64_t shift, int64_t base, int64_t depth) const noexcept;
+    Found   lastBefore(size_t offset, int64_t depth) const noexcept;
+    Found lastBefore(uint32_t n, int64_t shift, int64_t base, size_t offset, int64_t depth)
+      const noexcept;
+    Found   lastIn(uint32_t n, int64_t shift, int64_t base, int64_t depth) const noexcept;
+    bool    paired(const Found &open, const Found &close) const noexcept;
+};
+
+}  // namespace Text
+
+#endif
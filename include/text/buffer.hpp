@@ -3,31 +3,225 @@
 #ifndef TEXT_BUFFER_HPP
 #define TEXT_BUFFER_HPP
 
+#include <text/bracket-index.hpp>
+#include <text/decoration.hpp>
+#include <text/line-view.hpp>
+#include <text/marker.hpp>
+#include <text/packed-position.hpp>
+#include <text/position.hpp>
+#include <text/stats.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
-// #include
+#include <utility>
+#include <vector>
 
 
 namespace Text {
 
-class Buffer
+/**************************************************************
+ * Utf16Position: A zero-based line & UTF-16 code-unit column
+ * pair, the coordinate system used by the Language Server
+ * Protocol. Unlike `Text::Position`, which is one-based and
+ * measures columns in bytes, both members count from zero.
+ **************************************************************/
+struct Utf16Position
 {
-  std::string      internal;
-  std::string_view view;
+    size_t line      = 0;
+    size_t character = 0;
+};
 
- public:
-  Buffer()              = default;
-  Buffer(const Buffer&) = default;
-  Buffer(const std::string& text);
+
+struct Utf16Range
+{
+    Utf16Position start;
+    Utf16Position end;
 };
 
-}
 
+/**************************************************************
+ * Utf16Change: One entry of an LSP `contentChanges` array. A
+ * change without a range replaces the entire Buffer.
+ **************************************************************/
+struct Utf16Change
+{
+    std::optional<Utf16Range> range;
+    std::string               text;
+};
+
+
+
+
+/**************************************************************
+ * MemoryUsage: The heap bytes held by a Buffer, per structure.
+ * Capacities are counted, not sizes, as that is what the
+ * allocator has handed out.
+ **************************************************************/
+struct MemoryUsage
+{
+    size_t text        = 0;  /// The text itself
+    size_t lineIndex   = 0;  /// Start offset of every row
+    size_t utf16Caches = 0;  /// UTF-16 column checkpoints (droppable)
+    size_t markers     = 0;
+    size_t decorations = 0;
+    size_t brackets    = 0;  /// Bracket index & its tokens, while tracked
+
+    size_t total() const noexcept
+    {
+        return text + lineIndex + utf16Caches + markers + decorations + brackets;
+    }
+};
+
+
+
+
+/**************************************************************
+ * Buffer Class: The text, its line index & the structures that
+ * follow it through edits. Const members may be called from
+ * several threads at once, including those that build caches;
+ * edits need the Buffer to themselves.
+ **************************************************************/
+class Buffer
+{
+    /// @private Per-line cache used to translate UTF-16 columns. Built by
+    /// const queries, so `built` is published with release & read with
+    /// acquire; copies are only made by edits, which have the Buffer alone.
+    struct Utf16Line
+    {
+        std::atomic<bool> built = false;
+        bool              ascii = false;
+
+        /// Pairs of (byte column, UTF-16 column), one per stride.
+        std::vector<std::pair<uint32_t, uint32_t>> checkpoints;
 
+        Utf16Line() = default;
+        Utf16Line(const Utf16Line &other)
+        : built(other.built.load(std::memory_order_relaxed))
+        , ascii(other.ascii)
+        , checkpoints(other.checkpoints)
+        {}
 
+        Utf16Line(Utf16Line &&other) noexcept
+        : built(other.built.load(std::memory_order_relaxed))
+        , ascii(other.ascii)
+        , checkpoints(std::move(other.checkpoints))
+        {}
+
+        Utf16Line &operator=(Utf16Line other) noexcept
+        {
+            built.store(other.built.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            ascii = other.ascii;
+            checkpoints.swap(other.checkpoints);
+            return *this;
+        }
+    };
+
+    /// @private Serializes the building of UTF-16 rows. A copied Buffer
+    /// gets a lock of its own.
+    struct BuildLock
+    {
+        std::mutex mutex;
+
+        BuildLock() = default;
+        BuildLock(const BuildLock &) noexcept {}
+        BuildLock &operator=(const BuildLock &) noexcept { return *this; }
+    };
+
+    std::string            internal;
+    std::vector<size_t>    lineStarts{ 0 };  /// Offset of each row's 1st byte
+    mutable std::vector<Utf16Line> utf16Lines;
+    MarkerTree                     markers;
+    DecorationTree                 decorations;
+    BracketIndex                   brackets;
+    StatCounters                   counters;
+    mutable BuildLock              utf16Build;
+
+  public:
+    static constexpr size_t UTF16_STRIDE = 64;  /// Bytes between checkpoints
+
+    Buffer();
+    Buffer(const Buffer &) = default;
+    Buffer(const std::string &text);
+
+    // CONTENT ACCESS
+    std::string_view text() const noexcept;
+    std::string_view line(size_t row) const;
+    size_t           size() const noexcept;
+    size_t           lineCount() const noexcept;
+    LineView         lines() const noexcept;
+    LineView         lines(size_t first, size_t last) const;
+
+    // OFFSET <-> POSITION
+    size_t   offsetOf(const Position &pos) const;
+    Position positionOf(size_t offset) const;
+    void     positionsOf(std::span<const size_t> offsets, std::span<Position> out) const;
+    void     positionsOf(std::span<const size_t> offsets, std::span<PackedPosition> out) const;
+    void     offsetsOf(std::span<const Position> positions, std::span<size_t> out) const;
+
+    // UTF-16 (LSP) COLUMNS
+    size_t        offsetOf(const Utf16Position &pos) const;
+    Position      positionOf(const Utf16Position &pos) const;
+    Utf16Position utf16PositionOf(const Position &pos) const;
+    Utf16Position utf16PositionOf(size_t offset) const;
+
+    // MARKERS
+    MarkerId addMarker(size_t offset, Gravity gravity = Gravity::LEFT);
+    MarkerId addMarker(const Position &pos, Gravity gravity = Gravity::LEFT);
+    void     removeMarker(MarkerId id);
+    size_t   markerOffset(MarkerId id) const;
+    Position markerPosition(MarkerId id) const;
+    size_t   markerCount() const noexcept;
+
+    // DECORATIONS
+    DecorationId addDecoration(const Position &start, const Position &end, uint32_t kind = 0);
+    void         removeDecoration(DecorationId id);
+    uint32_t     decorationKind(DecorationId id) const;
+    size_t       decorationCount() const noexcept;
+
+    std::pair<Position, Position> decorationRange(DecorationId id) const;
+
+    void decorationsInRows(size_t first, size_t last, std::vector<DecorationId> &out) const;
+
+    // BRACKETS
+    void    trackBrackets(const Lexicon &classifier, std::span<const BracketPair> pairs);
+    void    untrackBrackets() noexcept;
+    size_t  bracketCount() const noexcept;
+    int64_t bracketDepth(const Position &pos) const;
+
+    std::optional<Position>                      matchingBracket(const Position &pos) const;
+    std::optional<std::pair<Position, Position>> enclosingBrackets(const Position &pos) const;
+
+    // EDITING
+    void replace(size_t offset, size_t length, std::string_view text);
+    void insert(size_t offset, std::string_view text);
+    void erase(size_t offset, size_t length);
+    void applyChanges(std::span<const Utf16Change> changes);
+
+    // INSTRUMENTATION & MEMORY
+    Stats       stats() const noexcept;
+    MemoryUsage memoryUsage() const noexcept;
+    size_t      shrinkToFit();
+    size_t      dropCaches() noexcept;
+
+  private:
+    void   reindex();
+    size_t rowAfter(size_t row0, size_t offset) const noexcept;
+    size_t lineEnd(size_t row0) const noexcept;
+    size_t utf16ToByte(size_t row0, size_t units) const;
+    size_t byteToUtf16(size_t row0, size_t bytes) const;
+
+    const Utf16Line &utf16Line(size_t row0) const;
+};
 
+}  // namespace Text
 
 
 
 
-#endif
\ No newline at end of file
+#endif
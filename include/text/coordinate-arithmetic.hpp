@@ -0,0 +1,550 @@
+#pragma once
+#ifndef COORDINATE_ARITHMETIC_HPP
+#define COORDINATE_ARITHMETIC_HPP
+
+#include <text/coordinate.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <utility>
+
+namespace Text {
+
+/**************************************************************
+ * Non-throwing Coordinate Arithmetic: Explicit alternatives to
+ * the Coordinate operators for hot code that must not throw.
+ *
+ *  - checked_*:    Return `std::expected<Coordinate, ERR_ID>`. The
+ *                  error is INVALID_NUMBER_SIGN for a negative
+ *                  result, SEG_FAULT_INT_MAX for a result larger
+ *                  than `MAX` & DIVISION_BY_ZERO.
+ *  - saturating_*: Clamp the result to [0, MAX]. Division by zero
+ *                  saturates to `MAX`.
+ *  - wrapping_*:   Reduce the result modulo 2^N, N being the width
+ *                  of the Coordinate, like unsigned integers do.
+ *                  Division by zero yields 0.
+ *
+ * The right-hand side may be a Coordinate of the same type or any
+ * integer, including negative ones. Every operation yields the
+ * wrapped result & an overflow flag in one step, so the three
+ * families only differ in how they select their result. GCC &
+ * Clang compute both with their overflow builtins; other compilers
+ * (MSVC), or builds defining `TEXT_BUFFER_PORTABLE_OVERFLOW`, use
+ * plain unsigned arithmetic with the same results.
+ **************************************************************/
+#if !defined(TEXT_BUFFER_PORTABLE_OVERFLOW) && (defined(__GNUC__) || defined(__clang__))
+#    define TEXT_BUFFER_OVERFLOW_BUILTINS 1
+#else
+#    define TEXT_BUFFER_OVERFLOW_BUILTINS 0
+#endif
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+using CoordinateResult = std::expected<BasicCoordinate<I, P>, ERR_ID>;
+
+
+
+
+/**************************************************************
+ * @private
+ * How an arithmetic operation left the range of a Coordinate.
+ **************************************************************/
+enum class CoordinateOverflow : uint8_t
+{
+    NONE,
+    NEGATIVE,
+    TOO_LARGE,
+    DIVISION_BY_ZERO
+};
+
+
+
+
+
+
+#if !TEXT_BUFFER_OVERFLOW_BUILTINS
+
+/****************************************************************
+ * @private
+ * @returns <uintmax_t> The magnitude of `value`.
+ ****************************************************************/
+template <Integral T>
+inline constexpr uintmax_t coordinate_magnitude(T value) noexcept
+{ return std::cmp_less(value, 0) ? uintmax_t(0) - uintmax_t(value) : uintmax_t(value); }
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Compute `lhs + n` into `out`, wrapped on overflow.
+ ****************************************************************/
+template <std::unsigned_integral I>
+inline constexpr CoordinateOverflow coordinate_raise(I lhs, uintmax_t n, I &out) noexcept
+{
+    const uintmax_t sum = uintmax_t(lhs) + n;
+    out                 = I(sum);
+
+    return sum < n || sum > std::numeric_limits<I>::max() ? CoordinateOverflow::TOO_LARGE
+                                                          : CoordinateOverflow::NONE;
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Compute `lhs - n` into `out`, wrapped on overflow.
+ ****************************************************************/
+template <std::unsigned_integral I>
+inline constexpr CoordinateOverflow coordinate_lower(I lhs, uintmax_t n, I &out) noexcept
+{
+    out = I(uintmax_t(lhs) - n);
+    return n > lhs ? CoordinateOverflow::NEGATIVE : CoordinateOverflow::NONE;
+}
+
+#endif
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Compute `lhs + rhs` into `out`, wrapped on overflow.
+ ****************************************************************/
+template <std::unsigned_integral I, Integral T>
+inline constexpr CoordinateOverflow coordinate_add(I lhs, T rhs, I &out) noexcept
+{
+#if TEXT_BUFFER_OVERFLOW_BUILTINS
+    if (!__builtin_add_overflow(lhs, rhs, &out)) { return CoordinateOverflow::NONE; }
+    return std::cmp_less(rhs, 0) ? CoordinateOverflow::NEGATIVE : CoordinateOverflow::TOO_LARGE;
+#else
+    const uintmax_t magnitude = coordinate_magnitude(rhs);
+    return std::cmp_less(rhs, 0) ? coordinate_lower(lhs, magnitude, out)
+                                 : coordinate_raise(lhs, magnitude, out);
+#endif
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Compute `lhs - rhs` into `out`, wrapped on overflow.
+ ****************************************************************/
+template <std::unsigned_integral I, Integral T>
+inline constexpr CoordinateOverflow coordinate_sub(I lhs, T rhs, I &out) noexcept
+{
+#if TEXT_BUFFER_OVERFLOW_BUILTINS
+    if (!__builtin_sub_overflow(lhs, rhs, &out)) { return CoordinateOverflow::NONE; }
+    return std::cmp_greater(rhs, 0) ? CoordinateOverflow::NEGATIVE
+                                    : CoordinateOverflow::TOO_LARGE;
+#else
+    const uintmax_t magnitude = coordinate_magnitude(rhs);
+    return std::cmp_less(rhs, 0) ? coordinate_raise(lhs, magnitude, out)
+                                 : coordinate_lower(lhs, magnitude, out);
+#endif
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Compute `lhs * rhs` into `out`, wrapped on overflow.
+ ****************************************************************/
+template <std::unsigned_integral I, Integral T>
+inline constexpr CoordinateOverflow coordinate_mul(I lhs, T rhs, I &out) noexcept
+{
+#if TEXT_BUFFER_OVERFLOW_BUILTINS
+    if (!__builtin_mul_overflow(lhs, rhs, &out)) { return CoordinateOverflow::NONE; }
+    return std::cmp_less(rhs, 0) ? CoordinateOverflow::NEGATIVE : CoordinateOverflow::TOO_LARGE;
+#else
+    const uintmax_t magnitude = coordinate_magnitude(rhs);
+    const uintmax_t product   = uintmax_t(lhs) * magnitude;
+    out = I(std::cmp_less(rhs, 0) ? uintmax_t(0) - product : product);
+
+    if (lhs == 0 || magnitude == 0) { return CoordinateOverflow::NONE; }
+    if (std::cmp_less(rhs, 0)) { return CoordinateOverflow::NEGATIVE; }
+    return magnitude > std::numeric_limits<I>::max() / lhs ? CoordinateOverflow::TOO_LARGE
+                                                           : CoordinateOverflow::NONE;
+#endif
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Compute `lhs / rhs` (truncated towards zero) into `out`. Only a
+ * negative divisor can overflow, by giving a negative quotient;
+ * `out` is then the wrapped quotient. Division by zero sets 0.
+ ****************************************************************/
+template <std::unsigned_integral I, Integral T>
+inline constexpr CoordinateOverflow coordinate_div(I lhs, T rhs, I &out) noexcept
+{
+    out = 0;
+
+    if (rhs == 0) { return CoordinateOverflow::DIVISION_BY_ZERO; }
+
+    if (std::cmp_greater(rhs, 0)) {
+        if (std::cmp_less_equal(rhs, BasicCoordinate<I>::MAX)) { out = lhs / I(rhs); }
+        return CoordinateOverflow::NONE;
+    }
+
+    const auto magnitude = uintmax_t(0) - uintmax_t(rhs);
+    const auto quotient  = uintmax_t(lhs) / magnitude;
+
+    out = I(uintmax_t(0) - quotient);
+    return quotient == 0 ? CoordinateOverflow::NONE : CoordinateOverflow::NEGATIVE;
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Turn the outcome of an operation into a CoordinateResult.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr CoordinateResult<I, P> coordinate_checked(CoordinateOverflow overflow, I out)
+  noexcept
+{
+    switch (overflow) {
+        case CoordinateOverflow::NONE     : return BasicCoordinate<I, P>::narrow(out);
+        case CoordinateOverflow::NEGATIVE :
+            return std::unexpected(ERR_ID::INVALID_NUMBER_SIGN);
+        case CoordinateOverflow::TOO_LARGE : return std::unexpected(ERR_ID::SEG_FAULT_INT_MAX);
+        case CoordinateOverflow::DIVISION_BY_ZERO :
+            return std::unexpected(ERR_ID::DIVISION_BY_ZERO);
+    }
+
+    return std::unexpected(ERR_ID::UNKNOWN);
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Clamp the outcome of an operation to [0, MAX].
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> coordinate_saturated(CoordinateOverflow overflow, I out)
+  noexcept
+{
+    const I clamped = overflow == CoordinateOverflow::NONE     ? out
+                    : overflow == CoordinateOverflow::NEGATIVE ? I(0)
+                                                               : BasicCoordinate<I, P>::MAX;
+
+    return BasicCoordinate<I, P>::narrow(clamped);
+}
+
+
+
+
+/////////////////////////////////////////////////////////////////
+// CHECKED ARITHMETIC
+/////////////////////////////////////////////////////////////////
+
+/****************************************************************
+ * @returns <CoordinateResult> `lhs + rhs`, or the reason it is not
+ *   a valid Coordinate.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr CoordinateResult<I, P> checked_add(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I          out      = 0;
+    const auto overflow = coordinate_add(lhs.get(), rhs, out);
+    return coordinate_checked<I, P>(overflow, out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr CoordinateResult<I, P> checked_add(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return checked_add(lhs, rhs.get()); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <CoordinateResult> `lhs - rhs`, or the reason it is not
+ *   a valid Coordinate.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr CoordinateResult<I, P> checked_sub(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I          out      = 0;
+    const auto overflow = coordinate_sub(lhs.get(), rhs, out);
+    return coordinate_checked<I, P>(overflow, out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr CoordinateResult<I, P> checked_sub(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return checked_sub(lhs, rhs.get()); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <CoordinateResult> `lhs * rhs`, or the reason it is not
+ *   a valid Coordinate.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr CoordinateResult<I, P> checked_mul(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I          out      = 0;
+    const auto overflow = coordinate_mul(lhs.get(), rhs, out);
+    return coordinate_checked<I, P>(overflow, out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr CoordinateResult<I, P> checked_mul(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return checked_mul(lhs, rhs.get()); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <CoordinateResult> `lhs / rhs`, or the reason it is not
+ *   a valid Coordinate.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr CoordinateResult<I, P> checked_div(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I          out      = 0;
+    const auto overflow = coordinate_div(lhs.get(), rhs, out);
+    return coordinate_checked<I, P>(overflow, out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr CoordinateResult<I, P> checked_div(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return checked_div(lhs, rhs.get()); }
+
+
+
+
+/////////////////////////////////////////////////////////////////
+// SATURATING ARITHMETIC
+/////////////////////////////////////////////////////////////////
+
+/****************************************************************
+ * @returns <BasicCoordinate> `lhs + rhs` clamped to [0, MAX].
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> saturating_add(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I          out      = 0;
+    const auto overflow = coordinate_add(lhs.get(), rhs, out);
+    return coordinate_saturated<I, P>(overflow, out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> saturating_add(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return saturating_add(lhs, rhs.get()); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <BasicCoordinate> `lhs - rhs` clamped to [0, MAX].
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> saturating_sub(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I          out      = 0;
+    const auto overflow = coordinate_sub(lhs.get(), rhs, out);
+    return coordinate_saturated<I, P>(overflow, out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> saturating_sub(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return saturating_sub(lhs, rhs.get()); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <BasicCoordinate> `lhs * rhs` clamped to [0, MAX].
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> saturating_mul(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I          out      = 0;
+    const auto overflow = coordinate_mul(lhs.get(), rhs, out);
+    return coordinate_saturated<I, P>(overflow, out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> saturating_mul(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return saturating_mul(lhs, rhs.get()); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <BasicCoordinate> `lhs / rhs` clamped to [0, MAX]; `MAX`
+ *   when `rhs` is zero.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> saturating_div(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I          out      = 0;
+    const auto overflow = coordinate_div(lhs.get(), rhs, out);
+    return coordinate_saturated<I, P>(overflow, out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> saturating_div(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return saturating_div(lhs, rhs.get()); }
+
+
+
+
+/////////////////////////////////////////////////////////////////
+// WRAPPING ARITHMETIC
+/////////////////////////////////////////////////////////////////
+
+/****************************************************************
+ * @returns <BasicCoordinate> `lhs + rhs` modulo 2^N.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> wrapping_add(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I out = 0;
+    coordinate_add(lhs.get(), rhs, out);
+    return BasicCoordinate<I, P>::narrow(out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> wrapping_add(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return wrapping_add(lhs, rhs.get()); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <BasicCoordinate> `lhs - rhs` modulo 2^N.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> wrapping_sub(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I out = 0;
+    coordinate_sub(lhs.get(), rhs, out);
+    return BasicCoordinate<I, P>::narrow(out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> wrapping_sub(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return wrapping_sub(lhs, rhs.get()); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <BasicCoordinate> `lhs * rhs` modulo 2^N.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> wrapping_mul(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I out = 0;
+    coordinate_mul(lhs.get(), rhs, out);
+    return BasicCoordinate<I, P>::narrow(out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> wrapping_mul(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return wrapping_mul(lhs, rhs.get()); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <BasicCoordinate> `lhs / rhs` modulo 2^N (a negative
+ *   quotient wraps); 0 when `rhs` is zero.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> wrapping_div(BasicCoordinate<I, P> lhs, T rhs) noexcept
+{
+    I out = 0;
+    coordinate_div(lhs.get(), rhs, out);
+    return BasicCoordinate<I, P>::narrow(out);
+}
+
+
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> wrapping_div(
+  BasicCoordinate<I, P> lhs,
+  BasicCoordinate<I, P> rhs) noexcept
+{ return wrapping_div(lhs, rhs.get()); }
+
+}  // namespace Text
+
+#endif
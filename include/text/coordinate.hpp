@@ -76,8 +76,16 @@
 #define COORDINATE_HPP
 
 #include "utils/err.hpp"
+#include "utils/hash.hpp"
+#include "utils/raise.hpp"
 
+#include <cassert>
+#include <concepts>
 #include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 using namespace Text_Buffer;
 
@@ -90,130 +98,211 @@ template <typename T>
 concept Integral = std::integral<T>;
 
 
+
+
+/**************************************************************
+ * Coordinate Check Policies: Decide what a Coordinate does when
+ * an operation would leave it with a negative or undefined value.
+ *
+ *  - Checked:   Throws. The default, used by `Text::Coordinate`.
+ *  - Asserted:  Uses `assert()`, so the check compiles away when
+ *               `NDEBUG` is defined.
+ *  - Unchecked: Performs no check at all. Only for values that are
+ *               known to be valid, such as the Buffer's line index.
+ **************************************************************/
+struct Checked
+{
+    static constexpr bool THROWS  = true;
+    static constexpr bool ASSERTS = false;
+};
+
+
+struct Asserted
+{
+    static constexpr bool THROWS  = false;
+    static constexpr bool ASSERTS = true;
+};
+
+
+struct Unchecked
+{
+    static constexpr bool THROWS  = false;
+    static constexpr bool ASSERTS = false;
+};
+
+
+template <typename P>
+concept CheckPolicy = requires {
+    { P::THROWS } -> std::convertible_to<bool>;
+    { P::ASSERTS } -> std::convertible_to<bool>;
+};
+
+
+
+
 /**************************************************************
  * Coordinate Class: Defines a numeric-like object that acts
  * as a 1-dimensional location value for character within text.
  * in text. Typically used in a pair for 2-dimensional position
  * tracking in a text file, or some other body of text. Used in
  * such a way is referred to as a Row-Column pair.
+ *
+ * `BasicCoordinate` is fully constexpr & trivially copyable. Its
+ * `Policy` decides how invalid operations are reported; see the
+ * Check Policies above. Coordinates of different policies convert
+ * into one another implicitly & without a check.
+ *
+ * `Int` is the Coordinate's `size_type`, `size_t` by default. A
+ * 32-bit `Int` halves the memory of large position indexes; range
+ * checks then run wherever a wider value is narrowed into it, & are
+ * compiled out wherever no narrowing is possible.
  **************************************************************/
-class Coordinate
+template <std::unsigned_integral Int = size_t, CheckPolicy Policy = Checked>
+class BasicCoordinate
 {
   private:
-    size_t internal = 0;
+    Int internal = 0;
 
   public:
+    using size_type = Int;
+    using policy    = Policy;
+
+    static constexpr Int MAX = std::numeric_limits<Int>::max();
+
     template <Integral T>
-    Coordinate(T num);
-    Coordinate(int &&num);
-    inline Coordinate() noexcept = default;               /// Default Constructor
-    inline Coordinate(Coordinate &) noexcept = default;   /// Copy Constructor
-    inline Coordinate(Coordinate &&) noexcept = default;  /// Move Constructor
+    constexpr BasicCoordinate(T num);
+    constexpr BasicCoordinate(int &&num);
+    constexpr BasicCoordinate() noexcept                         = default;  /// Default Ctor
+    constexpr BasicCoordinate(const BasicCoordinate &) noexcept = default;  /// Copy Ctor
+    constexpr BasicCoordinate(BasicCoordinate &&) noexcept      = default;  /// Move Ctor
+
+    template <std::unsigned_integral I, CheckPolicy P>
+        requires (!std::same_as<BasicCoordinate<I, P>, BasicCoordinate>)
+    constexpr explicit(sizeof(I) > sizeof(Int))
+      BasicCoordinate(const BasicCoordinate<I, P> &other);
 
     // INTERNAL READ ACCESS
-    size_t get() const noexcept;
-    size_t operator () ();
+    constexpr Int get() const noexcept;
+    constexpr Int operator () () const noexcept;
 
     // INTERNAL WRITE ACCESS
     template <Integral T>
-    void set(const T &num);
-    void set(const Coordinate &other);
+    constexpr void set(const T &num);
+    constexpr void set(const BasicCoordinate &other) noexcept;
 
     template <Integral T>
-    Coordinate operator = (const T &number);
-    Coordinate operator = (int &&number);
-    Coordinate operator = (const Coordinate &number);
+    constexpr BasicCoordinate operator = (const T &number);
+    constexpr BasicCoordinate operator = (int &&number);
+
+    constexpr BasicCoordinate &operator = (const BasicCoordinate &) noexcept = default;
+    constexpr BasicCoordinate &operator = (BasicCoordinate &&) noexcept      = default;
+
+    template <std::unsigned_integral I, CheckPolicy P>
+        requires (!std::same_as<BasicCoordinate<I, P>, BasicCoordinate>)
+              && (sizeof(I) <= sizeof(Int))
+    constexpr BasicCoordinate &operator = (const BasicCoordinate<I, P> &other) noexcept;
 
     template <Integral T>
     constexpr T convert() const noexcept; /// Type Casting
 
     template <Integral T>
-    operator T() noexcept;
-
-    Coordinate &operator ++ () noexcept;  /// INCREMENT OPERATOR
-    Coordinate &operator -- () noexcept;  /// Decrement Operator
-
-
+    constexpr operator T() noexcept;
 
+    constexpr BasicCoordinate &operator ++ () noexcept;  /// INCREMENT OPERATOR
+    constexpr BasicCoordinate &operator -- () noexcept;  /// Decrement Operator
 
     // [C|C] COMPARISON OPERATORS (==, !=, <, >, <=, >=)
-    friend bool           operator == (const Coordinate &, const Coordinate &) noexcept;
-    friend constexpr auto operator <=> (const Coordinate &, const Coordinate &) noexcept;
+    friend constexpr bool operator == (const BasicCoordinate &, const BasicCoordinate &) noexcept
+      = default;
+    friend constexpr auto operator <=> (const BasicCoordinate &, const BasicCoordinate &) noexcept
+      = default;
 
-    // [C|I] COMPARISON OPERATORS (==, !=, <, >, <=, >=)
-    template <Integral T>
-    friend bool operator == (const Coordinate &coord, const T &number);
+    template <typename Raise>
+    static constexpr void require(bool valid, Raise &&raise);
 
     template <Integral T>
-    friend bool operator != (const Coordinate &coord, const T &number);
+    static constexpr void requireFits(T num);
 
     template <Integral T>
-    friend bool operator > (const Coordinate &coord, const T &number);
+    static constexpr BasicCoordinate narrow(T num);
 
-    template <Integral T>
-    friend bool operator >= (const Coordinate &coord, const T &number);
+};  // CLOSE: 'Coordinate Class'
 
-    template <Integral T>
-    friend bool operator < (const Coordinate &coord, const T &number);
 
-    template <Integral T>
-    friend bool operator <= (const Coordinate &coord, const T &number);
+using Coordinate          = BasicCoordinate<size_t, Checked>;
+using AssertedCoordinate  = BasicCoordinate<size_t, Asserted>;
+using UncheckedCoordinate = BasicCoordinate<size_t, Unchecked>;
 
-    // [I|C] COMPARISON OPERATORS ('==', '!=', '<', '>', '<=', '>=')
-    template <Integral T>
-    friend bool operator == (const T &number, const Coordinate &coord);
+using Coordinate32          = BasicCoordinate<uint32_t, Checked>;
+using UncheckedCoordinate32 = BasicCoordinate<uint32_t, Unchecked>;
 
-    template <Integral T>
-    friend bool operator != (const T &number, const Coordinate &coord);
 
-    template <Integral T>
-    friend bool operator > (const T &number, const Coordinate &coord);
 
-    template <Integral T>
-    friend bool operator >= (const T &number, const Coordinate &coord);
 
-    template <Integral T>
-    friend bool operator < (const T &number, const Coordinate &coord);
 
-    template <Integral T>
-    friend bool operator <= (const T &number, const Coordinate &coord);
 
+/****************************************************************
+ * @private
+ * Apply the Coordinate's check Policy to a condition.
+ * @param valid Result of the check; `false` reports an error.
+ * @param raise Callable that throws the Checked policy's exception.
+ *   It is only instantiated for policies that throw.
+ ****************************************************************/
+template <std::unsigned_integral Int, CheckPolicy Policy>
+template <typename Raise>
+inline constexpr void BasicCoordinate<Int, Policy>::require(bool valid, Raise &&raise)
+{
+    if constexpr (Policy::THROWS) {
+        if (!valid) { raise(); }
+    }
+    else if constexpr (Policy::ASSERTS) {
+        assert(valid && "Invalid Coordinate operation");
+    }
+}
 
 
 
-    // [C|C] ARITHMETIC OPERATORS ('+', '-', '*', '/')
-    friend Coordinate operator + (const Coordinate &lhs, const Coordinate &rhs) noexcept;
-    friend Coordinate operator * (const Coordinate &lhs, const Coordinate &rhs) noexcept;
-    friend Coordinate operator - (const Coordinate &lhs, const Coordinate &rhs);
-    friend Coordinate operator / (const Coordinate &lhs, const Coordinate &rhs);
 
-    // [C|I] ARITHMETIC OPERATORS ('+', '-', '*', '/')
-    template <Integral T>
-    friend Coordinate operator + (const Coordinate &coord, T number);
 
-    template <Integral T>
-    friend Coordinate operator * (const Coordinate &coord, T number);
 
-    template <Integral T>
-    friend Coordinate operator - (const Coordinate &coord, T number);
+/****************************************************************
+ * @private
+ * Apply the check Policy to the narrowing of `num` into `Int`. The
+ * check only exists when `T` can hold values larger than `MAX`.
+ * @throws <Exception> OUT_OF_RANGE if `num` is larger than `MAX`.
+ ****************************************************************/
+template <std::unsigned_integral Int, CheckPolicy Policy>
+template <Integral T>
+inline constexpr void BasicCoordinate<Int, Policy>::requireFits(T num)
+{
+    if constexpr (std::cmp_greater(std::numeric_limits<T>::max(), MAX)) {
+        require(!std::cmp_greater(num, MAX), [num] {
+            raise_error(generate_out_of_range_exception(
+              "The value {} is too large for a {}-bit Coordinate.", num, sizeof(Int) * 8));
+        });
+    }
+}
 
-    template <Integral T>
-    friend Coordinate operator / (const Coordinate &coord, T number);
 
-    // [I|C] ARITHMETIC OPERATORS ('+', '-', '*', '/')
-    template <Integral T>
-    friend Coordinate operator + (T number, const Coordinate &coord);
 
-    template <Integral T>
-    friend Coordinate operator * (T number, const Coordinate &coord);
 
-    template <Integral T>
-    friend Coordinate operator - (T number, const Coordinate &coord);
 
-    template <Integral T>
-    friend Coordinate operator / (T number, const Coordinate &coord);
 
-};  // CLOSE: 'Coordinate Class'
+/****************************************************************
+ * @private
+ * Build the result of an arithmetic operator, whose sign has
+ * already been checked, checking only that it fits in `Int`.
+ ****************************************************************/
+template <std::unsigned_integral Int, CheckPolicy Policy>
+template <Integral T>
+inline constexpr BasicCoordinate<Int, Policy> BasicCoordinate<Int, Policy>::narrow(T num)
+{
+    requireFits(num);
+
+    BasicCoordinate result;
+    result.internal = static_cast<Int>(num);
+    return result;
+}
 
 
 
@@ -227,16 +316,17 @@ class Coordinate
  * @throws <ERR> When passed a negative value.
  * @see `Integral Concept`.
  ****************************************************************/
+template <std::unsigned_integral Int, CheckPolicy Policy>
 template <Integral T>
-inline Coordinate::Coordinate(T num)
-: internal(num)
+inline constexpr BasicCoordinate<Int, Policy>::BasicCoordinate(T num)
+: internal(static_cast<Int>(num))
 {
+    require(!std::cmp_less(num, 0), [num] {
+        raise_error(generate_negative_number_exception(
+          "Attempted to construct a Coordinate using the negative value {}.", num));
+    });
 
-    if (0 > num) {
-        throw generate_negative_number_exception(
-          std::format(
-            "Attempted to construct a Coordinate using the negative value {}.", num));
-    }
+    requireFits(num);
 }
 
 
@@ -249,14 +339,16 @@ inline Coordinate::Coordinate(T num)
  * @param num <int &&num> rval `int`.
  * @throws when passed a negative value.
  ****************************************************************/
-inline Coordinate::Coordinate(int &&num)
-: internal(num)
+template <std::unsigned_integral Int, CheckPolicy Policy>
+inline constexpr BasicCoordinate<Int, Policy>::BasicCoordinate(int &&num)
+: internal(static_cast<Int>(num))
 {
-    if (0 > num) {
-        throw X_(
+    require(0 <= num, [num] {
+        raise_error(X_(
           ERR_ID::INVALID_NUMBER_SIGN,
-          std::format("Attempted to assign the negative value {} to Coordinate", num));
-    }
+          "Attempted to assign the negative value {} to Coordinate",
+          num));
+    });
 }
 
 
@@ -264,11 +356,32 @@ inline Coordinate::Coordinate(int &&num)
 
 
 
+/****************************************************************
+ * Construct a Coordinate from a Coordinate of another policy or
+ * width. The source is already non-negative, so only a narrowing
+ * conversion (which must be explicit) performs a range check.
+ * @throws <Exception> OUT_OF_RANGE if the value does not fit.
+ ****************************************************************/
+template <std::unsigned_integral Int, CheckPolicy Policy>
+template <std::unsigned_integral I, CheckPolicy P>
+    requires (!std::same_as<BasicCoordinate<I, P>, BasicCoordinate<Int, Policy>>)
+inline constexpr BasicCoordinate<Int, Policy>::BasicCoordinate(
+  const BasicCoordinate<I, P> &other)
+: internal(static_cast<Int>(other.get()))
+{ requireFits(other.get()); }
+
+
+
+
+
+
 /****************************************************************
  * Getter for accessing a Coordinate's internal value.
- * @returns <size_t> The Coordinates numeric value.
+ * @returns <Int> The Coordinates numeric value.
  ****************************************************************/
-inline size_t Coordinate::get() const noexcept { return internal; }
+template <std::unsigned_integral Int, CheckPolicy Policy>
+inline constexpr Int BasicCoordinate<Int, Policy>::get() const noexcept
+{ return internal; }
 
 
 
@@ -281,7 +394,9 @@ inline size_t Coordinate::get() const noexcept { return internal; }
  *  calling Coordinate's internal value.
  * @overload
  ****************************************************************/
-inline size_t Coordinate::operator () () { return get(); }
+template <std::unsigned_integral Int, CheckPolicy Policy>
+inline constexpr Int BasicCoordinate<Int, Policy>::operator () () const noexcept
+{ return get(); }
 
 
 
@@ -294,16 +409,19 @@ inline size_t Coordinate::operator () () { return get(); }
  * @throws if the parameter is negative.
  * @returns <Coordinate &> *this
  ****************************************************************/
+template <std::unsigned_integral Int, CheckPolicy Policy>
 template <Integral T>
-inline void Coordinate::set(const T &num)
+inline constexpr void BasicCoordinate<Int, Policy>::set(const T &num)
 {
-    if (0 > num) {
-        throw X_(
+    require(!std::cmp_less(num, 0), [num] {
+        raise_error(X_(
           ERR_ID::INVALID_NUMBER_SIGN,
-          std::format("The negative value {} cannot be assigned to a Coordinate", num));
-    }
+          "The negative value {} cannot be assigned to a Coordinate",
+          num));
+    });
 
-    internal = num;
+    requireFits(num);
+    internal = static_cast<Int>(num);
 }
 
 
@@ -316,7 +434,9 @@ inline void Coordinate::set(const T &num)
  * @param other Coordinate object to copy from.
  * @returns <Coordinate &> *this
  ****************************************************************/
-inline void Coordinate::set(const Coordinate &other) { internal = other.internal; }
+template <std::unsigned_integral Int, CheckPolicy Policy>
+inline constexpr void BasicCoordinate<Int, Policy>::set(const BasicCoordinate &other) noexcept
+{ internal = other.internal; }
 
 
 
@@ -329,11 +449,13 @@ inline void Coordinate::set(const Coordinate &other) { internal = other.internal
  * @param number <T> Integer-like typed number.
  * @returns <Coordinate> new Coordinate object.
  ****************************************************************/
+template <std::unsigned_integral Int, CheckPolicy Policy>
 template <Integral T>
-inline Coordinate Coordinate::operator = (const T &number)
+inline constexpr BasicCoordinate<Int, Policy> BasicCoordinate<Int, Policy>::operator = (
+  const T &number)
 {
     set(number);
-    return Coordinate(number);
+    return *this;
 }
 
 
@@ -347,10 +469,12 @@ inline Coordinate Coordinate::operator = (const T &number)
  * @param other A Literal integer `<int &&>`
  * @returns <Coordinate> new Coordinate object.
  ****************************************************************/
-inline Coordinate Coordinate::operator = (int &&number)
+template <std::unsigned_integral Int, CheckPolicy Policy>
+inline constexpr BasicCoordinate<Int, Policy> BasicCoordinate<Int, Policy>::operator = (
+  int &&number)
 {
     set(number);
-    return Coordinate(number);
+    return *this;
 }
 
 
@@ -359,14 +483,18 @@ inline Coordinate Coordinate::operator = (int &&number)
 
 
 /****************************************************************
- * Coordinate Copy Assignment Operator: Copys the value of
- * a Coordinate into another Coordinate.
- * @param other Coordinate that gets copied from.
+ * Assign a Coordinate of another policy, or of a narrower width.
+ * The source is already non-negative & fits, so no check is made.
  * @returns `*(this)` Coordinate that was copied to.
  ****************************************************************/
-inline Coordinate Coordinate::operator = (const Coordinate &number)
+template <std::unsigned_integral Int, CheckPolicy Policy>
+template <std::unsigned_integral I, CheckPolicy P>
+    requires (!std::same_as<BasicCoordinate<I, P>, BasicCoordinate<Int, Policy>>)
+          && (sizeof(I) <= sizeof(Int))
+inline constexpr BasicCoordinate<Int, Policy> &BasicCoordinate<Int, Policy>::operator = (
+  const BasicCoordinate<I, P> &other) noexcept
 {
-    set(number);
+    internal = other.get();
     return *this;
 }
 
@@ -380,8 +508,9 @@ inline Coordinate Coordinate::operator = (const Coordinate &number)
  * @tparam An integer-like type to covert the Coordinate to.
  * @returns Internal Coordinate value as type <T>.
  ****************************************************************/
+template <std::unsigned_integral Int, CheckPolicy Policy>
 template <Integral T>
-inline constexpr T Coordinate::convert() const noexcept
+inline constexpr T BasicCoordinate<Int, Policy>::convert() const noexcept
 { return static_cast<T>(internal); }
 
 
@@ -394,8 +523,9 @@ inline constexpr T Coordinate::convert() const noexcept
  * @tparam An integer-like type to covert the Coordinate to.
  * @returns Internal Coordinate value as type <T>.
  ****************************************************************/
+template <std::unsigned_integral Int, CheckPolicy Policy>
 template <Integral T>
-inline Coordinate::operator T() noexcept
+inline constexpr BasicCoordinate<Int, Policy>::operator T() noexcept
 { return convert<T>(); }
 
 
@@ -408,7 +538,8 @@ inline Coordinate::operator T() noexcept
  * @brief Increases the value of the calling Coordinate by 1.
  * @returns Reference to the calling Coordinate after increment.
  ****************************************************************/
-inline Coordinate &Coordinate::operator ++ () noexcept
+template <std::unsigned_integral Int, CheckPolicy Policy>
+inline constexpr BasicCoordinate<Int, Policy> &BasicCoordinate<Int, Policy>::operator ++ () noexcept
 {
     ++internal;
     return *this;
@@ -427,7 +558,8 @@ inline Coordinate &Coordinate::operator ++ () noexcept
  * taken on the Coordinate and it will retain its original value.
  * @returns Reference to the calling Coordinate after decrement.
  ****************************************************************/
-inline Coordinate &Coordinate::operator -- () noexcept
+template <std::unsigned_integral Int, CheckPolicy Policy>
+inline constexpr BasicCoordinate<Int, Policy> &BasicCoordinate<Int, Policy>::operator -- () noexcept
 {
     if (internal > 0) { --internal; }
     return *this;
@@ -438,21 +570,6 @@ inline Coordinate &Coordinate::operator -- () noexcept
 
 
 
-/****************************************************************
- * @details Overloaded Non-Equality Operator (!=): Tests
- * `Coordinate != Coordinate` for equality. This operator is
- *  is defaulted, and a friend to the Coordinate class.
- * @param lhs Reference to the left Coordinate.
- * @param rhs Reference to the right Coordinate.
- * @returns Returns `true` if the Coordinates are equal.
- ****************************************************************/
-inline bool operator == (const Coordinate &, const Coordinate &) noexcept = default;
-
-
-
-
-
-
 /****************************************************************
  * @details Overloaded Equality Operator (==): Tests
  * `Coordinate == Integral` for equality.
@@ -462,9 +579,9 @@ inline bool operator == (const Coordinate &, const Coordinate &) noexcept = defa
  *   and Text-Buffer project, define the `<Integral>` type.
  * @returns Returns `true` if the Coordinates are NOT equal.
  ****************************************************************/
-template <Integral T>  // (CI: ==)
-inline bool operator == (const Coordinate &coord, const T &number)
-{ return static_cast<T>(coord.internal) == number; }
+template <std::unsigned_integral I, CheckPolicy P, Integral T>  // (CI: ==)
+inline constexpr bool operator == (const BasicCoordinate<I, P> &coord, const T &number)
+{ return static_cast<T>(coord.get()) == number; }
 
 
 
@@ -480,9 +597,9 @@ inline bool operator == (const Coordinate &coord, const T &number)
  *   and Text-Buffer project, define the `<Integral>` type.
  * @returns Returns `true` if the Coordinates are NOT equal.
  ****************************************************************/
-template <Integral T>
-inline bool operator != (const Coordinate &coord, const T &number)
-{ return (static_cast<T>(coord.internal) != number); }
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr bool operator != (const BasicCoordinate<I, P> &coord, const T &number)
+{ return (static_cast<T>(coord.get()) != number); }
 
 
 
@@ -499,9 +616,9 @@ inline bool operator != (const Coordinate &coord, const T &number)
  *   and Text-Buffer project, define the `<Integral>` type.
  * @returns Returns `true` if the Coordinates are NOT equal.
  ****************************************************************/
-template <Integral T>  // (IC: ==)
-inline bool operator == (const T &number, const Coordinate &coord)
-{ return (number == static_cast<T>(coord.internal)); }
+template <std::unsigned_integral I, CheckPolicy P, Integral T>  // (IC: ==)
+inline constexpr bool operator == (const T &number, const BasicCoordinate<I, P> &coord)
+{ return (number == static_cast<T>(coord.get())); }
 
 
 
@@ -518,9 +635,9 @@ inline bool operator == (const T &number, const Coordinate &coord)
  *   and Text-Buffer project, define the `<Integral>` type.
  * @returns Returns `true` if the Coordinates are NOT equal.
  ****************************************************************/
-template <Integral T>  // (IC: !=)
-inline bool operator != (const T &number, const Coordinate &coord)
-{ return number != static_cast<T>(coord.internal); }
+template <std::unsigned_integral I, CheckPolicy P, Integral T>  // (IC: !=)
+inline constexpr bool operator != (const T &number, const BasicCoordinate<I, P> &coord)
+{ return number != static_cast<T>(coord.get()); }
 
 
 
@@ -533,9 +650,9 @@ inline bool operator != (const T &number, const Coordinate &coord)
  * @param num A positive integer.
  * @param num A positive integer.
  ****************************************************************/
-template <Integral T>
-inline bool operator > (const Coordinate &coord, const T &number)
-{ return static_cast<T>(coord.internal) > number; }
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr bool operator > (const BasicCoordinate<I, P> &coord, const T &number)
+{ return static_cast<T>(coord.get()) > number; }
 
 
 
@@ -548,9 +665,9 @@ inline bool operator > (const Coordinate &coord, const T &number)
  * @param num A positive integer.
  * @param num A positive integer.
  ****************************************************************/
-template <Integral T>
-inline bool operator >= (const Coordinate &coord, const T &number)
-{ return static_cast<T>(coord.internal) >= number; }
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr bool operator >= (const BasicCoordinate<I, P> &coord, const T &number)
+{ return static_cast<T>(coord.get()) >= number; }
 
 
 
@@ -563,9 +680,9 @@ inline bool operator >= (const Coordinate &coord, const T &number)
  * @param num A positive integer.
  * @param num A positive integer.
  ****************************************************************/
-template <Integral T>
-inline bool operator < (const Coordinate &coord, const T &number)
-{ return static_cast<T>(coord.internal) < number; }
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr bool operator < (const BasicCoordinate<I, P> &coord, const T &number)
+{ return static_cast<T>(coord.get()) < number; }
 
 
 
@@ -578,37 +695,25 @@ inline bool operator < (const Coordinate &coord, const T &number)
  * @param num A positive integer.
  * @param num A positive integer.
  ****************************************************************/
-template <Integral T>
-inline bool operator <= (const Coordinate &coord, const T &number)
-{ return static_cast<T>(coord.internal) <= number; }
-
-
-
-
-
-
-/****************************************************************
- * @details Coordinate 3-Way Comparison Operator (<=>): This
- *   operator is for testing Coordinate vs Coordinate for
- *   strength or weakness. It is a defaulted operator, and is a
- *   friend to the Coordinate class.
- * @param lhs Reference to the left Coordinate.
- * @param rhs Reference to the right Coordinate.
- * @returns <std::strong_ordering> Compiler-deduced comparison
- *   category type. The exact type depends on the members of
- *   Coordinate.
- ****************************************************************/
-inline constexpr auto operator <=> (const Coordinate &, const Coordinate &) noexcept
-  = default;
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr bool operator <= (const BasicCoordinate<I, P> &coord, const T &number)
+{ return static_cast<T>(coord.get()) <= number; }
 
 
 
 
 
 
-template <Integral T>
-inline bool operator > (const T &number, const Coordinate &coord)
-{ return number > static_cast<T>(coord.internal); }
+/**********************************************************
+ * Comparison Operator: 'Greater-than'.
+ * @tparam <std::integral T>
+ * @param num A positive integer.
+ * @param num A positive integer.
+ * @returns true if leftside is greater than rightside.
+ **********************************************************/
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr bool operator > (const T &number, const BasicCoordinate<I, P> &coord)
+{ return number > static_cast<T>(coord.get()); }
 
 
 
@@ -623,9 +728,9 @@ inline bool operator > (const T &number, const Coordinate &coord)
  * @returns true if leftside is greater than or equal to
  *   rightside.
  **********************************************************/
-template <Integral T>
-inline bool operator >= (const T &number, const Coordinate &coord)
-{ return number >= static_cast<T>(coord.internal); }
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr bool operator >= (const T &number, const BasicCoordinate<I, P> &coord)
+{ return number >= static_cast<T>(coord.get()); }
 
 
 
@@ -639,9 +744,9 @@ inline bool operator >= (const T &number, const Coordinate &coord)
  * @param num A positive integer.
  * @returns true if leftside is less than rightside.
  **********************************************************/
-template <Integral T>
-inline bool operator < (const T &number, const Coordinate &coord)
-{ return number < static_cast<T>(coord.internal); }
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr bool operator < (const T &number, const BasicCoordinate<I, P> &coord)
+{ return number < static_cast<T>(coord.get()); }
 
 
 
@@ -656,9 +761,23 @@ inline bool operator < (const T &number, const Coordinate &coord)
  * @returns true if leftside is less than or equal to
  *   rightside.
  **********************************************************/
-template <Integral T>
-inline bool operator <= (const T &number, const Coordinate &coord)
-{ return number <= static_cast<T>(coord.internal); }
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr bool operator <= (const T &number, const BasicCoordinate<I, P> &coord)
+{ return number <= static_cast<T>(coord.get()); }
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * The type two Coordinates of width `I` are added & multiplied in:
+ * `I` itself, or `unsigned` for narrower types, which would
+ * otherwise promote to (& could overflow) signed `int`.
+ ****************************************************************/
+template <std::unsigned_integral I>
+using CoordinateWide = std::make_unsigned_t<std::common_type_t<I, unsigned>>;
 
 
 
@@ -670,9 +789,17 @@ inline bool operator <= (const T &number, const Coordinate &coord)
  * @param lhs Leftside Coordinate
  * @param rhs Rightside Coordinate
  * @returns A new Coordinate that is equal to the sum.
+ * @throws <Exception> OUT_OF_RANGE if a Coordinate narrower than
+ *   `unsigned` cannot hold the sum (Checked policy only).
  ****************************************************************/
-inline Coordinate operator + (const Coordinate &lhs, const Coordinate &rhs) noexcept
-{ return Coordinate(lhs.internal + rhs.internal); }
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> operator + (
+  const BasicCoordinate<I, P> &lhs,
+  const BasicCoordinate<I, P> &rhs) noexcept(!P::THROWS)
+{
+    using Wide = CoordinateWide<I>;
+    return BasicCoordinate<I, P>::narrow(Wide(lhs.get()) + Wide(rhs.get()));
+}
 
 
 
@@ -684,9 +811,17 @@ inline Coordinate operator + (const Coordinate &lhs, const Coordinate &rhs) noex
  * @param lhs Leftside Coordinate
  * @param rhs Rightside Coordinate
  * @returns A new Coordinate that is equal to the product.
+ * @throws <Exception> OUT_OF_RANGE if a Coordinate narrower than
+ *   `unsigned` cannot hold the product (Checked policy only).
  ****************************************************************/
-inline Coordinate operator * (const Coordinate &lhs, const Coordinate &rhs) noexcept
-{ return Coordinate(lhs.internal * rhs.internal); }
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> operator * (
+  const BasicCoordinate<I, P> &lhs,
+  const BasicCoordinate<I, P> &rhs) noexcept(!P::THROWS)
+{
+    using Wide = CoordinateWide<I>;
+    return BasicCoordinate<I, P>::narrow(Wide(lhs.get()) * Wide(rhs.get()));
+}
 
 
 
@@ -694,19 +829,22 @@ inline Coordinate operator * (const Coordinate &lhs, const Coordinate &rhs) noex
 
 
 /****************************************************************
- * Division operator. Divides left side Coordinate by the
- * rightside Coordinate.s
+ * Subtraction operator. Subtract the rightside Coordinate from
+ * the leftside Coordinate.
  * @param lhs Leftside Coordinate
  * @param rhs Rightside Coordinate
  * @returns A new Coordinate that is equal to the difference.
  ****************************************************************/
-inline Coordinate operator - (const Coordinate &lhs, const Coordinate &rhs)
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> operator - (
+  const BasicCoordinate<I, P> &lhs,
+  const BasicCoordinate<I, P> &rhs)
 {
-    if (rhs.internal > lhs.internal) {
-        throw GenErr::coord_op_neg("-", lhs.internal, rhs.internal);
-    }
+    BasicCoordinate<I, P>::require(rhs.get() <= lhs.get(), [&] {
+        raise_error(GenErr::coord_op_neg("-", lhs.get(), rhs.get()));
+    });
 
-    return Coordinate(lhs.internal - rhs.internal);
+    return BasicCoordinate<I, P>::narrow(lhs.get() - rhs.get());
 }
 
 
@@ -721,10 +859,15 @@ inline Coordinate operator - (const Coordinate &lhs, const Coordinate &rhs)
  * @param rhs Rightside Coordinate
  * @returns A new Coordinate that is equal to the quotient.
  ****************************************************************/
-inline Coordinate operator / (const Coordinate &lhs, const Coordinate &rhs)
+template <std::unsigned_integral I, CheckPolicy P>
+inline constexpr BasicCoordinate<I, P> operator / (
+  const BasicCoordinate<I, P> &lhs,
+  const BasicCoordinate<I, P> &rhs)
 {
-    if (rhs.internal == 0) { throw GenErr::division_by_zero(); }
-    return Coordinate(lhs.internal / rhs.internal);
+    BasicCoordinate<I, P>::require(rhs.get() != 0, [&] {
+        raise_error(GenErr::division_by_zero(lhs.get()));
+    });
+    return BasicCoordinate<I, P>::narrow(rhs.get() == 0 ? 0 : lhs.get() / rhs.get());
 }
 
 
@@ -740,18 +883,19 @@ inline Coordinate operator / (const Coordinate &lhs, const Coordinate &rhs)
  * Coordinate implemented type `Integral`
  * @returns A new Coordinate that is equal to the sum.
  ****************************************************************/
-template <Integral T>
-inline Coordinate operator + (const Coordinate &coord, T number)
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> operator + (const BasicCoordinate<I, P> &coord, T number)
 {
-    const auto COORD = T(coord.internal);
-    if (0 > COORD + number) {
-        throw generate_negative_number_exception(
-          std::format(
-            "The operation {} + {} would result in a negative Coordinate value.",
-            COORD,
-            number));
-    }
-    return Coordinate(COORD + number);
+    const auto COORD = T(coord.get());
+
+    BasicCoordinate<I, P>::require(!(0 > COORD + number), [&] {
+        raise_error(generate_negative_number_exception(
+          "The operation {} + {} would result in a negative Coordinate value.",
+          COORD,
+          number));
+    });
+
+    return BasicCoordinate<I, P>::narrow(COORD + number);
 }
 
 
@@ -767,19 +911,20 @@ inline Coordinate operator + (const Coordinate &coord, T number)
  * Coordinate implemented type `Integral`
  * @returns A new Coordinate that is equal to the product.
  ****************************************************************/
-template <Integral T>
-inline Coordinate operator * (const Coordinate &coord, T number)
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> operator * (const BasicCoordinate<I, P> &coord, T number)
 {
-    const auto COORD = T(coord.internal);
-    if (COORD == 0) { return Coordinate(0); }
-    if (0 > number) {
-        throw generate_negative_number_exception(
-          std::format(
-            "The operation {} * {} would result in a negative Coordinate value.",
-            COORD,
-            number));
-    }
-    return Coordinate(COORD * number);
+    const auto COORD = T(coord.get());
+    if (COORD == 0) { return BasicCoordinate<I, P>::narrow(0); }
+
+    BasicCoordinate<I, P>::require(!std::cmp_less(number, 0), [&] {
+        raise_error(generate_negative_number_exception(
+          "The operation {} * {} would result in a negative Coordinate value.",
+          COORD,
+          number));
+    });
+
+    return BasicCoordinate<I, P>::narrow(COORD * number);
 }
 
 
@@ -795,18 +940,19 @@ inline Coordinate operator * (const Coordinate &coord, T number)
  * Coordinate implemented type `Integral`
  * @returns A new Coordinate that is equal to the difference.
  ****************************************************************/
-template <Integral T>
-inline Coordinate operator - (const Coordinate &coord, T number)
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> operator - (const BasicCoordinate<I, P> &coord, T number)
 {
-    const auto COORD = T(coord.internal);
-    if (0 > COORD - number) {
-        throw generate_negative_number_exception(
-          std::format(
-            "The operation {} - {} would result in a negative Coordinate value.",
-            COORD,
-            number));
-    }
-    return Coordinate(COORD - number);
+    const auto COORD = T(coord.get());
+
+    BasicCoordinate<I, P>::require(!(0 > COORD - number), [&] {
+        raise_error(generate_negative_number_exception(
+          "The operation {} - {} would result in a negative Coordinate value.",
+          COORD,
+          number));
+    });
+
+    return BasicCoordinate<I, P>::narrow(COORD - number);
 }
 
 
@@ -822,23 +968,27 @@ inline Coordinate operator - (const Coordinate &coord, T number)
  * Coordinate implemented type `Integral`
  * @returns A new Coordinate that is equal to the quotient.
  ****************************************************************/
-template <Integral T>
-inline Coordinate operator / (const Coordinate &coord, T number)
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> operator / (const BasicCoordinate<I, P> &coord, T number)
 {
-    const auto COORD = T(coord.internal);
-    if (number == 0) {
-        throw generate_negative_number_exception(
-          std::format(
-            "The operation {} / {} would result in a negative Coordinate value.",
-            COORD,
-            number));
-    }
-    if (0 > COORD / number) {
-        throw generate_division_by_zero_exception(
+    const auto COORD = T(coord.get());
+
+    BasicCoordinate<I, P>::require(number != 0, [&] {
+        raise_error(generate_negative_number_exception(
+          "The operation {} / {} would result in a negative Coordinate value.",
+          COORD,
+          number));
+    });
+
+    if (number == 0) { return BasicCoordinate<I, P>::narrow(0); }
+
+    BasicCoordinate<I, P>::require(!(0 > COORD / number), [] {
+        raise_error(generate_division_by_zero_exception(
           "Division by zero produces a result that cannot be represented because the "
-          "result is considered 'NOT REAL'");
-    }
-    return Coordinate(COORD / number);
+          "result is considered 'NOT REAL'"));
+    });
+
+    return BasicCoordinate<I, P>::narrow(COORD / number);
 }
 
 
@@ -854,12 +1004,16 @@ inline Coordinate operator / (const Coordinate &coord, T number)
  * Coordinate implemented type `Integral`
  * @returns A new Coordinate that is equal to the sum.
  ****************************************************************/
-template <Integral T>
-inline Coordinate operator + (T number, const Coordinate &coord)
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> operator + (T number, const BasicCoordinate<I, P> &coord)
 {
-    const auto COORD = T(coord.internal);
-    if (0 > number + COORD) { throw GenErr::coord_op_neg("+", number, COORD); }
-    return Coordinate(number + COORD);
+    const auto COORD = T(coord.get());
+
+    BasicCoordinate<I, P>::require(!(0 > number + COORD), [&] {
+        raise_error(GenErr::coord_op_neg("+", number, COORD));
+    });
+
+    return BasicCoordinate<I, P>::narrow(number + COORD);
 }
 
 
@@ -875,13 +1029,17 @@ inline Coordinate operator + (T number, const Coordinate &coord)
  * Coordinate implemented type `Integral`
  * @returns A new Coordinate that is equal to the product.
  ****************************************************************/
-template <Integral T>
-inline Coordinate operator * (T number, const Coordinate &coord)
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> operator * (T number, const BasicCoordinate<I, P> &coord)
 {
-    const auto COORD = T(coord.internal);
-    if (COORD == 0) return Coordinate(0);
-    if (0 > number) throw GenErr::coord_op_neg("*", number, COORD);
-    return Coordinate(number * COORD);
+    const auto COORD = T(coord.get());
+    if (COORD == 0) { return BasicCoordinate<I, P>::narrow(0); }
+
+    BasicCoordinate<I, P>::require(!std::cmp_less(number, 0), [&] {
+        raise_error(GenErr::coord_op_neg("*", number, COORD));
+    });
+
+    return BasicCoordinate<I, P>::narrow(number * COORD);
 }
 
 
@@ -897,12 +1055,16 @@ inline Coordinate operator * (T number, const Coordinate &coord)
  * Coordinate implemented type `Integral`
  * @returns A new Coordinate that is equal to the difference.
  ****************************************************************/
-template <Integral T>
-inline Coordinate operator - (T number, const Coordinate &coord)
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> operator - (T number, const BasicCoordinate<I, P> &coord)
 {
-    const auto COORD = T(coord.internal);
-    if (0 > number - COORD) { throw GenErr::coord_op_neg("-", number, COORD); }
-    return Coordinate(number - COORD);
+    const auto COORD = T(coord.get());
+
+    BasicCoordinate<I, P>::require(!(0 > number - COORD), [&] {
+        raise_error(GenErr::coord_op_neg("-", number, COORD));
+    });
+
+    return BasicCoordinate<I, P>::narrow(number - COORD);
 }
 
 
@@ -918,16 +1080,44 @@ inline Coordinate operator - (T number, const Coordinate &coord)
  * Coordinate implemented type `Integral`
  * @returns A new Coordinate that is equal to the quotient.
  ****************************************************************/
-template <Integral T>
-inline Coordinate operator / (T number, const Coordinate &coord)
+template <std::unsigned_integral I, CheckPolicy P, Integral T>
+inline constexpr BasicCoordinate<I, P> operator / (T number, const BasicCoordinate<I, P> &coord)
 {
-    const auto COORD = T(coord.internal);
-    if (COORD == 0) { throw GenErr::division_by_zero(); }
-    if (0 > number / COORD) { throw GenErr::coord_op_neg("/", number, COORD); }
-    return Coordinate(number / COORD);
+    const auto COORD = T(coord.get());
+
+    BasicCoordinate<I, P>::require(COORD != 0, [&] {
+        raise_error(GenErr::division_by_zero(number));
+    });
+    if (COORD == 0) { return BasicCoordinate<I, P>::narrow(0); }
+
+    BasicCoordinate<I, P>::require(!(0 > number / COORD), [&] {
+        raise_error(GenErr::coord_op_neg("/", number, COORD));
+    });
+
+    return BasicCoordinate<I, P>::narrow(number / COORD);
 }
 
 
+
+
+static_assert(std::is_trivially_copyable_v<Coordinate>);
+static_assert(std::is_trivially_copyable_v<UncheckedCoordinate>);
+static_assert(sizeof(Coordinate32) == sizeof(uint32_t));
+
+
 }  // END NAMESPACE 'TEXT'
 
-#endif
\ No newline at end of file
+
+
+
+/****************************************************************
+ * std::hash for Coordinates, e.g. as `std::unordered_map` keys.
+ ****************************************************************/
+template <std::unsigned_integral Int, Text::CheckPolicy Policy>
+struct std::hash<Text::BasicCoordinate<Int, Policy>>
+{
+    size_t operator () (const Text::BasicCoordinate<Int, Policy> &coord) const noexcept
+    { return size_t(Text_Buffer::hash_mix(coord.get())); }
+};
+
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+#ifndef DECORATION_HPP
+#define DECORATION_HPP
+
+#include <text/stats.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace Text {
+
+using DecorationId = uint32_t;
+
+
+
+
+/**************************************************************
+ * DecorationTree Class: An augmented interval tree of byte ranges
+ * (highlights, diagnostics, search hits) that stays consistent as
+ * the text around them is edited.
+ *
+ * Ranges live in a treap ordered by start offset. Every node keeps
+ * the largest end offset in its subtree, so overlap queries skip
+ * subtrees that end before the query & visit O(log n + k) nodes.
+ * Subtrees that lie entirely after an edit are shifted with a lazy
+ * tag in O(log n); only the k ranges that overlap the edit itself
+ * are visited & re-inserted individually.
+ *
+ * A range [start, end] never grows when text is typed at one of its
+ * edges: its start sticks to the text after an insertion & its end
+ * to the text before one.
+ **************************************************************/
+class DecorationTree
+{
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node
+    {
+        size_t   start    = 0;
+        size_t   end      = 0;
+        size_t   maxEnd   = 0;
+        int64_t  add      = 0;  /// Pending shift for the children
+        uint32_t kind     = 0;
+        uint32_t priority = 0;
+        uint32_t left     = NIL;
+        uint32_t right    = NIL;
+        uint32_t parent   = NIL;
+        bool     live     = false;
+    };
+
+    std::vector<Node>         nodes;
+    std::vector<DecorationId> freeIds;
+    std::vector<DecorationId> scratch;
+    uint32_t                  root  = NIL;
+    uint32_t                  seed  = 0x85EBCA6Bu;
+    size_t                    count = 0;
+    StatCounters              counters;
+
+  public:
+    DecorationTree() = default;
+
+    DecorationId add(size_t start, size_t end, uint32_t kind = 0);
+    void         remove(DecorationId id);
+    bool         contains(DecorationId id) const noexcept;
+    size_t       size() const noexcept;
+    void         clear() noexcept;
+    Stats        stats() const noexcept { return counters.snapshot(); }
+    size_t       memoryUsage() const noexcept;
+    void         shrinkToFit();
+
+    std::pair<size_t, size_t> rangeOf(DecorationId id) const;
+    uint32_t                  kindOf(DecorationId id) const;
+
+    void query(size_t from, size_t to, std::vector<DecorationId> &out) const;
+    void replace(size_t offset, size_t length, size_t inserted);
+
+  private:
+    uint32_t nextPriority() noexcept;
+    void     apply(uint32_t n, int64_t add) noexcept;
+    void     push(uint32_t n) noexcept;
+    void     pushPath(uint32_t n) noexcept;
+    void     pull(uint32_t n) noexcept;
+    void     split(uint32_t n, size_t key, uint32_t &lo, uint32_t &hi);
+    uint32_t merge(uint32_t lo, uint32_t hi);
+    void     insert(uint32_t &tree, uint32_t n);
+    void     unlink(uint32_t &tree, uint32_t n);
+    void     collectAll(uint32_t n, std::vector<DecorationId> &out);
+    void     collectEndsAfter(uint32_t n, size_t offset, std::vector<DecorationId> &out);
+    void     query(
+      uint32_t n, int64_t shift, size_t from, size_t to, std::vector<DecorationId> &out) const;
+    void     check(DecorationId id) const;
+};
+
+}  // namespace Text
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#ifndef DIFF_HPP
+#define DIFF_HPP
+
+#include <text/position.hpp>
+
+#include <cstddef>
+#include <vector>
+
+
+namespace Text {
+
+class Buffer;
+
+
+/**************************************************************
+ * DiffHunk: A run of lines of one Buffer replaced by a run of
+ * lines of the other. Each side is the range [start, end) of
+ * Positions; an empty range marks where lines are inserted or
+ * were removed. Replacing the text of every hunk's old range by
+ * the text of its new range, last hunk first, turns the old
+ * Buffer into the new one.
+ **************************************************************/
+struct DiffHunk
+{
+    Position oldStart;
+    Position oldEnd;
+    Position newStart;
+    Position newEnd;
+    size_t   oldLines = 0;  /// Lines removed from the old Buffer
+    size_t   newLines = 0;  /// Lines inserted from the new Buffer
+};
+
+
+std::vector<DiffHunk> diff(const Buffer &from, const Buffer &to, size_t threads = 0);
+
+}  // namespace Text
+
+#endif
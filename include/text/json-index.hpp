@@ -0,0 +1,102 @@
+#pragma once
+#ifndef JSON_INDEX_HPP
+#define JSON_INDEX_HPP
+
+#include <text/position.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Text {
+
+class Buffer;
+
+
+enum class JsonError : uint8_t
+{
+    NONE,
+    EMPTY_DOCUMENT,        /// No value at all
+    UNEXPECTED_CHARACTER,  /// A structural character or value where it is not allowed
+    UNEXPECTED_END,        /// The text ends inside an array or object
+    TRAILING_CONTENT,      /// Anything but whitespace after the root value
+    INVALID_LITERAL,       /// A bare word other than true, false & null
+    INVALID_NUMBER,        /// A number not following the JSON grammar
+    INVALID_ESCAPE,        /// A backslash not starting a valid escape
+    CONTROL_CHARACTER,     /// An unescaped byte below 0x20 inside a string
+    UNTERMINATED_STRING    /// A string without a closing quote
+};
+
+
+inline constexpr std::string_view jsonErrorName(JsonError error) noexcept
+{
+    switch (error) {
+        case JsonError::NONE: return "none";
+        case JsonError::EMPTY_DOCUMENT: return "empty_document";
+        case JsonError::UNEXPECTED_CHARACTER: return "unexpected_character";
+        case JsonError::UNEXPECTED_END: return "unexpected_end";
+        case JsonError::TRAILING_CONTENT: return "trailing_content";
+        case JsonError::INVALID_LITERAL: return "invalid_literal";
+        case JsonError::INVALID_NUMBER: return "invalid_number";
+        case JsonError::INVALID_ESCAPE: return "invalid_escape";
+        case JsonError::CONTROL_CHARACTER: return "control_character";
+        case JsonError::UNTERMINATED_STRING: return "unterminated_string";
+    }
+    return "unknown";
+}
+
+
+
+
+/**************************************************************
+ * JsonIndex Class: The structural index of a JSON document held
+ * in a Buffer, built the way simdjson's first stage builds it.
+ *
+ * The text is classified 64 bytes at a time into bitmasks of
+ * quotes, backslashes, whitespace & the characters `{}[]:,`.
+ * Escaped quotes are removed with carry arithmetic over runs of
+ * backslashes, a prefix XOR of the remaining quotes gives the
+ * bytes inside strings, & what is left outside them yields the
+ * tape: the offsets of every structural character, opening
+ * quote & first byte of a number or literal, in text order.
+ *
+ * A second pass walks the tape to check the grammar, numbers,
+ * literals & escapes, & records the first syntax error. Offsets
+ * become Positions only on request, through the Buffer's line
+ * index, so indexing never tracks rows or columns.
+ *
+ * The index refers to the Buffer: editing the Buffer makes it
+ * stale. Documents must be smaller than 4 GiB.
+ **************************************************************/
+class JsonIndex
+{
+    const Buffer         *buffer;
+    std::vector<uint32_t> tape;
+    JsonError             code    = JsonError::NONE;
+    size_t                errorAt = 0;
+
+  public:
+    explicit JsonIndex(const Buffer &source);
+
+    // TAPE
+    size_t                    size() const noexcept { return tape.size(); }
+    std::span<const uint32_t> offsets() const noexcept { return tape; }
+    Position                  position(size_t index) const;
+    void                      positions(size_t first, std::span<Position> out) const;
+
+    // VALIDATION
+    bool      ok() const noexcept { return code == JsonError::NONE; }
+    JsonError error() const noexcept { return code; }
+    size_t    errorOffset() const noexcept { return errorAt; }
+    Position  errorPosition() const;
+
+  private:
+    void fail(JsonError error, size_t offset) noexcept;
+    void validate(std::string_view text, std::span<const uint64_t> escapes, bool unterminated);
+};
+
+}  // namespace Text
+
+#endif
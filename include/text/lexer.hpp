@@ -0,0 +1,234 @@
+#pragma once
+#ifndef LEXER_HPP
+#define LEXER_HPP
+
+#include <text/position.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Text {
+
+class Buffer;
+
+
+/**************************************************************
+ * CharSet: A set of bytes, used to describe the characters a
+ * lexer rule accepts. Bytes >= 0x80 (UTF-8 lead & continuation
+ * bytes) can be included with `CharSet::utf8()`, so identifiers
+ * may contain non-ASCII characters without decoding them.
+ **************************************************************/
+struct CharSet
+{
+    std::array<uint64_t, 4> bits{};
+
+    static constexpr CharSet of(std::string_view chars) noexcept
+    {
+        CharSet set;
+        for (const char c : chars) { set.add(static_cast<unsigned char>(c)); }
+        return set;
+    }
+
+    static constexpr CharSet range(unsigned char first, unsigned char last) noexcept
+    {
+        CharSet set;
+        for (unsigned c = first; c <= last; ++c) { set.add(static_cast<unsigned char>(c)); }
+        return set;
+    }
+
+    static constexpr CharSet utf8() noexcept { return range(0x80, 0xFF); }
+
+    constexpr void add(unsigned char c) noexcept { bits[c >> 6] |= uint64_t(1) << (c & 63); }
+
+    constexpr bool contains(unsigned char c) const noexcept
+    { return (bits[c >> 6] >> (c & 63)) & 1; }
+
+    friend constexpr CharSet operator | (CharSet lhs, const CharSet &rhs) noexcept
+    {
+        for (size_t i = 0; i < 4; ++i) { lhs.bits[i] |= rhs.bits[i]; }
+        return lhs;
+    }
+};
+
+
+
+
+using TokenKind = uint32_t;
+
+
+/**************************************************************
+ * Token: A view of one token of the lexed text, with the Position
+ * of its first byte & the Position just past its last byte. The
+ * view points into the lexed text; nothing is copied.
+ **************************************************************/
+struct Token
+{
+    TokenKind        kind = 0;
+    std::string_view text;
+    size_t           offset = 0;  /// Byte offset of the first byte
+    Position         start;
+    Position         end;
+};
+
+
+
+
+/**************************************************************
+ * Lexicon Class: The rules of a language. Each rule describes
+ * one kind of token; at every offset the rule matching the most
+ * bytes wins (ties go to the rule added first), & a byte no rule
+ * matches becomes a one-byte token of the `unknown` kind.
+ *
+ * Rules are indexed by the bytes they can start with, so only
+ * the candidates for the byte at hand are tried, & each knows
+ * whether its tokens can span lines. Building a Lexicon
+ * allocates; lexing with it does not.
+ *
+ * Matching a token reads at most `lookahead()` bytes past its end
+ * (unterminated comments & strings read to their end), so a token
+ * ending that far before an edit is unaffected by it.
+ **************************************************************/
+class Lexicon
+{
+  public:
+    struct Match
+    {
+        size_t    length = 0;
+        TokenKind kind   = 0;
+        bool      lines  = true;  /// False if the token cannot contain a line break
+    };
+
+  private:
+    enum class RuleType : uint8_t { RUN, LITERAL, QUOTED, LINE, BLOCK };
+
+    struct Rule
+    {
+        RuleType    type;
+        TokenKind   kind;
+        CharSet     rest;             /// RUN: bytes after the first
+        std::string open;             /// LITERAL, LINE, BLOCK: the leading text
+        std::string close;            /// BLOCK: the closing text
+        char        quote     = 0;    /// QUOTED
+        char        escape    = 0;    /// QUOTED: 0 if there is none
+        bool        multiline = false;  /// Whether a match can contain a line break
+    };
+
+    std::vector<Rule>                      rules;
+    std::array<std::vector<uint16_t>, 256> byFirst;       /// Candidate rules per first byte
+    std::vector<TokenKind>                 skipped;       /// Skipped kinds >= 64
+    uint64_t                               skipMask = 0;  /// Skipped kinds < 64
+    size_t                                 reach    = 1;  /// Longest literal or opener, or 1
+    TokenKind                              unknown;
+
+  public:
+    explicit Lexicon(TokenKind unknownKind);
+
+    Lexicon &run(TokenKind kind, const CharSet &first, const CharSet &rest);
+    Lexicon &literal(TokenKind kind, std::string_view text);
+    Lexicon &quoted(TokenKind kind, char quote, char escape = '\\', bool multiline = false);
+    Lexicon &lineComment(TokenKind kind, std::string_view prefix);
+    Lexicon &blockComment(TokenKind kind, std::string_view open, std::string_view close);
+    Lexicon &skip(TokenKind kind);
+
+    bool   skips(TokenKind kind) const noexcept;
+    Match  match(std::string_view rest) const noexcept;
+    size_t lookahead() const noexcept { return reach; }
+
+  private:
+    Lexicon &add(Rule rule, const CharSet &first);
+    size_t   length(const Rule &rule, std::string_view rest) const noexcept;
+};
+
+
+
+
+/**************************************************************
+ * Lexer Class: Splits text into Tokens by the rules of a Lexicon,
+ * skipping the kinds the Lexicon skips.
+ *
+ * Positions are tracked in bulk: once a token is matched, its
+ * bytes are searched for newlines with `memchr` (unless its rule
+ * rules line breaks out), so the row & line start only change
+ * per line break, never per character.
+ * Lexing neither copies the text nor allocates.
+ **************************************************************/
+class Lexer
+{
+    std::string_view text;
+    const Lexicon   *lexicon;
+    size_t           at;         /// Offset of the next token
+    size_t           row;        /// One-based row of `at`
+    size_t           lineStart;  /// Offset of that row's first byte
+
+  public:
+    class iterator;
+
+    Lexer(std::string_view source, const Lexicon &rules);
+    Lexer(const Buffer &buffer, const Lexicon &rules);
+    Lexer(const std::string &source, const Lexicon &rules)  /// Not the implicit Buffer
+    : Lexer(std::string_view(source), rules)
+    {}
+    Lexer(std::string_view source, const Lexicon &rules, size_t offset, const Position &pos);
+
+    bool     next(Token &token) noexcept;
+    size_t   offset() const noexcept { return at; }
+    Position position() const noexcept;
+
+    iterator                 begin();
+    std::default_sentinel_t  end() const noexcept { return {}; }
+
+  private:
+    void advance(size_t to, bool lines) noexcept;
+};
+
+
+
+
+/**************************************************************
+ * Lexer::iterator: An input iterator over the remaining tokens,
+ * so a Lexer can drive a range-for loop.
+ **************************************************************/
+class Lexer::iterator
+{
+    Lexer *lexer = nullptr;
+    Token  token;
+    bool   done = true;
+
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type       = Token;
+    using difference_type  = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(Lexer &source)
+    : lexer(&source)
+    , done(!source.next(token))
+    {}
+
+    const Token &operator * () const noexcept { return token; }
+    const Token *operator -> () const noexcept { return &token; }
+
+    iterator &operator ++ () noexcept
+    {
+        done = !lexer->next(token);
+        return *this;
+    }
+
+    void operator ++ (int) noexcept { ++*this; }
+
+    friend bool operator == (const iterator &it, std::default_sentinel_t) noexcept
+    { return it.done; }
+};
+
+
+inline Lexer::iterator Lexer::begin() { return iterator(*this); }
+
+}  // namespace Text
+
+#endif
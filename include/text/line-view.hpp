@@ -0,0 +1,213 @@
+#pragma once
+#ifndef LINE_VIEW_HPP
+#define LINE_VIEW_HPP
+
+#include <text/coordinate.hpp>
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string_view>
+
+
+namespace Text {
+
+/**************************************************************
+ * BufferLine: One row of a Buffer, as yielded by `LineView`.
+ **************************************************************/
+struct BufferLine
+{
+    Coordinate       row;   /// One-based
+    std::string_view text;  /// Without its line break
+};
+
+
+
+
+/**************************************************************
+ * LineView Class: A lazy, random-access range over rows of a
+ * Buffer, yielding a `BufferLine` per row.
+ *
+ * The view holds nothing but a window on the Buffer's text & line
+ * index: iterating it reads a row's bounds from the index & makes
+ * a string_view of the row, so it allocates nothing & composes
+ * with the standard views (`std::views::filter`, `take`, ...).
+ *
+ * `partition()` cuts the view into consecutive sub-views of about
+ * equal bytes, to be handed to separate threads.
+ *
+ * Editing the Buffer invalidates the view & its iterators, as it
+ * invalidates string_views of its text.
+ **************************************************************/
+class LineView : public std::ranges::view_interface<LineView>
+{
+    std::string_view text;             /// The Buffer's whole text
+    const size_t    *starts = nullptr; /// Offset of each Buffer row's 1st byte
+    size_t           total  = 0;       /// Rows in the Buffer
+    size_t           first  = 0;       /// First row of the view, zero-based
+    size_t           last   = 0;       /// One past its last row
+
+  public:
+    class iterator;
+
+    LineView() = default;
+
+    /**************************************************************
+     * @param source The Buffer's text.
+     * @param lineStarts The Buffer's line index; one entry per row.
+     * @param from,to Zero-based rows [from, to) of the view.
+     **************************************************************/
+    LineView(
+      std::string_view        source,
+      std::span<const size_t> lineStarts,
+      size_t                  from,
+      size_t                  to) noexcept
+    : text(source)
+    , starts(lineStarts.data())
+    , total(lineStarts.size())
+    , first(from)
+    , last(to)
+    {}
+
+    iterator begin() const noexcept;
+    iterator end() const noexcept;
+    size_t   size() const noexcept { return last - first; }
+
+    /**************************************************************
+     * @returns <size_t> The bytes the view's rows span, line breaks
+     *   included.
+     **************************************************************/
+    size_t bytes() const noexcept { return offsetOf(last) - offsetOf(first); }
+
+    void partition(std::span<LineView> out) const noexcept;
+
+  private:
+    size_t offsetOf(size_t row0) const noexcept
+    { return row0 < total ? starts[row0] : text.size(); }
+
+    BufferLine at(size_t row0) const noexcept
+    {
+        const size_t start = starts[row0];
+        size_t       end   = offsetOf(row0 + 1);
+
+        if (end > start && text[end - 1] == '\n') { --end; }
+        if (end > start && text[end - 1] == '\r') { --end; }
+
+        return { Coordinate(row0 + 1), text.substr(start, end - start) };
+    }
+};
+
+
+
+
+class LineView::iterator
+{
+    LineView view;  /// A copy, so iterators outlive the view they came from
+    size_t   row0 = 0;
+
+  public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type       = BufferLine;
+    using difference_type  = std::ptrdiff_t;
+
+    iterator() = default;
+    iterator(const LineView &owner, size_t row) noexcept
+    : view(owner)
+    , row0(row)
+    {}
+
+    BufferLine operator*() const noexcept { return view.at(row0); }
+    BufferLine operator[](difference_type n) const noexcept { return *(*this + n); }
+
+    iterator &operator++() noexcept
+    {
+        ++row0;
+        return *this;
+    }
+
+    iterator &operator--() noexcept
+    {
+        --row0;
+        return *this;
+    }
+
+    iterator operator++(int) noexcept
+    {
+        const iterator copy = *this;
+        ++row0;
+        return copy;
+    }
+
+    iterator operator--(int) noexcept
+    {
+        const iterator copy = *this;
+        --row0;
+        return copy;
+    }
+
+    iterator &operator+=(difference_type n) noexcept
+    {
+        row0 = size_t(difference_type(row0) + n);
+        return *this;
+    }
+
+    iterator &operator-=(difference_type n) noexcept { return *this += -n; }
+
+    friend iterator operator+(iterator it, difference_type n) noexcept { return it += n; }
+    friend iterator operator+(difference_type n, iterator it) noexcept { return it += n; }
+    friend iterator operator-(iterator it, difference_type n) noexcept { return it -= n; }
+
+    friend difference_type operator-(const iterator &a, const iterator &b) noexcept
+    { return difference_type(a.row0) - difference_type(b.row0); }
+
+    friend bool operator==(const iterator &a, const iterator &b) noexcept
+    { return a.row0 == b.row0; }
+
+    friend auto operator<=>(const iterator &a, const iterator &b) noexcept
+    { return a.row0 <=> b.row0; }
+};
+
+
+inline LineView::iterator LineView::begin() const noexcept { return { *this, first }; }
+inline LineView::iterator LineView::end() const noexcept { return { *this, last }; }
+
+
+
+
+/**************************************************************
+ * Cut the view into `out.size()` consecutive views of about equal
+ * bytes, found by binary search on the line index. Together they
+ * hold every row of the view, in order; some may be empty.
+ **************************************************************/
+inline void LineView::partition(std::span<LineView> out) const noexcept
+{
+    const size_t from   = offsetOf(first);
+    const size_t length = bytes();
+    size_t       row0   = first;
+
+    for (size_t i = 0; i < out.size(); ++i) {
+        size_t end = last;
+
+        if (i + 1 < out.size()) {
+            const size_t target = from + length / out.size() * (i + 1);
+            end = size_t(std::lower_bound(starts + row0, starts + last, target) - starts);
+        }
+
+        out[i]       = *this;
+        out[i].first = row0;
+        out[i].last  = end;
+        row0         = end;
+    }
+}
+
+}  // namespace Text
+
+
+// Iterators hold the rows' bounds themselves, so they stay valid after the view is gone.
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<Text::LineView> = true;
+
+#endif
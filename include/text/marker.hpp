@@ -0,0 +1,99 @@
+#pragma once
+#ifndef MARKER_HPP
+#define MARKER_HPP
+
+#include <text/stats.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace Text {
+
+using MarkerId = uint32_t;
+
+
+/**************************************************************
+ * Gravity decides which side of an insertion a Marker sticks to
+ * when text is inserted exactly at its offset. LEFT markers stay
+ * before the new text, RIGHT markers move after it.
+ **************************************************************/
+enum class Gravity
+{
+    LEFT  = 0,
+    RIGHT = 1
+};
+
+
+
+
+/**************************************************************
+ * MarkerTree Class: Stores Markers (anchors) keyed by byte offset
+ * & keeps them in place as the text around them is edited.
+ *
+ * Markers live in one treap per gravity. Every node carries a lazy
+ * affine tag (`offset * mul + add`, where `mul` is 0 or 1) that is
+ * only pushed to its children when a path through the node is
+ * walked. An edit splits each treap into the markers before, inside
+ * & after the replaced range, tags the middle part to collapse onto
+ * the edit & the last part to shift by the length delta, & merges
+ * them back: O(log n) regardless of how many markers move.
+ **************************************************************/
+class MarkerTree
+{
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node
+    {
+        size_t   offset   = 0;
+        int64_t  add      = 0;     /// Pending tag: children += add
+        bool     mul      = true;  /// Pending tag: false collapses children
+        bool     pending  = false;
+        bool     live     = false;
+        Gravity  gravity  = Gravity::LEFT;
+        uint32_t priority = 0;
+        uint32_t left     = NIL;
+        uint32_t right    = NIL;
+        uint32_t parent   = NIL;
+    };
+
+    std::vector<Node>     nodes;
+    std::vector<MarkerId> freeIds;
+    uint32_t              roots[2] = { NIL, NIL };
+    uint32_t              seed     = 0x9E3779B9u;
+    size_t                count    = 0;
+    StatCounters          counters;
+
+  public:
+    MarkerTree() = default;
+
+    MarkerId add(size_t offset, Gravity gravity = Gravity::LEFT);
+    void     remove(MarkerId id);
+    bool     contains(MarkerId id) const noexcept;
+    size_t   offsetOf(MarkerId id) const;
+    Gravity  gravityOf(MarkerId id) const;
+    size_t   size() const noexcept;
+    void     clear() noexcept;
+    Stats    stats() const noexcept { return counters.snapshot(); }
+    size_t   memoryUsage() const noexcept;
+    void     shrinkToFit();
+
+    void collect(size_t from, size_t to, std::vector<MarkerId> &out);
+    void replace(size_t offset, size_t length, size_t inserted);
+
+  private:
+    uint32_t nextPriority() noexcept;
+    void     apply(uint32_t n, bool mul, int64_t add) noexcept;
+    void     push(uint32_t n) noexcept;
+    void     pushPath(uint32_t n) noexcept;
+    void     attach(uint32_t n) noexcept;
+    void     split(uint32_t n, size_t key, bool inclusive, uint32_t &lo, uint32_t &hi);
+    uint32_t merge(uint32_t lo, uint32_t hi);
+    void     collect(uint32_t n, size_t from, size_t to, std::vector<MarkerId> &out);
+    void     check(MarkerId id) const;
+};
+
+}  // namespace Text
+
+#endif
@@ -0,0 +1,166 @@
+#pragma once
+#ifndef PACKED_POSITION_HPP
+#define PACKED_POSITION_HPP
+
+#include <text/position.hpp>
+
+#include <compare>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <utils/exception.hpp>
+#include <utils/hash.hpp>
+#include <utils/raise.hpp>
+
+namespace Text {
+
+/**************************************************************
+ * PackedPosition Class: A Position squeezed into one 64-bit word,
+ * for dense arrays of millions of Positions (tokens, search hits,
+ * markers). The row lives in the high 32 bits & the column in the
+ * low 32 bits, so ordering two PackedPositions is a single integer
+ * comparison, & sorting or binary searching them touches 8 bytes
+ * per element instead of 16.
+ *
+ * RANGE: Rows & columns must each be <= `MAX` (2^32 - 1). Within
+ * that range conversion to & from Position is lossless.
+ **************************************************************/
+class PackedPosition
+{
+    uint64_t bits = (uint64_t(1) << 32) | 1;  /// @private (1, 1)
+
+  public:
+    static constexpr uint64_t MAX = UINT32_MAX;
+
+    constexpr PackedPosition() noexcept = default;
+    constexpr PackedPosition(uint32_t rowNum, uint32_t colNum) noexcept;
+    explicit PackedPosition(const Position &pos);
+
+    static constexpr PackedPosition fromBits(uint64_t bits) noexcept;
+
+    constexpr uint64_t toBits() const noexcept;
+    constexpr uint32_t getRow() const noexcept;
+    constexpr uint32_t getCol() const noexcept;
+    Position           toPosition() const noexcept;
+
+    friend constexpr bool operator == (PackedPosition, PackedPosition) noexcept = default;
+    friend constexpr auto operator <=> (PackedPosition, PackedPosition) noexcept = default;
+};
+
+
+
+
+
+
+/****************************************************************
+ * Construct a PackedPosition from a row & column number.
+ ****************************************************************/
+inline constexpr PackedPosition::PackedPosition(uint32_t rowNum, uint32_t colNum) noexcept
+: bits((uint64_t(rowNum) << 32) | colNum)
+{}
+
+
+
+
+
+
+/****************************************************************
+ * Pack a Position.
+ * @throws <Exception> OUT_OF_RANGE if the row or column of `pos`
+ *   is greater than `PackedPosition::MAX`.
+ ****************************************************************/
+inline PackedPosition::PackedPosition(const Position &pos)
+{
+    const size_t row = pos.getRow().get();
+    const size_t col = pos.getCol().get();
+
+    if (row > MAX || col > MAX) {
+        raise_error(generate_out_of_range_exception(
+          "Position ({}, {}) cannot be packed into 64 bits.", row, col));
+    }
+
+    bits = (uint64_t(row) << 32) | uint64_t(col);
+}
+
+
+
+
+
+
+/****************************************************************
+ * Rebuild a PackedPosition from the word returned by `toBits()`.
+ ****************************************************************/
+inline constexpr PackedPosition PackedPosition::fromBits(uint64_t bits) noexcept
+{
+    PackedPosition pos;
+    pos.bits = bits;
+    return pos;
+}
+
+
+
+
+
+
+/****************************************************************
+ * @returns <uint64_t> The packed word: `row << 32 | col`.
+ ****************************************************************/
+inline constexpr uint64_t PackedPosition::toBits() const noexcept { return bits; }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <uint32_t> The row number.
+ ****************************************************************/
+inline constexpr uint32_t PackedPosition::getRow() const noexcept
+{ return uint32_t(bits >> 32); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <uint32_t> The column number.
+ ****************************************************************/
+inline constexpr uint32_t PackedPosition::getCol() const noexcept
+{ return uint32_t(bits); }
+
+
+
+
+
+
+/****************************************************************
+ * Unpack into a Position. Always lossless.
+ ****************************************************************/
+inline Position PackedPosition::toPosition() const noexcept
+{ return Position::unchecked(getRow(), getCol()); }
+
+
+
+
+static_assert(sizeof(PackedPosition) == sizeof(uint64_t));
+static_assert(std::is_trivially_copyable_v<PackedPosition>);
+
+}  // namespace Text
+
+
+
+
+/****************************************************************
+ * std::hash for PackedPositions. Mixing is a bijection on the
+ * packed word, so distinct PackedPositions never collide before
+ * the table reduces the hash to a bucket.
+ ****************************************************************/
+template <>
+struct std::hash<Text::PackedPosition>
+{
+    size_t operator () (Text::PackedPosition pos) const noexcept
+    { return size_t(Text_Buffer::hash_mix(pos.toBits())); }
+};
+
+#endif
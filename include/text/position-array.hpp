@@ -0,0 +1,621 @@
+#pragma once
+#ifndef POSITION_ARRAY_HPP
+#define POSITION_ARRAY_HPP
+
+#include <text/position.hpp>
+#include <text/shift-kernels.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <utils/exception.hpp>
+#include <utils/raise.hpp>
+#include <vector>
+
+namespace Text {
+
+/**************************************************************
+ * PositionArray Class: A structure-of-arrays container of
+ * Positions. Rows & columns are kept in two separate contiguous
+ * arrays, so searches & bulk edits stream through one array of
+ * plain integers instead of striding over Coordinate pairs.
+ *
+ *  - `sort()` is an LSD radix sort that skips byte passes in
+ *    which every key has the same digit.
+ *  - `lowerBound()` & friends expect a sorted array. They binary
+ *    search down to a block of `SCAN_BLOCK` elements & finish
+ *    with a branch-free counting loop the compiler vectorises.
+ *  - `shiftRows()` & `shiftCols()` apply an edit's delta to every
+ *    Position at or after the edit in a single pass.
+ *
+ * Elements are exposed through `reference` proxies (& by value as
+ * `BasicPosition<Int>` from a const array, whose `const_iterator`
+ * yields Positions), so code written against Position keeps
+ * working.
+ **************************************************************/
+template <std::unsigned_integral Int = size_t>
+class PositionArray
+{
+    std::vector<Int> rowData;
+    std::vector<Int> colData;
+
+  public:
+    using position_type = BasicPosition<Int>;
+    using signed_type   = std::make_signed_t<Int>;
+
+    static constexpr size_t SCAN_BLOCK = 32;
+
+    class reference;
+    class iterator;
+    class const_iterator;
+
+    PositionArray() = default;
+
+    // CAPACITY
+    size_t size() const noexcept { return rowData.size(); }
+    bool   empty() const noexcept { return rowData.empty(); }
+    void   reserve(size_t count);
+    void   clear() noexcept;
+
+    // ELEMENT ACCESS
+    void          push_back(const position_type &pos);
+    void          push_back(Int rowNum, Int colNum);
+    reference     operator [] (size_t i) noexcept { return reference(*this, i); }
+    position_type operator [] (size_t i) const noexcept;
+    position_type at(size_t i) const;
+
+    std::span<const Int> rows() const noexcept { return rowData; }
+    std::span<const Int> cols() const noexcept { return colData; }
+
+    iterator       begin() noexcept { return iterator(this, 0); }
+    iterator       end() noexcept { return iterator(this, size()); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // ORDERING & SEARCH (sorted arrays only)
+    bool   isSorted() const noexcept;
+    void   sort();
+    size_t lowerBound(const position_type &pos) const noexcept;
+    size_t upperBound(const position_type &pos) const noexcept;
+
+    std::pair<size_t, size_t> range(const position_type &from, const position_type &to)
+      const noexcept;
+    std::pair<size_t, size_t> rowRange(Int first, Int last) const noexcept;
+
+    // BULK EDITS
+    void shiftRows(Int fromRow, signed_type delta);
+    void shiftCols(Int row, Int fromCol, signed_type delta);
+
+  private:
+    static size_t lowerBound(const Int *data, size_t begin, size_t end, Int key) noexcept;
+    static bool   radixPass(
+        const std::vector<Int> &keys,
+        size_t                  shift,
+        std::vector<Int>       &rowsOut,
+        std::vector<Int>       &colsOut,
+        const std::vector<Int> &rowsIn,
+        const std::vector<Int> &colsIn);
+};
+
+
+
+
+
+
+/**************************************************************
+ * PositionArray::reference: Proxy for one element. Reads like a
+ * Position & can be assigned a Position; `swap()` exchanges the
+ * elements two proxies refer to, so `std::sort` & other
+ * algorithms that swap through iterators work on the array.
+ **************************************************************/
+template <std::unsigned_integral Int>
+class PositionArray<Int>::reference
+{
+    PositionArray *array;
+    size_t         index;
+
+  public:
+    reference(PositionArray &owner, size_t i) noexcept
+    : array(&owner)
+    , index(i)
+    {}
+
+    BasicCoordinate<Int> getRow() const noexcept
+    { return BasicCoordinate<Int, Unchecked>(array->rowData[index]); }
+
+    BasicCoordinate<Int> getCol() const noexcept
+    { return BasicCoordinate<Int, Unchecked>(array->colData[index]); }
+
+    operator position_type () const noexcept
+    { return position_type::unchecked(array->rowData[index], array->colData[index]); }
+
+    reference &operator = (const position_type &pos) noexcept
+    {
+        array->rowData[index] = pos.getRow().get();
+        array->colData[index] = pos.getCol().get();
+        return *this;
+    }
+
+    reference &operator = (const reference &other) noexcept
+    { return *this = position_type(other); }
+
+    friend void swap(reference lhs, reference rhs) noexcept { lhs.swapWith(rhs); }
+
+    friend bool operator == (const reference &lhs, const position_type &rhs) noexcept
+    { return position_type(lhs) == rhs; }
+
+    friend std::strong_ordering operator <=> (const reference &lhs, const position_type &rhs)
+      noexcept
+    { return position_type(lhs) <=> rhs; }
+
+  private:
+    void swapWith(const reference &other) const noexcept
+    {
+        std::swap(array->rowData[index], other.array->rowData[other.index]);
+        std::swap(array->colData[index], other.array->colData[other.index]);
+    }
+};
+
+
+
+
+
+
+/**************************************************************
+ * PositionArray::iterator: Random access iterator yielding
+ * `reference` proxies.
+ **************************************************************/
+template <std::unsigned_integral Int>
+class PositionArray<Int>::iterator
+{
+    PositionArray *array = nullptr;
+    size_t         index = 0;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = position_type;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = typename PositionArray::reference;
+
+    iterator() = default;
+    iterator(PositionArray *owner, size_t i) noexcept
+    : array(owner)
+    , index(i)
+    {}
+
+    reference operator * () const noexcept { return reference(*array, index); }
+    reference operator [] (difference_type n) const noexcept
+    { return reference(*array, size_t(difference_type(index) + n)); }
+
+    iterator &operator ++ () noexcept { ++index; return *this; }
+    iterator &operator -- () noexcept { --index; return *this; }
+    iterator  operator ++ (int) noexcept { auto it = *this; ++index; return it; }
+    iterator  operator -- (int) noexcept { auto it = *this; --index; return it; }
+
+    iterator &operator += (difference_type n) noexcept
+    { index = size_t(difference_type(index) + n); return *this; }
+    iterator &operator -= (difference_type n) noexcept { return *this += -n; }
+
+    friend iterator operator + (iterator it, difference_type n) noexcept { return it += n; }
+    friend iterator operator + (difference_type n, iterator it) noexcept { return it += n; }
+    friend iterator operator - (iterator it, difference_type n) noexcept { return it -= n; }
+    friend difference_type operator - (const iterator &a, const iterator &b) noexcept
+    { return difference_type(a.index) - difference_type(b.index); }
+
+    friend bool operator == (const iterator &a, const iterator &b) noexcept
+    { return a.index == b.index; }
+    friend auto operator <=> (const iterator &a, const iterator &b) noexcept
+    { return a.index <=> b.index; }
+};
+
+
+
+
+
+
+/**************************************************************
+ * PositionArray::const_iterator: Random access iterator over a
+ * const array, yielding each element by value as a Position.
+ **************************************************************/
+template <std::unsigned_integral Int>
+class PositionArray<Int>::const_iterator
+{
+    const PositionArray *array = nullptr;
+    size_t               index = 0;
+
+  public:
+    using iterator_concept  = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;  // Yields values, not references
+    using value_type        = position_type;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = position_type;
+
+    const_iterator() = default;
+    const_iterator(const PositionArray *owner, size_t i) noexcept
+    : array(owner)
+    , index(i)
+    {}
+
+    position_type operator * () const noexcept
+    { return position_type::unchecked(array->rowData[index], array->colData[index]); }
+
+    position_type operator [] (difference_type n) const noexcept
+    { return *(*this + n); }
+
+    const_iterator &operator ++ () noexcept { ++index; return *this; }
+    const_iterator &operator -- () noexcept { --index; return *this; }
+    const_iterator  operator ++ (int) noexcept { auto it = *this; ++index; return it; }
+    const_iterator  operator -- (int) noexcept { auto it = *this; --index; return it; }
+
+    const_iterator &operator += (difference_type n) noexcept
+    { index = size_t(difference_type(index) + n); return *this; }
+    const_iterator &operator -= (difference_type n) noexcept { return *this += -n; }
+
+    friend const_iterator operator + (const_iterator it, difference_type n) noexcept
+    { return it += n; }
+    friend const_iterator operator + (difference_type n, const_iterator it) noexcept
+    { return it += n; }
+    friend const_iterator operator - (const_iterator it, difference_type n) noexcept
+    { return it -= n; }
+    friend difference_type operator - (const const_iterator &a, const const_iterator &b)
+      noexcept
+    { return difference_type(a.index) - difference_type(b.index); }
+
+    friend bool operator == (const const_iterator &a, const const_iterator &b) noexcept
+    { return a.index == b.index; }
+    friend auto operator <=> (const const_iterator &a, const const_iterator &b) noexcept
+    { return a.index <=> b.index; }
+};
+
+
+
+
+
+
+/****************************************************************
+ * Reserve room for `count` Positions in both arrays.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline void PositionArray<Int>::reserve(size_t count)
+{
+    rowData.reserve(count);
+    colData.reserve(count);
+}
+
+
+
+
+
+
+/****************************************************************
+ * Remove every Position.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline void PositionArray<Int>::clear() noexcept
+{
+    rowData.clear();
+    colData.clear();
+}
+
+
+
+
+
+
+/****************************************************************
+ * Append a Position.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline void PositionArray<Int>::push_back(const position_type &pos)
+{ push_back(pos.getRow().get(), pos.getCol().get()); }
+
+
+
+
+
+
+/****************************************************************
+ * Append a Position given as a row & column number.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline void PositionArray<Int>::push_back(Int rowNum, Int colNum)
+{
+    rowData.push_back(rowNum);
+    colData.push_back(colNum);
+}
+
+
+
+
+
+
+/****************************************************************
+ * @returns <BasicPosition<Int>> A copy of the element at `i`.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline typename PositionArray<Int>::position_type PositionArray<Int>::operator [] (
+  size_t i) const noexcept
+{ return position_type::unchecked(rowData[i], colData[i]); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <BasicPosition<Int>> A copy of the element at `i`.
+ * @throws <Exception> OUT_OF_RANGE if `i >= size()`.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline typename PositionArray<Int>::position_type PositionArray<Int>::at(size_t i) const
+{
+    if (i >= size()) {
+        raise_error(generate_out_of_range_exception(
+          "Index {} is outside of the PositionArray's {} elements.", i, size()));
+    }
+
+    return (*this)[i];
+}
+
+
+
+
+
+
+/****************************************************************
+ * @returns <bool> true if the Positions are in ascending order.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline bool PositionArray<Int>::isSorted() const noexcept
+{
+    for (size_t i = 1; i < size(); ++i) {
+        if (rowData[i] < rowData[i - 1]) { return false; }
+        if (rowData[i] == rowData[i - 1] && colData[i] < colData[i - 1]) { return false; }
+    }
+
+    return true;
+}
+
+
+
+
+
+
+/****************************************************************
+ * Sort the Positions in ascending (row, col) order with a stable
+ * LSD radix sort: one byte pass per byte of the column, then of
+ * the row. Passes in which every element has the same digit,
+ * typically the high bytes, are skipped without copying, & the
+ * scratch arrays are only allocated by the first pass that runs.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline void PositionArray<Int>::sort()
+{
+    if (size() < 2) { return; }
+
+    std::vector<Int> rowsTmp;
+    std::vector<Int> colsTmp;
+
+    for (const bool byRow : { false, true }) {
+        for (size_t shift = 0; shift < sizeof(Int) * 8; shift += 8) {
+            const auto &keys = byRow ? rowData : colData;
+            if (!radixPass(keys, shift, rowsTmp, colsTmp, rowData, colData)) { continue; }
+
+            rowData.swap(rowsTmp);
+            colData.swap(colsTmp);
+        }
+    }
+}
+
+
+
+
+
+
+/****************************************************************
+ * @returns <size_t> Index of the first Position that is not less
+ *   than `pos`, or `size()`. The array must be sorted.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline size_t PositionArray<Int>::lowerBound(const position_type &pos) const noexcept
+{
+    const Int row = pos.getRow().get();
+    const Int col = pos.getCol().get();
+
+    const size_t first = lowerBound(rowData.data(), 0, size(), row);
+    const size_t last  = row == std::numeric_limits<Int>::max()
+                         ? size()
+                         : lowerBound(rowData.data(), first, size(), Int(row + 1));
+
+    return lowerBound(colData.data(), first, last, col);
+}
+
+
+
+
+
+
+/****************************************************************
+ * @returns <size_t> Index of the first Position greater than `pos`,
+ *   or `size()`. The array must be sorted.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline size_t PositionArray<Int>::upperBound(const position_type &pos) const noexcept
+{
+    const Int col = pos.getCol().get();
+
+    if (col == std::numeric_limits<Int>::max()) {
+        const Int row = pos.getRow().get();
+        if (row == std::numeric_limits<Int>::max()) { return size(); }
+        return lowerBound(rowData.data(), 0, size(), Int(row + 1));
+    }
+
+    return lowerBound(position_type::unchecked(pos.getRow().get(), Int(col + 1)));
+}
+
+
+
+
+
+
+/****************************************************************
+ * @returns <std::pair<size_t, size_t>> Index range [first, last) of
+ *   the Positions p with `from <= p <= to`. Must be sorted.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline std::pair<size_t, size_t> PositionArray<Int>::range(
+  const position_type &from,
+  const position_type &to) const noexcept
+{
+    const size_t first = lowerBound(from);
+    return { first, std::max(first, upperBound(to)) };
+}
+
+
+
+
+
+
+/****************************************************************
+ * @returns <std::pair<size_t, size_t>> Index range [first, last) of
+ *   the Positions on rows `first` through `last`. Must be sorted.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline std::pair<size_t, size_t> PositionArray<Int>::rowRange(Int first, Int last)
+  const noexcept
+{
+    const size_t begin = lowerBound(rowData.data(), 0, size(), first);
+    const size_t end   = last == std::numeric_limits<Int>::max()
+                         ? size()
+                         : lowerBound(rowData.data(), begin, size(), Int(last + 1));
+
+    return { begin, std::max(begin, end) };
+}
+
+
+
+
+
+
+/****************************************************************
+ * Add `delta` to the row of every Position whose row is at least
+ * `fromRow`, e.g. after lines were inserted before `fromRow`.
+ * Sorted arrays stay sorted as long as no row crosses `fromRow`.
+ * @throws <X_> INVALID_NUMBER_SIGN if a row would drop below 0, or
+ *   SEG_FAULT_INT_MAX if one would exceed the maximum; either way no
+ *   row is changed.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline void PositionArray<Int>::shiftRows(Int fromRow, signed_type delta)
+{
+    shiftFrom(std::span<Int>(rowData), fromRow, delta);
+}
+
+
+
+
+
+
+/****************************************************************
+ * Add `delta` to the column of every Position on `row` whose column
+ * is at least `fromCol`, e.g. after text was inserted on that row.
+ * @throws <X_> INVALID_NUMBER_SIGN if a column would drop below 0,
+ *   or SEG_FAULT_INT_MAX if one would exceed the maximum; either way
+ *   no column is changed.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline void PositionArray<Int>::shiftCols(Int row, Int fromCol, signed_type delta)
+{
+    shiftWhere(std::span<Int>(colData), std::span<const Int>(rowData), row, fromCol, delta);
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * First index in [begin, end) of the sorted `data` whose value is
+ * not less than `key`. Halves the window without branching until
+ * it is `SCAN_BLOCK` wide, then counts the smaller elements of the
+ * block in a loop that is vectorised by the compiler.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline size_t PositionArray<Int>::lowerBound(
+  const Int *data,
+  size_t     begin,
+  size_t     end,
+  Int        key) noexcept
+{
+    size_t base = begin;
+    size_t n    = end - begin;
+
+    while (n > SCAN_BLOCK) {
+        const size_t half = n / 2;
+        base += (data[base + half - 1] < key) ? half : 0;
+        n -= half;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) { count += size_t(data[base + i] < key); }
+
+    return base + count;
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * One stable counting pass of the radix sort on the byte of `keys`
+ * at bit `shift`, sizing the outputs to the input.
+ * @returns <bool> false, with nothing written, when every element
+ *   shares the same digit & the pass would not move any.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline bool PositionArray<Int>::radixPass(
+  const std::vector<Int> &keys,
+  size_t                  shift,
+  std::vector<Int>       &rowsOut,
+  std::vector<Int>       &colsOut,
+  const std::vector<Int> &rowsIn,
+  const std::vector<Int> &colsIn)
+{
+    std::array<size_t, 256> counts{};
+    for (const Int key : keys) { ++counts[(key >> shift) & 0xFF]; }
+
+    if (counts[(keys[0] >> shift) & 0xFF] == keys.size()) { return false; }
+
+    rowsOut.resize(keys.size());
+    colsOut.resize(keys.size());
+
+    size_t total = 0;
+    for (size_t &count : counts) { total += std::exchange(count, total); }
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const size_t at = counts[(keys[i] >> shift) & 0xFF]++;
+        rowsOut[at]     = rowsIn[i];
+        colsOut[at]     = colsIn[i];
+    }
+
+    return true;
+}
+
+
+using PositionArray32 = PositionArray<uint32_t>;
+
+}  // namespace Text
+
+#endif
@@ -0,0 +1,511 @@
+#pragma once
+#ifndef POSITION_MAP_HPP
+#define POSITION_MAP_HPP
+
+#include <text/packed-position.hpp>
+#include <text/position.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <utility>
+#include <utils/exception.hpp>
+#include <utils/hash.hpp>
+#include <utils/raise.hpp>
+#include <vector>
+
+namespace Text {
+
+/**************************************************************
+ * PositionMap Class: An open-addressing hash map keyed by text
+ * positions, e.g. (row, col) → symbol or diagnostic.
+ *
+ * Keys are stored as 64-bit PackedPositions in their own array,
+ * apart from the values, so a lookup hashes one word (`hash_mix`,
+ * a bijection, so distinct keys only collide in the bucket index)
+ * & probes linearly through consecutive keys without touching any
+ * value or following any pointer. The table holds at most 3/4 of
+ * its power-of-two slot count; erasing shifts the following
+ * entries back instead of leaving tombstones.
+ *
+ * Position keys must fit a PackedPosition (row & col <= 2^32 - 1),
+ * & the key (2^32 - 1, 2^32 - 1) is reserved to mark empty slots.
+ **************************************************************/
+template <typename T>
+class PositionMap
+{
+    static constexpr uint64_t EMPTY     = ~uint64_t(0);
+    static constexpr size_t   MIN_SLOTS = 16;
+    static constexpr size_t   MAX_SLOTS = ~(SIZE_MAX >> 1);  /// Largest power of two
+
+    std::vector<uint64_t> keys;               /// Slot → packed key, or EMPTY
+    T                    *values = nullptr;   /// Live where the key is not EMPTY
+    size_t                count  = 0;
+
+  public:
+    using key_type    = PackedPosition;
+    using mapped_type = T;
+
+    PositionMap() = default;
+    explicit PositionMap(size_t expected) { reserve(expected); }
+    PositionMap(const PositionMap &other);
+    PositionMap(PositionMap &&other) noexcept;
+    ~PositionMap();
+
+    PositionMap &operator = (PositionMap other) noexcept;
+
+    size_t size() const noexcept { return count; }
+    bool   empty() const noexcept { return count == 0; }
+    size_t slots() const noexcept { return keys.size(); }
+    void   reserve(size_t expected);
+    void   clear() noexcept;
+
+    bool     insert(PackedPosition key, T value);
+    bool     insert(const Position &key, T value);
+    T       &operator [] (PackedPosition key);
+    T       &operator [] (const Position &key) { return (*this)[PackedPosition(key)]; }
+    T       *find(PackedPosition key) noexcept;
+    T       *find(const Position &key) noexcept;
+    const T *find(PackedPosition key) const noexcept;
+    const T *find(const Position &key) const noexcept;
+    bool     contains(PackedPosition key) const noexcept { return find(key) != nullptr; }
+    bool     contains(const Position &key) const noexcept { return find(key) != nullptr; }
+    bool     erase(PackedPosition key);
+    bool     erase(const Position &key);
+
+    template <typename Fn>
+    void forEach(Fn &&fn);
+
+    friend void swap(PositionMap &lhs, PositionMap &rhs) noexcept
+    {
+        lhs.keys.swap(rhs.keys);
+        std::swap(lhs.values, rhs.values);
+        std::swap(lhs.count, rhs.count);
+    }
+
+  private:
+    size_t        mask() const noexcept { return keys.size() - 1; }
+    size_t        home(uint64_t bits) const noexcept;
+    size_t        slotOf(uint64_t bits) const noexcept;
+    size_t        claim(uint64_t bits);
+    void          publish(size_t slot, uint64_t bits) noexcept;
+    void          rehash(size_t newSlots);
+    void          destroy() noexcept;
+    static bool   pack(const Position &pos, uint64_t &bits) noexcept;
+};
+
+
+
+
+
+
+/****************************************************************
+ * Copy every entry of `other`. Each key is published only once its
+ * value is built, so if a copy throws, the destructor (which runs,
+ * as the delegated constructor completed) frees just those.
+ ****************************************************************/
+template <typename T>
+inline PositionMap<T>::PositionMap(const PositionMap &other)
+: PositionMap()
+{
+    if (other.keys.empty()) { return; }
+
+    keys.assign(other.keys.size(), EMPTY);
+    values = std::allocator<T>().allocate(keys.size());
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (other.keys[i] == EMPTY) { continue; }
+
+        std::construct_at(values + i, other.values[i]);
+        keys[i] = other.keys[i];
+        ++count;
+    }
+}
+
+
+
+
+
+
+/****************************************************************
+ * Take the entries of `other`, leaving it empty.
+ ****************************************************************/
+template <typename T>
+inline PositionMap<T>::PositionMap(PositionMap &&other) noexcept
+: keys(std::move(other.keys))
+, values(std::exchange(other.values, nullptr))
+, count(std::exchange(other.count, 0))
+{ other.keys.clear(); }
+
+
+
+
+
+
+template <typename T>
+inline PositionMap<T>::~PositionMap()
+{ destroy(); }
+
+
+
+
+
+
+/****************************************************************
+ * Copy- & move-assignment (copy-and-swap).
+ ****************************************************************/
+template <typename T>
+inline PositionMap<T> &PositionMap<T>::operator = (PositionMap other) noexcept
+{
+    swap(*this, other);
+    return *this;
+}
+
+
+
+
+
+
+/****************************************************************
+ * Make room for `expected` entries without rehashing.
+ * @throws <Exception> OUT_OF_RANGE if no power of two slot count
+ *   fits `expected` entries in a size_t.
+ ****************************************************************/
+template <typename T>
+inline void PositionMap<T>::reserve(size_t expected)
+{
+    if (expected > MAX_SLOTS / 4 * 3) {
+        raise_error(generate_out_of_range_exception(
+          "A PositionMap cannot hold {} entries.", expected));
+    }
+
+    size_t needed = MIN_SLOTS;
+    while (needed / 4 * 3 < expected) { needed *= 2; }
+
+    if (needed > keys.size()) { rehash(needed); }
+}
+
+
+
+
+
+
+/****************************************************************
+ * Remove every entry; the slots stay allocated.
+ ****************************************************************/
+template <typename T>
+inline void PositionMap<T>::clear() noexcept
+{
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] != EMPTY) {
+            std::destroy_at(values + i);
+            keys[i] = EMPTY;
+        }
+    }
+
+    count = 0;
+}
+
+
+
+
+
+
+/****************************************************************
+ * Insert `value` under `key` unless the key is already present.
+ * @returns <bool> true if the entry was inserted.
+ * @throws <Exception> OUT_OF_RANGE for the reserved key.
+ ****************************************************************/
+template <typename T>
+inline bool PositionMap<T>::insert(PackedPosition key, T value)
+{
+    const uint64_t bits = key.toBits();
+    const size_t   slot = claim(bits);
+
+    if (keys[slot] != EMPTY) { return false; }
+
+    std::construct_at(values + slot, std::move(value));
+    publish(slot, bits);
+    return true;
+}
+
+
+
+
+
+
+template <typename T>
+inline bool PositionMap<T>::insert(const Position &key, T value)
+{ return insert(PackedPosition(key), std::move(value)); }
+
+
+
+
+
+
+/****************************************************************
+ * @returns <T &> The value under `key`, default-constructing it if
+ *   the key is not present yet.
+ * @throws <Exception> OUT_OF_RANGE for the reserved key.
+ ****************************************************************/
+template <typename T>
+inline T &PositionMap<T>::operator [] (PackedPosition key)
+{
+    const uint64_t bits = key.toBits();
+    const size_t   slot = claim(bits);
+
+    if (keys[slot] == EMPTY) {
+        std::construct_at(values + slot);
+        publish(slot, bits);
+    }
+
+    return values[slot];
+}
+
+
+
+
+
+
+/****************************************************************
+ * @returns <T *> The value under `key`, or nullptr.
+ ****************************************************************/
+template <typename T>
+inline T *PositionMap<T>::find(PackedPosition key) noexcept
+{
+    if (count == 0) { return nullptr; }
+
+    const size_t slot = slotOf(key.toBits());
+    return keys[slot] == EMPTY ? nullptr : values + slot;
+}
+
+
+template <typename T>
+inline const T *PositionMap<T>::find(PackedPosition key) const noexcept
+{ return const_cast<PositionMap *>(this)->find(key); }
+
+
+template <typename T>
+inline T *PositionMap<T>::find(const Position &key) noexcept
+{
+    uint64_t bits;
+    return pack(key, bits) ? find(PackedPosition::fromBits(bits)) : nullptr;
+}
+
+
+template <typename T>
+inline const T *PositionMap<T>::find(const Position &key) const noexcept
+{ return const_cast<PositionMap *>(this)->find(key); }
+
+
+
+
+
+
+/****************************************************************
+ * Remove the entry under `key`, shifting later entries of its
+ * probe run back into the hole.
+ * @returns <bool> true if an entry was removed.
+ ****************************************************************/
+template <typename T>
+inline bool PositionMap<T>::erase(PackedPosition key)
+{
+    if (count == 0) { return false; }
+
+    size_t hole = slotOf(key.toBits());
+    if (keys[hole] == EMPTY) { return false; }
+
+    std::destroy_at(values + hole);
+
+    for (size_t next = (hole + 1) & mask(); keys[next] != EMPTY; next = (next + 1) & mask()) {
+        const size_t want = home(keys[next]);
+
+        // The entry may fill the hole if the hole lies on its probe path.
+        if (((next - want) & mask()) >= ((next - hole) & mask())) {
+            keys[hole] = keys[next];
+            std::construct_at(values + hole, std::move(values[next]));
+            std::destroy_at(values + next);
+            hole = next;
+        }
+    }
+
+    keys[hole] = EMPTY;
+    --count;
+    return true;
+}
+
+
+template <typename T>
+inline bool PositionMap<T>::erase(const Position &key)
+{
+    uint64_t bits;
+    return pack(key, bits) && erase(PackedPosition::fromBits(bits));
+}
+
+
+
+
+
+
+/****************************************************************
+ * Call `fn(PackedPosition, T &)` for every entry, in slot order.
+ ****************************************************************/
+template <typename T>
+template <typename Fn>
+inline void PositionMap<T>::forEach(Fn &&fn)
+{
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] != EMPTY) { fn(PackedPosition::fromBits(keys[i]), values[i]); }
+    }
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * @returns <size_t> The slot a key's probe run starts at.
+ ****************************************************************/
+template <typename T>
+inline size_t PositionMap<T>::home(uint64_t bits) const noexcept
+{ return size_t(Text_Buffer::hash_mix(bits)) & mask(); }
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * @returns <size_t> The slot holding `bits`, or the empty slot that
+ *   ends its probe run. The table must have slots.
+ ****************************************************************/
+template <typename T>
+inline size_t PositionMap<T>::slotOf(uint64_t bits) const noexcept
+{
+    size_t slot = home(bits);
+    while (keys[slot] != bits && keys[slot] != EMPTY) { slot = (slot + 1) & mask(); }
+    return slot;
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Find the slot of `bits`, growing the table first so a new key
+ * fits. A new key's slot is returned still EMPTY: the caller
+ * constructs its value, then publishes it, so a throwing
+ * constructor leaves no key without a value.
+ * @throws <Exception> OUT_OF_RANGE for the reserved key.
+ ****************************************************************/
+template <typename T>
+inline size_t PositionMap<T>::claim(uint64_t bits)
+{
+    if (bits == EMPTY) {
+        raise_error(generate_out_of_range_exception(
+          "The position ({}, {}) is reserved by PositionMap.", UINT32_MAX, UINT32_MAX));
+    }
+
+    if ((count + 1) * 4 > keys.size() * 3) {
+        rehash(keys.empty() ? MIN_SLOTS : keys.size() * 2);
+    }
+
+    return slotOf(bits);
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Occupy (& count) the slot whose value was just constructed.
+ ****************************************************************/
+template <typename T>
+inline void PositionMap<T>::publish(size_t slot, uint64_t bits) noexcept
+{
+    keys[slot] = bits;
+    ++count;
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Move every entry into a table of `newSlots` (a power of two).
+ ****************************************************************/
+template <typename T>
+inline void PositionMap<T>::rehash(size_t newSlots)
+{
+    PositionMap next;
+    next.keys.assign(newSlots, EMPTY);
+    next.values = std::allocator<T>().allocate(newSlots);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] == EMPTY) { continue; }
+
+        const size_t slot = next.slotOf(keys[i]);
+        std::construct_at(next.values + slot, std::move(values[i]));
+        next.publish(slot, keys[i]);
+    }
+
+    swap(*this, next);
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Destroy every value & release the slots.
+ ****************************************************************/
+template <typename T>
+inline void PositionMap<T>::destroy() noexcept
+{
+    if (values == nullptr) { return; }
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] != EMPTY) { std::destroy_at(values + i); }
+    }
+
+    std::allocator<T>().deallocate(values, keys.size());
+    values = nullptr;
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Pack a Position without throwing.
+ * @returns <bool> false if it does not fit a PackedPosition.
+ ****************************************************************/
+template <typename T>
+inline bool PositionMap<T>::pack(const Position &pos, uint64_t &bits) noexcept
+{
+    const size_t row = pos.getRow().get();
+    const size_t col = pos.getCol().get();
+
+    if (row > PackedPosition::MAX || col > PackedPosition::MAX) { return false; }
+
+    bits = PackedPosition(uint32_t(row), uint32_t(col)).toBits();
+    return true;
+}
+
+}  // namespace Text
+
+#endif
@@ -4,56 +4,103 @@
 
 #include <text/coordinate.hpp>
 
+#include <compare>
 #include <concepts>
+#include <cstdint>
+#include <functional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 #include <utils/err.hpp>
+#include <utils/hash.hpp>
 
 namespace Text {
 
 
-struct Coordinates
+template <std::unsigned_integral Int = size_t>
+struct BasicCoordinates
 {
-    const Coordinate row;
-    const Coordinate col;
+    const BasicCoordinate<Int> row;
+    const BasicCoordinate<Int> col;
 };
 
 
 
-class Position
+/**************************************************************
+ * Position Class: A Row-Column pair of Coordinates. `Int` is the
+ * `size_type` of both Coordinates; `Position` uses `size_t`, while
+ * `Position32` stores two 32-bit Coordinates (8 bytes instead of
+ * 16) & range checks the `size_t` values it is built from.
+ *
+ * The members are defined in position.cpp, which instantiates
+ * `BasicPosition` for `size_t` & `uint32_t`.
+ **************************************************************/
+template <std::unsigned_integral Int = size_t>
+class BasicPosition
 {
-    Coordinate row;  /// @private
-    Coordinate col;  /// @private
+    BasicCoordinate<Int> row;  /// @private
+    BasicCoordinate<Int> col;  /// @private
 
   public:
-    Position();
-    Position(size_t rowNum);
-    Position(size_t rowNum, size_t colNum);
-    Position(Position &) noexcept  = default;               /// Copy Ctor
-    Position(Position &&) noexcept = default;               /// Move Ctors
+    using size_type = Int;
 
-    Position &operator = (const Position &)     = default;  /// Copy Assignment Ops
-    Position &operator = (Position &&) noexcept = default;  /// Move Assignment Op
+    BasicPosition();
+    BasicPosition(size_t rowNum);
+    BasicPosition(size_t rowNum, size_t colNum);
+    BasicPosition(const BasicPosition &) noexcept = default;  /// Copy Ctor
+    BasicPosition(BasicPosition &&) noexcept      = default;  /// Move Ctors
 
-    Coordinates getCoordinates() noexcept;
-    Coordinate  getRow() noexcept;
-    Coordinate  getCol() noexcept;
+    static BasicPosition unchecked(Int rowNum, Int colNum) noexcept;
+
+    BasicPosition &operator = (const BasicPosition &)     = default;  /// Copy Assignment Ops
+    BasicPosition &operator = (BasicPosition &&) noexcept = default;  /// Move Assignment Op
+
+    BasicCoordinates<Int> getCoordinates() const noexcept;
+    BasicCoordinate<Int>  getRow() const noexcept;
+    BasicCoordinate<Int>  getCol() const noexcept;
 
     void setPosition(size_t rowNum, size_t colNum);
     void setRow(size_t rowNum);
     void setCol(size_t colNum);
 
-    Position &operator ++ () noexcept;
-    Position &operator ++ (int) noexcept;
-    Position &operator -- () noexcept;
-    Position &operator -- (int) noexcept;
+    static void shiftRows(
+      std::span<BasicPosition> positions, Int fromRow, std::make_signed_t<Int> delta);
+    static void shiftCols(
+      std::span<BasicPosition> positions, Int row, Int fromCol, std::make_signed_t<Int> delta);
+
+    BasicPosition &operator ++ () noexcept;
+    BasicPosition &operator ++ (int) noexcept;
+    BasicPosition &operator -- () noexcept;
+    BasicPosition &operator -- (int) noexcept;
+
+    bool                 operator == (const BasicPosition &rhs) const noexcept;
+    std::strong_ordering operator <=> (const BasicPosition &rhs) const noexcept;
+};
+
+
+using Coordinates = BasicCoordinates<size_t>;
+using Position    = BasicPosition<size_t>;
+using Position32  = BasicPosition<uint32_t>;
+
+extern template class BasicPosition<size_t>;
+extern template class BasicPosition<uint32_t>;
 
-    friend bool operator == (const Position &lhs, const Position &rhs) noexcept;
-    friend std::strong_ordering operator <=> (const Position &lhs, const Position &rhs)
-      noexcept;
 };
 
+
+
+
+/****************************************************************
+ * std::hash for Positions, e.g. as `std::unordered_map` keys. For
+ * dense position-keyed tables see `Text::PositionMap`.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+struct std::hash<Text::BasicPosition<Int>>
+{
+    size_t operator () (const Text::BasicPosition<Int> &pos) const noexcept
+    { return Text_Buffer::hash_pair(pos.getRow().get(), pos.getCol().get()); }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,215 @@
+#pragma once
+#ifndef SHIFT_KERNELS_HPP
+#define SHIFT_KERNELS_HPP
+
+#include <text/coordinate.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace Text {
+
+/**************************************************************
+ * Shift Kernels: Batch updates of stored coordinates after an
+ * edit, e.g. every row after an insertion of k lines grows by k,
+ * every column after a line split shrinks.
+ *
+ * Each kernel adds a signed `delta` to every value that is at
+ * least `threshold` in one branch-free pass over a contiguous
+ * array, which the compiler vectorises. Errors are reported with
+ * the Coordinate's semantics:
+ *
+ *  - INVALID_NUMBER_SIGN (X_) if a value would become negative.
+ *    Only possible when `threshold < -delta`, so the extra read-only
+ *    scan that detects it runs only then.
+ *  - SEG_FAULT_INT_MAX (X_) if a value would exceed `MAX`. Possible
+ *    for any positive delta, so a read-only scan (itself branch-free
+ *    & vectorised) precedes every growing shift.
+ *
+ * Both are detected before anything is written, so a shift that
+ * raises leaves every value as it was.
+ **************************************************************/
+template <std::unsigned_integral Int>
+using ShiftDelta = std::make_signed_t<Int>;
+
+
+
+
+/****************************************************************
+ * @private
+ * @returns <Int> The magnitude of a negative delta, or 0.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline constexpr Int shiftUnderflowLimit(ShiftDelta<Int> delta) noexcept
+{ return delta < 0 ? Int(Int(0) - Int(delta)) : Int(0); }
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * Raise the shift errors described above.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+[[noreturn]] inline void raiseShiftUnderflow(Int value, ShiftDelta<Int> delta)
+{
+    raise_error(X_(
+      ERR_ID::INVALID_NUMBER_SIGN,
+      "Shifting the Coordinate {} by {} would make it negative.",
+      value,
+      delta));
+}
+
+
+template <std::unsigned_integral Int>
+[[noreturn]] inline void raiseShiftOverflow(ShiftDelta<Int> delta)
+{
+    raise_error(X_(
+      ERR_ID::SEG_FAULT_INT_MAX,
+      "Shifting Coordinates by {} would exceed the largest Coordinate.",
+      delta));
+}
+
+
+
+
+
+
+/****************************************************************
+ * @private
+ * The kernel behind every shift: add `delta` to `get(elems[i])`
+ * wherever it is at least `threshold` & `select(i)` holds, storing
+ * the result with `set(elems[i], value)`.
+ ****************************************************************/
+template <std::unsigned_integral Int, typename Elem, typename Get, typename Set, typename Select>
+inline void shiftKernel(
+  std::span<Elem> elems,
+  Int             threshold,
+  ShiftDelta<Int> delta,
+  Get           &&get,
+  Set           &&set,
+  Select        &&select)
+{
+    const Int limit = shiftUnderflowLimit<Int>(delta);
+
+    if (threshold < limit) {
+        for (size_t i = 0; i < elems.size(); ++i) {
+            const Int value = get(elems[i]);
+            if (select(i) && value >= threshold && value < limit) {
+                raiseShiftUnderflow(value, delta);
+            }
+        }
+    }
+
+    const Int step = Int(delta);
+
+    if (delta > 0) {
+        const Int ceiling  = Int(std::numeric_limits<Int>::max() - step);
+        Int       overflow = 0;  // Not a bool: keeps the reduction vectorisable
+
+        for (size_t i = 0, n = elems.size(); i < n; ++i) {
+            const Int value = get(elems[i]);
+            overflow |= Int(select(i) & (value >= threshold) & (value > ceiling));
+        }
+
+        if (overflow) { raiseShiftOverflow<Int>(delta); }
+    }
+
+    for (size_t i = 0, n = elems.size(); i < n; ++i) {
+        const Int  value    = get(elems[i]);
+        const bool selected = select(i) & (value >= threshold);
+
+        set(elems[i], Int(value + Int(selected) * step));
+    }
+}
+
+
+
+
+
+
+/****************************************************************
+ * Add `delta` to every value that is at least `threshold`.
+ * @throws <X_> see Shift Kernels.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline void shiftFrom(std::span<Int> values, Int threshold, ShiftDelta<Int> delta)
+{
+    shiftKernel(
+      values,
+      threshold,
+      delta,
+      [](Int value) { return value; },
+      [](Int &value, Int shifted) { value = shifted; },
+      [](size_t) { return true; });
+}
+
+
+
+
+
+
+/****************************************************************
+ * Add `delta` to every `values[i]` that is at least `threshold` &
+ * whose `keys[i]` equals `key`, e.g. the columns after a split
+ * point on one row of a structure-of-arrays position index.
+ * @throws <X_> see Shift Kernels; OUT_OF_RANGE (Exception) if
+ *   `keys` is shorter than `values`.
+ ****************************************************************/
+template <std::unsigned_integral Int>
+inline void shiftWhere(
+  std::span<Int>       values,
+  std::span<const Int> keys,
+  Int                  key,
+  Int                  threshold,
+  ShiftDelta<Int>      delta)
+{
+    if (keys.size() < values.size()) {
+        raise_error(generate_out_of_range_exception(
+          "{} keys were given for {} shifted values.", keys.size(), values.size()));
+    }
+
+    const Int *keyData = keys.data();
+
+    shiftKernel(
+      values,
+      threshold,
+      delta,
+      [](Int value) { return value; },
+      [](Int &value, Int shifted) { value = shifted; },
+      [keyData, key](size_t i) { return keyData[i] == key; });
+}
+
+
+
+
+
+
+/****************************************************************
+ * Add `delta` to every Coordinate that is at least `threshold`.
+ * @throws <X_> see Shift Kernels.
+ ****************************************************************/
+template <std::unsigned_integral I, CheckPolicy P>
+inline void shiftFrom(
+  std::span<BasicCoordinate<I, P>> coords,
+  BasicCoordinate<I, P>            threshold,
+  ShiftDelta<I>                    delta)
+{
+    using Coord = BasicCoordinate<I, P>;
+
+    shiftKernel(
+      coords,
+      threshold.get(),
+      delta,
+      [](const Coord &coord) { return coord.get(); },
+      [](Coord &coord, I shifted) { coord = Coord::narrow(shifted); },
+      [](size_t) { return true; });
+}
+
+}  // namespace Text
+
+#endif
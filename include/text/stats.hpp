@@ -0,0 +1,183 @@
+#pragma once
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Text {
+
+/**************************************************************
+ * HOT-PATH COUNTERS
+ *
+ * Buffers & their trees count the work they do in a block owned
+ * by the calling thread, which `Text::stats()` sums across every
+ * thread, live or finished. Only the owning thread writes its
+ * block, so an increment is an uncontended relaxed load & store;
+ * no lock & no read-modify-write instruction is involved.
+ *
+ * Mutations (edits, index rebuilds, tree operations) are also
+ * counted on the object, for `Buffer::stats()`. Const queries
+ * (UTF-16 cache hits & misses, the bytes they scan) count on the
+ * thread only, so readers sharing a Buffer never write to it.
+ *
+ * Defining `TEXT_BUFFER_NO_STATS` (CMake option of the same
+ * name) compiles every counter out; the snapshots are then zero.
+ **************************************************************/
+#if defined(TEXT_BUFFER_NO_STATS)
+#    define TEXT_BUFFER_STATS 0
+#else
+#    define TEXT_BUFFER_STATS 1
+#endif
+
+
+enum class Stat : uint8_t
+{
+    BYTES_SCANNED,   /// Bytes read by newline & UTF-8 scans
+    INDEX_REBUILDS,  /// Full rebuilds of the line index
+    EDITS_APPLIED,   /// Calls to `Buffer::replace()` & its wrappers
+    TREE_SPLITS,     /// Split operations of the marker & decoration trees
+    TREE_MERGES,     /// Merge operations of the marker & decoration trees
+    CACHE_HITS,      /// UTF-16 column caches found built
+    CACHE_MISSES,    /// UTF-16 column caches built on demand
+    ALLOCATIONS      /// Edits & rebuilds that reallocated the text or line index
+};
+
+inline constexpr size_t STAT_COUNT = 8;
+
+
+
+
+inline constexpr std::string_view statName(Stat stat) noexcept
+{
+    switch (stat) {
+        case Stat::BYTES_SCANNED: return "bytes_scanned";
+        case Stat::INDEX_REBUILDS: return "index_rebuilds";
+        case Stat::EDITS_APPLIED: return "edits_applied";
+        case Stat::TREE_SPLITS: return "tree_splits";
+        case Stat::TREE_MERGES: return "tree_merges";
+        case Stat::CACHE_HITS: return "cache_hits";
+        case Stat::CACHE_MISSES: return "cache_misses";
+        case Stat::ALLOCATIONS: return "allocations";
+    }
+    return "unknown";
+}
+
+
+
+
+/**************************************************************
+ * Stats: A snapshot of the counters. Subtract two snapshots to
+ * get the work done between them.
+ **************************************************************/
+struct Stats
+{
+    std::array<uint64_t, STAT_COUNT> values{};
+
+    uint64_t operator [] (Stat stat) const noexcept { return values[size_t(stat)]; }
+
+    Stats &operator += (const Stats &rhs) noexcept
+    {
+        for (size_t i = 0; i < STAT_COUNT; ++i) { values[i] += rhs.values[i]; }
+        return *this;
+    }
+
+    friend Stats operator - (Stats lhs, const Stats &rhs) noexcept
+    {
+        for (size_t i = 0; i < STAT_COUNT; ++i) { lhs.values[i] -= rhs.values[i]; }
+        return lhs;
+    }
+};
+
+
+Stats stats();
+Stats threadStats();
+
+
+
+
+#if TEXT_BUFFER_STATS
+
+/**************************************************************
+ * @private
+ * The counters of one thread. Registered on the thread's first
+ * increment; folded into the process total when it exits. The
+ * registry links the blocks through `prev` & `next`, so
+ * registering never allocates.
+ **************************************************************/
+struct ThreadStats
+{
+    std::array<std::atomic<uint64_t>, STAT_COUNT> values{};
+    ThreadStats                                  *prev = nullptr;
+    ThreadStats                                  *next = nullptr;
+
+    ThreadStats() noexcept;
+    ~ThreadStats();
+
+    void add(Stat stat, uint64_t n) noexcept
+    {
+        auto &value = values[size_t(stat)];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+
+inline thread_local ThreadStats thread_stats;
+
+#endif
+
+
+
+
+/**************************************************************
+ * Count `n` on the calling thread only. Used by const queries.
+ **************************************************************/
+inline void thread_count([[maybe_unused]] Stat stat, [[maybe_unused]] uint64_t n = 1) noexcept
+{
+#if TEXT_BUFFER_STATS
+    thread_stats.add(stat, n);
+#endif
+}
+
+
+
+
+/**************************************************************
+ * StatCounters: The counters embedded in a counted object. Each
+ * increment also goes to the calling thread's block.
+ *
+ * Only mutating paths add to them, so like the rest of the object
+ * they are written by one thread at a time; const queries use
+ * `thread_count()` instead.
+ **************************************************************/
+class StatCounters
+{
+#if TEXT_BUFFER_STATS
+    std::array<uint64_t, STAT_COUNT> counts{};
+#endif
+
+  public:
+    void add([[maybe_unused]] Stat stat, [[maybe_unused]] uint64_t n = 1) noexcept
+    {
+#if TEXT_BUFFER_STATS
+        counts[size_t(stat)] += n;
+        thread_stats.add(stat, n);
+#endif
+    }
+
+    Stats snapshot() const noexcept
+    {
+        Stats snap;
+#if TEXT_BUFFER_STATS
+        snap.values = counts;
+#endif
+        return snap;
+    }
+};
+
+}  // namespace Text
+
+#endif
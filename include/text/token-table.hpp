@@ -0,0 +1,100 @@
+#pragma once
+#ifndef TOKEN_TABLE_HPP
+#define TOKEN_TABLE_HPP
+
+#include <text/lexer.hpp>
+#include <text/position.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Text {
+
+class Buffer;
+
+
+/**************************************************************
+ * LineToken: A token stored in the row it starts in, by byte
+ * column (zero-based) & length. A token may run into later rows.
+ **************************************************************/
+struct LineToken
+{
+    TokenKind kind   = 0;
+    uint32_t  column = 0;
+    uint32_t  length = 0;
+};
+
+
+
+
+/**************************************************************
+ * TokenTable Class: The tokens of a Buffer by row, kept current
+ * across edits by re-lexing only the rows an edit can change.
+ *
+ * Each row records its lexer state: how many of its first bytes
+ * belong to a token (kept or skipped) that started in an earlier
+ * row, e.g. the inside of a block comment. Lexing a row needs
+ * nothing but that state & the text, so after an edit `update()`
+ *
+ *  1. restarts at the first row whose state the edit could change,
+ *     i.e. whose carried-in token ends within `lookahead()` bytes
+ *     of the edit,
+ *  2. re-lexes rows until one past the edit has the state its old
+ *     counterpart had, after which every old row is still valid,
+ *  3. splices the new rows in place of the old ones.
+ *
+ * Tokens store columns relative to their row & rows are implied by
+ * their index, so the tokens after the converged row are never
+ * revisited: an edit keeping the line count costs only the rows
+ * re-lexed, & one changing it also moves the later rows' entries,
+ * as the Buffer moves its line index.
+ *
+ * The Lexicon must outlive the table. Texts must be smaller than
+ * 4 GiB.
+ **************************************************************/
+class TokenTable
+{
+    struct Line
+    {
+        size_t                 state = 0;  /// Bytes carried in from earlier rows
+        std::vector<LineToken> tokens;
+    };
+
+    const Lexicon    *lexicon;
+    std::vector<Line> lines;
+    size_t            bytes      = 0;  /// Size of the text the table describes
+    size_t            count      = 0;  /// Tokens over all rows
+    size_t            relexFirst = 1;  /// First row the last update re-lexed
+    size_t            relexRows  = 0;  /// Rows the last update re-lexed
+
+  public:
+    static constexpr size_t MAX_BYTES = std::numeric_limits<uint32_t>::max() - 1;  /// Largest text
+
+    TokenTable(const Buffer &buffer, const Lexicon &rules);
+
+    size_t update(const Buffer &buffer, size_t offset, size_t removed, size_t inserted);
+
+    size_t lineCount() const noexcept { return lines.size(); }
+    size_t tokenCount() const noexcept { return count; }
+    size_t memoryUsage() const noexcept;
+    void   shrinkToFit();
+
+    // First row (1-based) & number of rows the last update re-lexed.
+    std::pair<size_t, size_t> relexed() const noexcept { return { relexFirst, relexRows }; }
+
+    std::span<const LineToken> tokensIn(size_t row) const;
+    size_t                     lineState(size_t row) const;
+    Token                      token(const Buffer &buffer, size_t row, size_t index) const;
+
+  private:
+    const Line &at(size_t row) const;
+    size_t      lexRow(const Buffer &buffer, size_t row0, size_t pos, Line &line) const;
+};
+
+}  // namespace Text
+
+#endif
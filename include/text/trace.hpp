@@ -0,0 +1,142 @@
+#pragma once
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Text {
+
+/**************************************************************
+ * TRACE SPANS
+ *
+ * A TraceSpan times the scope it lives in. While tracing is on
+ * (`setTracing(true)`) every finished span is appended to a ring
+ * buffer owned by its thread, which keeps the latest
+ * TRACE_CAPACITY spans; `traceJson()` collects the rings of all
+ * threads as Chrome trace-event JSON, which chrome://tracing &
+ * Perfetto load directly. The spans of threads that have exited
+ * are kept too, up to the latest TRACE_RETIRED_CAPACITY of them.
+ *
+ * While tracing is off a span costs one relaxed load & a branch.
+ * Defining `TEXT_BUFFER_NO_TRACE` (CMake option of the same name)
+ * removes spans entirely.
+ *
+ * Span names must outlive the trace, i.e. be string literals.
+ **************************************************************/
+#if defined(TEXT_BUFFER_NO_TRACE)
+#    define TEXT_BUFFER_TRACE 0
+#else
+#    define TEXT_BUFFER_TRACE 1
+#endif
+
+
+inline constexpr size_t TRACE_CAPACITY         = 4096;  /// Spans kept per thread
+inline constexpr size_t TRACE_RETIRED_CAPACITY = 4 * TRACE_CAPACITY;  /// Of exited threads
+
+
+struct TraceEvent
+{
+    const char *name     = nullptr;
+    uint64_t    start    = 0;  /// Nanoseconds since the first traced span
+    uint64_t    duration = 0;  /// Nanoseconds
+    uint64_t    bytes    = 0;  /// Bytes the span processed, 0 if not applicable
+};
+
+
+void        setTracing(bool on) noexcept;
+bool        tracing() noexcept;
+std::string traceJson();
+void        clearTrace();
+
+
+
+
+#if TEXT_BUFFER_TRACE
+
+inline std::atomic<bool> trace_enabled = false;
+
+
+uint64_t trace_clock() noexcept;
+
+
+/**************************************************************
+ * @private
+ * The span ring of one thread. Registered on the thread's first
+ * span; its spans are kept for the trace when the thread exits.
+ * The lock is only contended while a trace is being collected.
+ *
+ * Rings are built by the first span's noexcept destructor & torn
+ * down at thread exit, so neither step allocates in a way that can
+ * throw: slots come from nothrow `new` (spans are dropped if that
+ * fails), the registry links the rings through `older` & `newer`
+ * instead of storing them, & exiting rings merge into storage the
+ * registry allocated up front.
+ **************************************************************/
+struct TraceRing
+{
+    std::mutex                    lock;
+    std::unique_ptr<TraceEvent[]> events;     /// TRACE_CAPACITY slots, or null
+    size_t                        size = 0;   /// Slots in use
+    size_t                        next = 0;   /// Oldest event once the ring is full
+    uint32_t                      tid  = 0;
+    TraceRing                    *older = nullptr;
+    TraceRing                    *newer = nullptr;
+
+    TraceRing() noexcept;
+    ~TraceRing() noexcept;
+
+    void record(const TraceEvent &event) noexcept;
+};
+
+
+inline thread_local TraceRing trace_ring;
+
+#endif
+
+
+
+
+/**************************************************************
+ * TraceSpan: Records the time from its construction to its
+ * destruction as one span, if tracing was on when it started.
+ **************************************************************/
+class TraceSpan
+{
+#if TEXT_BUFFER_TRACE
+    const char *name  = nullptr;
+    uint64_t    start = 0;
+    uint64_t    bytes = 0;
+#endif
+
+  public:
+    explicit TraceSpan(
+      [[maybe_unused]] const char *spanName, [[maybe_unused]] uint64_t spanBytes = 0) noexcept
+    {
+#if TEXT_BUFFER_TRACE
+        if (trace_enabled.load(std::memory_order_relaxed)) {
+            name  = spanName;
+            bytes = spanBytes;
+            start = trace_clock();
+        }
+#endif
+    }
+
+    TraceSpan(const TraceSpan &)             = delete;
+    TraceSpan &operator = (const TraceSpan &) = delete;
+
+    ~TraceSpan()
+    {
+#if TEXT_BUFFER_TRACE
+        if (name != nullptr) { trace_ring.record({ name, start, trace_clock() - start, bytes }); }
+#endif
+    }
+};
+
+}  // namespace Text
+
+#endif
@@ -0,0 +1,191 @@
+#pragma once
+#ifndef ERR_ARG_HPP
+#define ERR_ARG_HPP
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <mutex>
+#include <source_location>
+#include <string>
+
+
+namespace Text_Buffer {
+
+/****************************************************************
+ * @private
+ * ErrArg: One raw argument of a deferred error message, either an
+ * integer or a short text such as an operator. Stored without
+ * allocating so that building an error costs nothing until its
+ * report is read. Texts are copied in, never pointed to, so an
+ * error may outlive the array it was built from.
+ ****************************************************************/
+class ErrArg
+{
+    enum class Kind : uint8_t { NONE, SIGNED, UNSIGNED, TEXT };
+
+    Kind kind = Kind::NONE;
+    union
+    {
+        long long          s;
+        unsigned long long u = 0;
+        char               text[sizeof(u)];
+    };
+
+  public:
+    static constexpr size_t MAX = 5;  /// Arguments a deferred message can hold
+
+    constexpr ErrArg() noexcept {}
+
+    template <std::signed_integral T>
+    constexpr ErrArg(T num) noexcept
+    : kind(Kind::SIGNED)
+    , s(num)
+    {}
+
+    template <std::unsigned_integral T>
+    constexpr ErrArg(T num) noexcept
+    : kind(Kind::UNSIGNED)
+    , u(num)
+    {}
+
+    template <size_t N>
+        requires (N <= sizeof(unsigned long long))
+    constexpr ErrArg(const char (&chars)[N]) noexcept
+    : kind(Kind::TEXT)
+    , text{}
+    {
+        for (size_t i = 0; i < N; ++i) { text[i] = chars[i]; }
+    }
+
+    std::string str() const
+    {
+        switch (kind) {
+            case Kind::SIGNED   : return std::to_string(s);
+            case Kind::UNSIGNED : return std::to_string(u);
+            case Kind::TEXT     : return { text, std::find(text, std::end(text), '\0') };
+            case Kind::NONE     : break;
+        }
+
+        return "";
+    }
+};
+
+
+using ErrArgs = std::array<ErrArg, ErrArg::MAX>;
+
+
+
+
+/****************************************************************
+ * @private
+ * Called by an ErrPattern holding a format spec, which makes the
+ * pattern fail to compile with this name in the error.
+ ****************************************************************/
+inline void deferred_patterns_take_no_format_specs() {}
+
+
+
+
+/****************************************************************
+ * @private
+ * ErrPattern: The `std::format` pattern of a deferred error
+ * message. Must be a string literal; it also records where the
+ * error was raised, since a default argument cannot follow the
+ * argument pack of a deferred constructor.
+ *
+ * Every argument is formatted as a string, so replacement fields
+ * are `{}` or `{n}` only; a spec such as `{:x}` would make the
+ * report fail & is rejected at compile time instead.
+ ****************************************************************/
+struct ErrPattern
+{
+    const char          *text;
+    std::source_location loc;
+
+    template <size_t N>
+    consteval ErrPattern(
+      const char (&literal)[N],
+      std::source_location loc = std::source_location::current()) noexcept
+    : text(literal)
+    , loc(loc)
+    {
+        for (size_t i = 0; i < N; ++i) {
+            if (literal[i] != '{') { continue; }
+            if (i + 1 < N && literal[i + 1] == '{') {
+                ++i;
+                continue;
+            }
+
+            do { ++i; } while (i < N && '0' <= literal[i] && literal[i] <= '9');
+            if (i == N || literal[i] != '}') { deferred_patterns_take_no_format_specs(); }
+        }
+    }
+};
+
+
+
+
+/****************************************************************
+ * @private
+ * @returns <std::string> `pattern` formatted with `args`; unused
+ *   trailing arguments are empty.
+ ****************************************************************/
+inline std::string format_deferred(const char *pattern, const ErrArgs &args)
+{
+    const std::string a0 = args[0].str(), a1 = args[1].str(), a2 = args[2].str();
+    const std::string a3 = args[3].str(), a4 = args[4].str();
+    return std::vformat(pattern, std::make_format_args(a0, a1, a2, a3, a4));
+}
+
+
+
+
+/****************************************************************
+ * @private
+ * LazyReport: The report of an error, built by the first `what()`
+ * under `std::call_once`, so threads reading the same caught error
+ * build it once & see the same text. If building it fails (out of
+ * memory), `what()` returns a static message instead.
+ *
+ * A copy starts without a report & builds its own when asked.
+ ****************************************************************/
+class LazyReport
+{
+    mutable std::once_flag built;
+    mutable std::string    text;
+
+  public:
+    static constexpr const char *FALLBACK
+      = "Text-Buffer error (the error report could not be built)";
+
+    LazyReport() = default;
+    LazyReport(const LazyReport &) noexcept {}
+    LazyReport &operator=(const LazyReport &) = delete;
+
+    template <typename F>
+    const char *get(const F &build) const noexcept
+    {
+        std::call_once(built, [&]() noexcept {
+#ifdef __cpp_exceptions
+            try {
+                text = build();
+            }
+            catch (...) {
+                text.clear();
+            }
+#else
+            text = build();
+#endif
+        });
+
+        return text.empty() ? FALLBACK : text.c_str();
+    }
+};
+
+}  // namespace Text_Buffer
+
+#endif
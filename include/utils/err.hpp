@@ -1,5 +1,10 @@
 #pragma once
 
+#include "utils/err-arg.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstdint>
 #include <exception>
 #include <format>
 #include <iostream>
@@ -8,6 +13,7 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 
@@ -106,39 +112,84 @@ inline std::vector<std::string> split_on_space(
 
 
 
+/****************************************************************
+ * X_ Class: Error thrown by the Coordinate class.
+ *
+ * Constructing an X_ only records the error id, the source
+ * location & the message (or, for the deferred constructor, a
+ * literal pattern & up to `MAX_ARGS` raw arguments). The coloured
+ * report is built by the first call to `what()` & cached, so code
+ * that throws & catches without printing never pays for it.
+ ****************************************************************/
 class X_ : public std::exception
 {
   public:
-    static constexpr const std::string BRK = "\n\t  ";
+    static constexpr const std::string BRK     = "\n\t  ";
+    static constexpr size_t            MAX_ARGS = ErrArg::MAX;
 
   private:
-    ERR_ID               id;
-    std::source_location loc;
-    std::string          message;
+    ERR_ID                        id;
+    std::source_location          loc;
+    std::string                   message;
+    const char                   *pattern = nullptr;
+    ErrArgs                       args{};
+    LazyReport                    report;
 
   public:
     inline X_(
       const ERR_ID        &id,
-      const std::string   &msg,
+      std::string          msg,
       std::source_location loc = std::source_location::current())
     : id(id)
     , loc(loc)
-    , message(formatMesg(msg))
+    , message(std::move(msg))
+    {}
+
+
+    /****************************************************************
+     * Deferred constructor: `pattern` is only formatted with `args`
+     * once the report is requested.
+     ****************************************************************/
+    template <typename... A>
+        requires (sizeof...(A) >= 1 && sizeof...(A) <= MAX_ARGS)
+    inline X_(ERR_ID id, ErrPattern pattern, const A &...args) noexcept
+    : id(id)
+    , loc(pattern.loc)
+    , pattern(pattern.text)
+    , args{ ErrArg(args)... }
     {}
 
 
 
 
+    inline ERR_ID getId() const noexcept { return id; }
+
+
+
+
+    /****************************************************************
+     * The report is built once, even when several threads ask for it;
+     * if that fails, a static message is returned instead.
+     ****************************************************************/
     inline const char *what() const noexcept override
+    { return report.get([this] { return formatMesg(getMessage()); }); }
+
+
+
+
+    /****************************************************************
+     * @returns <std::string> The plain message, without the report
+     *   around it.
+     ****************************************************************/
+    std::string getMessage() const
     {
-        std::string msg = std::format("{}", message);
-        return message.c_str();
+        return pattern == nullptr ? message : format_deferred(pattern, args);
     }
 
 
 
 
-    std::string formatMesg(std::string msg)
+    std::string formatMesg(std::string msg) const
     {
         std::string e_id    = to_string(id);
         std::string func    = loc.function_name();
@@ -215,10 +266,11 @@ struct GenErr
      * @param rhs Right-hand side value.
      * @returns Ex object for illegal negative operation.
      ****************************************************************/
-    template <Integral T>
-    inline static X_ coord_op_neg(const std::string &oper, T lhs, T rhs) noexcept
+    template <size_t N, Integral T>
+    inline static X_ coord_op_neg(const char (&oper)[N], T lhs, T rhs) noexcept
     {
-        std::string msg = std::format(
+        return X_(
+          ERR_ID::INVALID_NUMBER_SIGN,
           "ILLEGAL OPERATION:  '{} {} {}'  (one of the values is a Coordinate). The "
           "operation is illegal because it results in a negative value; because "
           "Coordinates have an unsigned internal value, the cannot be assigned a value"
@@ -226,8 +278,6 @@ struct GenErr
           lhs,
           oper,
           rhs);
-
-        return X_(ERR_ID::INVALID_NUMBER_SIGN, msg);
     }
 
 
@@ -236,13 +286,12 @@ struct GenErr
      * @private
      * Division by Zero Exception
      * @brief Generate an exception for division by zero errors.
+     * @param lhs The value that was divided.
      * @returns Ex object for division by zero error.
      * */
-    inline static X_ division_by_zero() noexcept
-    {
-        std::string msg = std::format("Attempted to divide a value by zero");
-        return X_(ERR_ID::DIVISION_BY_ZERO, msg);
-    }
+    template <Integral T>
+    inline static X_ division_by_zero(T lhs) noexcept
+    { return X_(ERR_ID::DIVISION_BY_ZERO, "Attempted to divide {} by zero", lhs); }
 };
 
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "utils/err-arg.hpp"
+
 #include <array>
+#include <concepts>
 #include <cstring>
 #include <format>
 #include <iostream>
@@ -8,6 +11,8 @@
 #include <source_location>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 
@@ -108,11 +113,61 @@ inline std::vector<std::string> wrap_text(
 
 
 
+/*************************************************************************
+ * @private
+ * @brief The CAUSE & SUGGESTED FIX texts of an ERROR_ID: the defaults of
+ *   the generators' `cause` & `fix` parameters, & what deferred
+ *   exceptions, which take no cause or fix, report.
+ * @param id The ERROR_ID of the exception.
+ * @return A static string (possibly empty).
+ *************************************************************************/
+inline std::string_view default_cause(ERROR_ID id) noexcept
+{
+    switch (id) {
+        case ERROR_ID::DIVISION_BY_ZERO :
+            return "Division by zero is undefined and cannot be performed.";
+        default : return "";
+    }
+}
+
+
+inline std::string_view default_fix(ERROR_ID id) noexcept
+{
+    switch (id) {
+        case ERROR_ID::NEGATIVE_NUMBER :
+            return "Remove any operations that are resulting in negative values where "
+                   "negative numbers arn't allowed. Check types, make sure you understand "
+                   "what entities have signed & unsigned numeric types. Validate any "
+                   "dynamic inputs to ensure they are non-negative when used where "
+                   "negative numbers are not allowed.";
+        case ERROR_ID::DIVISION_BY_ZERO :
+            return "Remove any division operations where the denominator is zero."
+                   "and validate any dynamic inputs to ensure they are non-zero before "
+                   "performing division.";
+        default : return "";
+    }
+}
+
+
+
+
+
+
 /*************************************************************************
  * @class X_EXCEPTION_X
  * @brief Custom exception class for handling errors in the Text_Buffer
  *   library. Inherits from std::exception and provides detailed error
  *   messages including source location information.
+ *
+ *   Construction only stores the id, the source location & the raw
+ *   message, cause & fix (or, for the deferred constructor, a literal
+ *   pattern & its raw integer arguments). The diagnostic report is
+ *   formatted by the first call to what() & cached, so exceptions
+ *   that are caught without being printed stay cheap to throw. The
+ *   message, cause & fix are read with getMessage(), getCause() &
+ *   getFix(), as a deferred message only exists once formatted; they
+ *   replace the public `message`, `cause` & `fix` fields of earlier
+ *   releases (see "Error reports" in the README).
  ************************************************************************/
 class Exception : public std::exception
 {
@@ -120,14 +175,11 @@ class Exception : public std::exception
     using src_loc = std::source_location;
 
   public:
-    const std::string ESC  = "\033[0m";
-    const std::string RED  = "\033[38;2;130;45;60m";
-    const std::string DARK = "\033[38;2;115;115;115m";
+    static constexpr std::string_view ESC  = "\033[0m";
+    static constexpr std::string_view RED  = "\033[38;2;130;45;60m";
+    static constexpr std::string_view DARK = "\033[38;2;115;115;115m";
 
-    ERROR_ID    id      = ERROR_ID::UNKNOWN;
-    std::string message = "";
-    std::string cause   = "";
-    std::string fix     = "";
+    ERROR_ID id = ERROR_ID::UNKNOWN;
 
     // Source location details
     std::source_location loc      = std::source_location::current();
@@ -136,6 +188,14 @@ class Exception : public std::exception
     const size_t         line     = 0;
     const size_t         column   = 0;
 
+  private:
+    std::string message = "";
+    std::string cause   = "";
+    std::string fix     = "";
+    const char *pattern = nullptr;
+    ErrArgs     args{};
+    LazyReport  report;
+
 
   public:
     Exception(
@@ -145,39 +205,79 @@ class Exception : public std::exception
       std::string          fix     = "",
       std::source_location loc     = std::source_location::current())
     : id(id)
-    , message(message)
-    , cause(cause)
-    , fix(fix)
     , loc(loc)
     , file(loc.file_name())
     , function(loc.function_name())
     , line(loc.line())
     , column(loc.column())
-    { this->message = format_error_message(); }
+    , message(std::move(message))
+    , cause(std::move(cause))
+    , fix(std::move(fix))
+    {}
+
+
+    /*************************************************************************
+     * @brief Deferred constructor: `pattern` is only formatted with `args`
+     *   once the report is requested, so raising formats nothing. The
+     *   cause & fix are the defaults of `id`.
+     *************************************************************************/
+    template <std::integral... A>
+        requires (sizeof...(A) >= 1 && sizeof...(A) <= ErrArg::MAX)
+    Exception(ERROR_ID id, ErrPattern pattern, const A &...args) noexcept
+    : id(id)
+    , loc(pattern.loc)
+    , file(pattern.loc.file_name())
+    , function(pattern.loc.function_name())
+    , line(pattern.loc.line())
+    , column(pattern.loc.column())
+    , pattern(pattern.text)
+    , args{ ErrArg(args)... }
+    {}
 
 
 
 
     /*************************************************************************
      * @brief Overrides the what() method from std::exception to provide
-     *   a detailed error message.
+     *   a detailed error message. The message is built once, on the first
+     *   call from any thread; if building it fails, a static message is
+     *   returned instead.
      * @return A C-style string containing the formatted error message.
      ************************************************************************/
-    const char *what() const noexcept override { return message.c_str(); }
+    const char *what() const noexcept override
+    { return report.get([this] { return format_error_message(); }); }
 
 
 
 
+    /*************************************************************************
+     * @return The plain message, cause & suggested fix, without the report
+     *   around them. Each may be empty.
+     ************************************************************************/
+    std::string getMessage() const
+    { return pattern == nullptr ? message : format_deferred(pattern, args); }
 
-    std::string format_err_id()
+
+    std::string getCause() const
+    { return pattern == nullptr ? cause : std::string(default_cause(id)); }
+
+
+    std::string getFix() const
+    { return pattern == nullptr ? fix : std::string(default_fix(id)); }
+
+
+
+
+
+    std::string format_err_id() const
     {
-        std::string fmt_error_id = format(
+        std::string fmt_error_id = std::format(
           "{}ERROR IDENTITY: {}{} (#{})", RED, to_string(id), ESC, get_error_code(id));
         return fmt_error_id;
     }
 
 
-    std::string format_location()
+    std::string format_location() const
     {
         constexpr std::string_view FMT
           = "{}SOURCE LOCATION:{}\n"
@@ -205,42 +305,31 @@ class Exception : public std::exception
     }
 
 
-    std::string format_messages()
+    static std::string wrap_message(std::string_view text)
     {
-        if (cause.length() > 70) {
-            std::string formatted_message;
-            for (std::string ln : wrap_text(cause, 70)) {
-                formatted_message += ("\n  " + ln);
-            }
-            cause = formatted_message;
-        }
+        if (text.length() <= 70) { return std::string(text); }
 
-        if (fix.length() > 70) {
-            std::string formatted_message;
-            for (auto ln : wrap_text(fix, 70)) {
-                formatted_message += ("\n  " + ln);
-            }
-            fix = formatted_message;
+        std::string formatted_message;
+        for (const std::string &ln : wrap_text(std::string(text), 70)) {
+            formatted_message += ("\n  " + ln);
         }
 
-        if (message.length() > 70) {
-            std::string formatted_message;
-            for (auto ln : wrap_text(message, 70)) {
-                formatted_message += ("\n  " + ln);
-            }
-            message = formatted_message;
-        }
+        return formatted_message;
+    }
 
-        std::string unified
-          = std::format("{}MESSAGE:{} {}{}{}\n\n", DARK, ESC, RED, message, ESC);
 
-        unified += !cause.empty()
-                   ? format("{}CAUSE:{} {}\n\n", DARK, ESC, std::string(cause))
-                   : "";
+    std::string format_messages() const
+    {
+        const std::string msg = wrap_message(getMessage());
+        const std::string why = wrap_message(getCause());
+        const std::string how = wrap_message(getFix());
+
+        std::string unified
+          = std::format("{}MESSAGE:{} {}{}{}\n\n", DARK, ESC, RED, msg, ESC);
 
-        unified += !fix.empty()
-                   ? format("{}SUGGESTED FIX:{} {}\n\n", DARK, ESC, std::string(fix))
-                   : "";
+        unified += !why.empty() ? std::format("{}CAUSE:{} {}\n\n", DARK, ESC, why) : "";
+        unified += !how.empty() ? std::format("{}SUGGESTED FIX:{} {}\n\n", DARK, ESC, how)
+                                : "";
 
         return unified;
     }
@@ -249,12 +338,9 @@ class Exception : public std::exception
     /*************************************************************************
      * @private
      * @brief Formats the complete error message including source location.
-     * @param id The ERROR_ID of the exception.
-     * @param mesg The main error message.
-     * @param loc The source location where the error occurred.
      * @return A formatted string containing the complete error message.
      ************************************************************************/
-    std::string format_error_message()
+    std::string format_error_message() const
     {
 
         constexpr std::string_view FMT
@@ -292,34 +378,60 @@ class Exception : public std::exception
 
 
 inline Exception generate_out_of_range_exception(
-  const std::string   &message,
-  const std::string   &cause = "",
-  const std::string   &fix   = "",
+  std::string          message,
+  std::string          cause = "",
+  std::string          fix   = "",
   std::source_location loc   = std::source_location::current())
-{ return Exception(ERROR_ID::OUT_OF_RANGE, message, cause, fix, loc); }
+{
+    return Exception(
+      ERROR_ID::OUT_OF_RANGE, std::move(message), std::move(cause), std::move(fix), loc);
+}
+
+
+template <std::integral... A>
+    requires (sizeof...(A) >= 1)
+inline Exception generate_out_of_range_exception(
+  ErrPattern pattern,
+  const A &...args) noexcept
+{ return Exception(ERROR_ID::OUT_OF_RANGE, pattern, args...); }
 
 
 
 inline Exception generate_negative_number_exception(
-  const std::string &message,
-  const std::string &cause = "",
-  const std::string &fix
-  = "Remove any operations that are resulting in negative values where negative numbers "
-    "arn't allowed. Check types, make sure you understand what entities have signed & "
-    "unsigned numeric types. Validate any dynamic inputs to ensure they are non-negative "
-    "when used where negative numbers are not allowed.",
-  std::source_location loc = std::source_location::current())
-{ return Exception(ERROR_ID::NEGATIVE_NUMBER, message, cause, fix, loc); }
+  std::string          message,
+  std::string          cause = "",
+  std::string          fix   = std::string(default_fix(ERROR_ID::NEGATIVE_NUMBER)),
+  std::source_location loc   = std::source_location::current())
+{
+    return Exception(
+      ERROR_ID::NEGATIVE_NUMBER, std::move(message), std::move(cause), std::move(fix), loc);
+}
+
+
+template <std::integral... A>
+    requires (sizeof...(A) >= 1)
+inline Exception generate_negative_number_exception(
+  ErrPattern pattern,
+  const A &...args) noexcept
+{ return Exception(ERROR_ID::NEGATIVE_NUMBER, pattern, args...); }
+
+
+inline Exception generate_division_by_zero_exception(
+  std::string          message,
+  std::string          cause = std::string(default_cause(ERROR_ID::DIVISION_BY_ZERO)),
+  std::string          fix   = std::string(default_fix(ERROR_ID::DIVISION_BY_ZERO)),
+  std::source_location loc   = std::source_location::current())
+{
+    return Exception(
+      ERROR_ID::DIVISION_BY_ZERO, std::move(message), std::move(cause), std::move(fix), loc);
+}
 
 
+template <std::integral... A>
+    requires (sizeof...(A) >= 1)
 inline Exception generate_division_by_zero_exception(
-  const std::string &message,
-  const std::string &cause = "Division by zero is undefined and cannot be performed.",
-  const std::string &fix
-  = "Remove any division operations where the denominator is zero."
-    "and validate any dynamic inputs to ensure they are non-zero before performing "
-    "division.",
-  std::source_location loc = std::source_location::current())
-{ return Exception(ERROR_ID::DIVISION_BY_ZERO, message, cause, fix, loc); }
+  ErrPattern pattern,
+  const A &...args) noexcept
+{ return Exception(ERROR_ID::DIVISION_BY_ZERO, pattern, args...); }
 
 }  // namespace Text_Buffer
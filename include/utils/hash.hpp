@@ -0,0 +1,48 @@
+#pragma once
+#ifndef TEXT_BUFFER_HASH_HPP
+#define TEXT_BUFFER_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace Text_Buffer {
+
+/**************************************************************************
+ * @brief Finalising mixer of MurmurHash3 (fmix64). A bijection on 64-bit
+ *   words in which every input bit affects every output bit, so nearby
+ *   rows & columns land in unrelated buckets.
+ * @param x The word to mix.
+ * @return The mixed word.
+ **************************************************************************/
+inline constexpr uint64_t hash_mix(uint64_t x) noexcept
+{
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+
+
+
+/**************************************************************************
+ * @brief Hash a (row, column) pair. Rows & columns below 2^32 are packed
+ *   into one word losslessly; larger values are folded in with a
+ *   multiplicative step first.
+ * @return The hash, truncated to size_t.
+ **************************************************************************/
+inline constexpr size_t hash_pair(uint64_t row, uint64_t col) noexcept
+{
+    const uint64_t packed = (row < (uint64_t(1) << 32) && col < (uint64_t(1) << 32))
+                            ? (row << 32) | col
+                            : (row * 0x9E3779B97F4A7C15ull) ^ col;
+
+    return size_t(hash_mix(packed));
+}
+
+}  // namespace Text_Buffer
+
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+#ifndef RAISE_HPP
+#define RAISE_HPP
+
+#include "utils/err.hpp"
+#include "utils/exception.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+
+namespace Text_Buffer {
+
+/**************************************************************************
+ * ERROR REPORTING MODE
+ *
+ * Every error path of the library goes through `raise_error()`. By
+ * default it throws the error. When `TEXT_BUFFER_NO_EXCEPTIONS` is
+ * defined (CMake option of the same name), or the compiler has
+ * exceptions disabled, it instead passes the error's code & object to
+ * the installed ErrorHandler & aborts if the handler returns.
+ *
+ * Code that must handle errors without unwinding in either mode can
+ * use the non-throwing APIs (e.g. `checked_add()` for Coordinates).
+ **************************************************************************/
+#if defined(TEXT_BUFFER_NO_EXCEPTIONS) || !defined(__cpp_exceptions)
+#    define TEXT_BUFFER_THROWS 0
+#else
+#    define TEXT_BUFFER_THROWS 1
+#endif
+
+
+using ErrorHandler = void (*)(int code, const std::exception &error);
+
+
+
+
+/**************************************************************************
+ * @private
+ * @brief The handler installed when none was set: prints the error report
+ *   to stderr. raise_error() aborts once it returns.
+ **************************************************************************/
+inline void default_error_handler(int, const std::exception &error)
+{ std::fputs(error.what(), stderr); }
+
+
+inline std::atomic<ErrorHandler> error_handler_slot = &default_error_handler;
+
+
+
+
+/**************************************************************************
+ * @brief Install the function called for errors in no-exceptions builds.
+ * @param handler The new handler; nullptr restores the default.
+ * @return The previously installed handler.
+ **************************************************************************/
+inline ErrorHandler set_error_handler(ErrorHandler handler) noexcept
+{ return error_handler_slot.exchange(handler ? handler : &default_error_handler); }
+
+
+inline ErrorHandler get_error_handler() noexcept { return error_handler_slot.load(); }
+
+
+
+
+/**************************************************************************
+ * @private
+ * @brief The numeric code of an error, as passed to the ErrorHandler.
+ **************************************************************************/
+inline int error_code_of(const X_ &error) noexcept
+{ return static_cast<int>(error.getId()); }
+
+
+inline int error_code_of(const Exception &error) noexcept { return get_error_code(error.id); }
+
+
+
+
+/**************************************************************************
+ * @brief Report an error: throw it, or in no-exceptions builds hand it to
+ *   the ErrorHandler & abort.
+ * @param error An X_ or Exception.
+ **************************************************************************/
+template <typename E>
+[[noreturn]] inline constexpr void raise_error(E &&error)
+{
+#if TEXT_BUFFER_THROWS
+    throw std::forward<E>(error);
+#else
+    get_error_handler()(error_code_of(error), error);
+    std::abort();
+#endif
+}
+
+}  // namespace Text_Buffer
+
+#endif
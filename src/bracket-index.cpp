@@ -0,0 +1,638 @@
+#include <text/bracket-index.hpp>
+#include <text/buffer.hpp>
+#include <text/trace.hpp>
+#include <utils/exception.hpp>
+#include <utils/raise.hpp>
+
+#include <algorithm>
+#include <format>
+#include <limits>
+
+using namespace Text_Buffer;
+
+namespace Text {
+
+/**********************************************************************
+ * Start tracking the brackets of `buffer`, replacing any brackets
+ * tracked before.
+ * @param rules The classifying Lexicon; must outlive the tracking.
+ * @param kinds The token kinds of each pair of brackets.
+ * @throws <Exception> OUT_OF_RANGE if there are more than 65536 pairs
+ *   or the text is too large for a TokenTable.
+ **********************************************************************/
+void BracketIndex::track(
+  const Buffer                &buffer,
+  const Lexicon               &rules,
+  std::span<const BracketPair> kinds)
+{
+    if (kinds.size() > size_t(std::numeric_limits<uint16_t>::max()) + 1) {
+        raise_error(generate_out_of_range_exception(
+          "{} bracket pairs are more than the 65536 supported.", kinds.size()));
+    }
+
+    const TraceSpan span("brackets.build", buffer.size());
+
+    clear();
+    tokens.emplace(buffer, rules);
+    pairs.assign(kinds.begin(), kinds.end());
+    root = collect(buffer, 1, tokens->lineCount());
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Stop tracking & forget every bracket.
+ **********************************************************************/
+void BracketIndex::clear() noexcept
+{
+    tokens.reset();
+    pairs.clear();
+    nodes.clear();
+    freeNodes.clear();
+    root  = NIL;
+    count = 0;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Release spare capacity: trailing released nodes are dropped (their
+ * slots are no longer recycled) & the arrays & TokenTable shrunk.
+ **********************************************************************/
+void BracketIndex::shrinkToFit()
+{
+    std::vector<bool> released(nodes.size());
+    for (const uint32_t n : freeNodes) { released[n] = true; }
+    while (!nodes.empty() && released[nodes.size() - 1]) { nodes.pop_back(); }
+
+    const auto limit = uint32_t(nodes.size());
+    std::erase_if(freeNodes, [limit](uint32_t n) { return n >= limit; });
+
+    // Exact-size copies swapped in; see Buffer::shrinkToFit() for why not shrink_to_fit().
+    decltype(pairs)(pairs).swap(pairs);
+    decltype(nodes)(nodes).swap(nodes);
+    decltype(freeNodes)(freeNodes).swap(freeNodes);
+    if (tokens) { tokens->shrinkToFit(); }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> Heap bytes held by the index & its TokenTable.
+ **********************************************************************/
+size_t BracketIndex::memoryUsage() const noexcept
+{
+    return (tokens ? tokens->memoryUsage() : 0) + pairs.capacity() * sizeof(BracketPair)
+         + nodes.capacity() * sizeof(Node) + freeNodes.capacity() * sizeof(uint32_t);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Bring the index up to date after `buffer` had `removed` bytes at
+ * `offset` replaced by `inserted` bytes. The brackets of the rows the
+ * TokenTable re-lexes are replaced; the ones after them are shifted.
+ * Does nothing while no brackets are tracked.
+ **********************************************************************/
+void BracketIndex::update(const Buffer &buffer, size_t offset, size_t removed, size_t inserted)
+{
+    if (!tokens) { return; }
+
+    tokens->update(buffer, offset, removed, inserted);
+
+    const auto [first, rows] = tokens->relexed();
+    const size_t  next       = first + rows;
+    const size_t  from       = buffer.offsetOf(Position(first, 1));
+    const size_t  to         = next <= buffer.lineCount() ? buffer.offsetOf(Position(next, 1))
+                                                           : buffer.size();
+    const int64_t delta      = int64_t(inserted) - int64_t(removed);
+
+    // [from, to) holds the re-lexed rows in the new text, [from, to - delta) in the old.
+    uint32_t before, rest, middle, after;
+    split(root, from, before, rest);
+    split(rest, size_t(int64_t(to) - delta), middle, after);
+    release(middle);
+    apply(after, delta);
+
+    root = merge(merge(before, collect(buffer, first, rows)), after);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <std::optional<size_t>> The offset of the partner of the
+ *   bracket at `offset`; nothing if there is no bracket at `offset`,
+ *   it is unbalanced or its partner by depth is of another pair.
+ **********************************************************************/
+std::optional<size_t> BracketIndex::match(size_t offset) const
+{
+    const Found self = find(offset);
+    if (self.node == NIL) { return std::nullopt; }
+
+    if (nodes[self.node].step > 0) {
+        const Found close = firstAfter(offset, self.before);
+        if (!paired(self, close)) { return std::nullopt; }
+        return close.offset;
+    }
+
+    // The opening bracket follows the last bracket before it to leave the
+    // depth at or below the depth after this one, or is the first bracket.
+    const int64_t target = self.before - 1;
+    const Found   prior  = lastBefore(offset, target);
+    const Found   open   = prior.node != NIL ? atOrAfter(prior.offset + 1)
+                         : target >= 0       ? atOrAfter(0)
+                                             : Found{};
+
+    if (!paired(open, self)) { return std::nullopt; }
+    return open.offset;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <std::optional<std::pair<size_t, size_t>>> The offsets of
+ *   the innermost pair of brackets with the opening bracket before
+ *   `offset` & the closing one at or after it; nothing if there is no
+ *   such pair or its brackets belong to different pairs.
+ **********************************************************************/
+std::optional<std::pair<size_t, size_t>> BracketIndex::enclosing(size_t offset) const
+{
+    // The innermost opening bracket follows the last bracket before
+    // `offset` to leave the depth below the depth at `offset`.
+    const int64_t target = depth(offset) - 1;
+    const Found   prior  = lastBefore(offset, target);
+    const Found   open   = prior.node != NIL ? atOrAfter(prior.offset + 1)
+                         : target >= 0       ? atOrAfter(0)
+                                             : Found{};
+
+    if (open.node == NIL || open.offset >= offset) { return std::nullopt; }
+
+    const Found close = firstAfter(open.offset, open.before);
+    if (!paired(open, close)) { return std::nullopt; }
+    return std::pair{ open.offset, close.offset };
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <int64_t> The number of opening less the number of closing
+ *   brackets before `offset`; negative after unbalanced closing ones.
+ **********************************************************************/
+int64_t BracketIndex::depth(size_t offset) const noexcept
+{
+    int64_t  total = 0;
+    int64_t  shift = 0;
+    uint32_t n     = root;
+
+    while (n != NIL) {
+        const Node &node = nodes[n];
+
+        if (size_t(int64_t(node.offset) + shift) < offset) {
+            total += sumOf(node.left) + node.step;
+            n = node.right;
+        }
+        else {
+            n = node.left;
+        }
+        shift += node.add;
+    }
+    return total;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * @returns <uint32_t> A pseudo-random treap priority (xorshift32).
+ **********************************************************************/
+uint32_t BracketIndex::nextPriority() noexcept
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * @returns <uint32_t> A detached node for a bracket, reusing the slot
+ *   of a released one when there is one.
+ **********************************************************************/
+uint32_t BracketIndex::make(size_t offset, uint16_t pair, int8_t step)
+{
+    uint32_t n;
+
+    if (!freeNodes.empty()) {
+        n = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else {
+        n = uint32_t(nodes.size());
+        nodes.emplace_back();
+    }
+
+    Node &node    = nodes[n];
+    node          = Node{};
+    node.offset   = offset;
+    node.pair     = pair;
+    node.step     = step;
+    node.sum      = step;
+    node.low      = step;
+    node.priority = nextPriority();
+
+    ++count;
+    return n;
+}
+
+
+/**********************************************************************
+ * @private
+ * Return every node of treap `n` to the free list.
+ **********************************************************************/
+void BracketIndex::release(uint32_t n)
+{
+    if (n == NIL) { return; }
+
+    release(nodes[n].left);
+    release(nodes[n].right);
+    freeNodes.push_back(n);
+    --count;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Shift node `n` by `add` & record the shift as pending for its
+ * children.
+ **********************************************************************/
+void BracketIndex::apply(uint32_t n, int64_t add) noexcept
+{
+    if (n == NIL || add == 0) { return; }
+
+    nodes[n].offset = size_t(int64_t(nodes[n].offset) + add);
+    nodes[n].add += add;
+}
+
+
+/**********************************************************************
+ * @private
+ * Push the pending shift of node `n` down to its children.
+ **********************************************************************/
+void BracketIndex::push(uint32_t n) noexcept
+{
+    Node &node = nodes[n];
+    if (node.add == 0) { return; }
+
+    apply(node.left, node.add);
+    apply(node.right, node.add);
+    node.add = 0;
+}
+
+
+/**********************************************************************
+ * @private
+ * Recompute the depth change & lowest depth of node `n`'s subtree.
+ **********************************************************************/
+void BracketIndex::pull(uint32_t n) noexcept
+{
+    Node         &node = nodes[n];
+    const int64_t mid  = sumOf(node.left) + node.step;
+
+    node.sum = mid + sumOf(node.right);
+    node.low = mid;
+    if (node.left != NIL) { node.low = std::min(node.low, nodes[node.left].low); }
+    if (node.right != NIL) { node.low = std::min(node.low, mid + nodes[node.right].low); }
+}
+
+
+/**********************************************************************
+ * @private
+ * Split treap `n` into `lo` (offset < `key`) & `hi` (offset >= `key`).
+ **********************************************************************/
+void BracketIndex::split(uint32_t n, size_t key, uint32_t &lo, uint32_t &hi)
+{
+    if (n == NIL) {
+        lo = hi = NIL;
+        return;
+    }
+
+    push(n);
+
+    if (nodes[n].offset < key) {
+        split(nodes[n].right, key, nodes[n].right, hi);
+        lo = n;
+    }
+    else {
+        split(nodes[n].left, key, lo, nodes[n].left);
+        hi = n;
+    }
+
+    pull(n);
+}
+
+
+/**********************************************************************
+ * @private
+ * Merge treaps `lo` & `hi`; every offset in `lo` must be below every
+ * offset in `hi`.
+ * @returns <uint32_t> The root of the merged treap.
+ **********************************************************************/
+uint32_t BracketIndex::merge(uint32_t lo, uint32_t hi)
+{
+    if (lo == NIL) { return hi; }
+    if (hi == NIL) { return lo; }
+
+    if (nodes[lo].priority > nodes[hi].priority) {
+        push(lo);
+        nodes[lo].right = merge(nodes[lo].right, hi);
+        pull(lo);
+        return lo;
+    }
+
+    push(hi);
+    nodes[hi].left = merge(lo, nodes[hi].left);
+    pull(hi);
+    return hi;
+}
+
+
+/**********************************************************************
+ * @private
+ * Build a treap of the brackets among the tokens of `rows` rows of the
+ * TokenTable, starting at `first` (1-based).
+ * @returns <uint32_t> Its root.
+ **********************************************************************/
+uint32_t BracketIndex::collect(const Buffer &buffer, size_t first, size_t rows)
+{
+    uint32_t tree = NIL;
+
+    for (size_t row = first; row < first + rows; ++row) {
+        const size_t start = buffer.offsetOf(Position(row, 1));
+
+        for (const LineToken &token : tokens->tokensIn(row)) {
+            for (size_t pair = 0; pair < pairs.size(); ++pair) {
+                if (token.kind != pairs[pair].open && token.kind != pairs[pair].close) {
+                    continue;
+                }
+
+                const int8_t step = token.kind == pairs[pair].open ? 1 : -1;
+                tree = merge(tree, make(start + token.column, uint16_t(pair), step));
+                break;
+            }
+        }
+    }
+    return tree;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * @returns <int64_t> The depth change over treap `n`.
+ **********************************************************************/
+int64_t BracketIndex::sumOf(uint32_t n) const noexcept
+{
+    return n == NIL ? 0 : nodes[n].sum;
+}
+
+
+/**********************************************************************
+ * @private
+ * @returns <Found> The bracket at `offset`, if any.
+ **********************************************************************/
+BracketIndex::Found BracketIndex::find(size_t offset) const noexcept
+{
+    int64_t  before = 0;
+    int64_t  shift  = 0;
+    uint32_t n      = root;
+
+    while (n != NIL) {
+        const Node  &node = nodes[n];
+        const size_t key  = size_t(int64_t(node.offset) + shift);
+
+        if (key == offset) { return { n, key, before + sumOf(node.left) }; }
+
+        if (key < offset) {
+            before += sumOf(node.left) + node.step;
+            n = node.right;
+        }
+        else {
+            n = node.left;
+        }
+        shift += node.add;
+    }
+    return {};
+}
+
+
+/**********************************************************************
+ * @private
+ * @returns <Found> The first bracket at or after `offset`, if any.
+ **********************************************************************/
+BracketIndex::Found BracketIndex::atOrAfter(size_t offset) const noexcept
+{
+    Found    best;
+    int64_t  before = 0;
+    int64_t  shift  = 0;
+    uint32_t n      = root;
+
+    while (n != NIL) {
+        const Node  &node = nodes[n];
+        const size_t key  = size_t(int64_t(node.offset) + shift);
+
+        if (key >= offset) {
+            best = { n, key, before + sumOf(node.left) };
+            n    = node.left;
+        }
+        else {
+            before += sumOf(node.left) + node.step;
+            n = node.right;
+        }
+        shift += node.add;
+    }
+    return best;
+}
+
+
+/**********************************************************************
+ * @private
+ * @returns <Found> The first bracket after `offset` that leaves the
+ *   depth at or below `depth`, if any.
+ **********************************************************************/
+BracketIndex::Found BracketIndex::firstAfter(size_t offset, int64_t depth) const noexcept
+{
+    return firstAfter(root, 0, 0, offset, depth);
+}
+
+
+BracketIndex::Found BracketIndex::firstAfter(
+  uint32_t n,
+  int64_t  shift,
+  int64_t  base,
+  size_t   offset,
+  int64_t  depth) const noexcept
+{
+    if (n == NIL) { return {}; }
+
+    const Node   &node  = nodes[n];
+    const size_t  key   = size_t(int64_t(node.offset) + shift);
+    const int64_t after = base + sumOf(node.left) + node.step;
+
+    if (key <= offset) { return firstAfter(node.right, shift + node.add, after, offset, depth); }
+
+    const Found found = firstAfter(node.left, shift + node.add, base, offset, depth);
+    if (found.node != NIL) { return found; }
+    if (after <= depth) { return { n, key, after - node.step }; }
+    return firstIn(node.right, shift + node.add, after, depth);
+}
+
+
+/**********************************************************************
+ * @private
+ * @returns <Found> The first bracket of treap `n`, which starts at
+ *   depth `base`, that leaves the depth at or below `depth`, if any.
+ **********************************************************************/
+BracketIndex::Found BracketIndex::firstIn(
+  uint32_t n,
+  int64_t  shift,
+  int64_t  base,
+  int64_t  depth) const noexcept
+{
+    if (n == NIL || base + nodes[n].low > depth) { return {}; }
+
+    while (true) {
+        const Node &node = nodes[n];
+
+        if (node.left != NIL && base + nodes[node.left].low <= depth) {
+            shift += node.add;
+            n = node.left;
+            continue;
+        }
+
+        const int64_t after = base + sumOf(node.left) + node.step;
+        if (after <= depth) {
+            return { n, size_t(int64_t(node.offset) + shift), after - node.step };
+        }
+
+        base = after;
+        shift += node.add;
+        n = node.right;
+    }
+}
+
+
+/**********************************************************************
+ * @private
+ * @returns <Found> The last bracket before `offset` that leaves the
+ *   depth at or below `depth`, if any.
+ **********************************************************************/
+BracketIndex::Found BracketIndex::lastBefore(size_t offset, int64_t depth) const noexcept
+{
+    return lastBefore(root, 0, 0, offset, depth);
+}
+
+
+BracketIndex::Found BracketIndex::lastBefore(
+  uint32_t n,
+  int64_t  shift,
+  int64_t  base,
+  size_t   offset,
+  int64_t  depth) const noexcept
+{
+    if (n == NIL) { return {}; }
+
+    const Node   &node  = nodes[n];
+    const size_t  key   = size_t(int64_t(node.offset) + shift);
+    const int64_t after = base + sumOf(node.left) + node.step;
+
+    if (key >= offset) { return lastBefore(node.left, shift + node.add, base, offset, depth); }
+
+    const Found found = lastBefore(node.right, shift + node.add, after, offset, depth);
+    if (found.node != NIL) { return found; }
+    if (after <= depth) { return { n, key, after - node.step }; }
+    return lastIn(node.left, shift + node.add, base, depth);
+}
+
+
+/**********************************************************************
+ * @private
+ * @returns <Found> The last bracket of treap `n`, which starts at
+ *   depth `base`, that leaves the depth at or below `depth`, if any.
+ **********************************************************************/
+BracketIndex::Found BracketIndex::lastIn(
+  uint32_t n,
+  int64_t  shift,
+  int64_t  base,
+  int64_t  depth) const noexcept
+{
+    if (n == NIL || base + nodes[n].low > depth) { return {}; }
+
+    while (true) {
+        const Node   &node  = nodes[n];
+        const int64_t after = base + sumOf(node.left) + node.step;
+
+        if (node.right != NIL && after + nodes[node.right].low <= depth) {
+            base = after;
+            shift += node.add;
+            n = node.right;
+            continue;
+        }
+
+        if (after <= depth) {
+            return { n, size_t(int64_t(node.offset) + shift), after - node.step };
+        }
+
+        shift += node.add;
+        n = node.left;
+    }
+}
+
+
+/**********************************************************************
+ * @private
+ * @returns <bool> true if `open` & `close` are an opening & a closing
+ *   bracket of the same pair.
+ **********************************************************************/
+bool BracketIndex::paired(const Found &open, const Found &close) const noexcept
+{
+    return open.node != NIL && close.node != NIL && nodes[open.node].step > 0
+        && nodes[close.node].step < 0 && nodes[open.node].pair == nodes[close.node].pair;
+}
+
+}  // namespace Text
@@ -0,0 +1,551 @@
+#include <text/decoration.hpp>
+#include <utils/exception.hpp>
+#include <utils/raise.hpp>
+
+#include <algorithm>
+#include <format>
+
+using namespace Text_Buffer;
+
+namespace Text {
+
+/**********************************************************************
+ * Add a decoration covering the byte range [start, end].
+ * @param kind Caller-defined tag (style, severity, ...).
+ * @returns <DecorationId> Handle of the new decoration. Handles of
+ *   removed decorations are recycled.
+ * @throws <Exception> OUT_OF_RANGE if `end < start`.
+ **********************************************************************/
+DecorationId DecorationTree::add(size_t start, size_t end, uint32_t kind)
+{
+    if (end < start) {
+        raise_error(generate_out_of_range_exception(
+          "The decoration range [{}, {}] ends before it starts.", start, end));
+    }
+
+    DecorationId id;
+
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else {
+        id = DecorationId(nodes.size());
+        nodes.emplace_back();
+    }
+
+    Node &node    = nodes[id];
+    node          = Node{};
+    node.start    = start;
+    node.end      = end;
+    node.kind     = kind;
+    node.priority = nextPriority();
+    node.live     = true;
+
+    insert(root, id);
+    ++count;
+    return id;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Remove a decoration.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live decoration.
+ **********************************************************************/
+void DecorationTree::remove(DecorationId id)
+{
+    check(id);
+    unlink(root, id);
+
+    nodes[id].live = false;
+    freeIds.push_back(id);
+    --count;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <bool> true if `id` refers to a live decoration.
+ **********************************************************************/
+bool DecorationTree::contains(DecorationId id) const noexcept
+{ return id < nodes.size() && nodes[id].live; }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> The number of live decorations.
+ **********************************************************************/
+size_t DecorationTree::size() const noexcept { return count; }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> Heap bytes held by the tree, including the slots
+ *   of removed decorations kept for reuse.
+ **********************************************************************/
+size_t DecorationTree::memoryUsage() const noexcept
+{
+    return nodes.capacity() * sizeof(Node) + freeIds.capacity() * sizeof(uint32_t)
+         + scratch.capacity() * sizeof(uint32_t);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Release spare capacity: trailing slots of removed decorations are
+ * dropped (their ids are no longer recycled) & the arrays shrunk.
+ **********************************************************************/
+void DecorationTree::shrinkToFit()
+{
+    while (!nodes.empty() && !nodes.back().live) { nodes.pop_back(); }
+
+    const auto limit = uint32_t(nodes.size());
+    std::erase_if(freeIds, [limit](uint32_t id) { return id >= limit; });
+
+    // Exact-size copies swapped in; see Buffer::shrinkToFit() for why not shrink_to_fit().
+    decltype(nodes)(nodes).swap(nodes);
+    decltype(freeIds)(freeIds).swap(freeIds);
+    decltype(scratch)().swap(scratch);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Remove every decoration.
+ **********************************************************************/
+void DecorationTree::clear() noexcept
+{
+    nodes.clear();
+    freeIds.clear();
+    root  = NIL;
+    count = 0;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <std::pair<size_t, size_t>> The current [start, end] byte
+ *   range of a decoration: its stored range plus the pending shifts
+ *   of its ancestors, which are not pushed down.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live decoration.
+ **********************************************************************/
+std::pair<size_t, size_t> DecorationTree::rangeOf(DecorationId id) const
+{
+    check(id);
+
+    int64_t shift = 0;
+    for (uint32_t n = nodes[id].parent; n != NIL; n = nodes[n].parent) { shift += nodes[n].add; }
+
+    return { size_t(int64_t(nodes[id].start) + shift), size_t(int64_t(nodes[id].end) + shift) };
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <uint32_t> The kind a decoration was added with.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live decoration.
+ **********************************************************************/
+uint32_t DecorationTree::kindOf(DecorationId id) const
+{
+    check(id);
+    return nodes[id].kind;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Append the ids of every decoration overlapping the byte range
+ * [from, to] to `out`, ordered by start offset. Ranges that merely
+ * touch the query range (including empty ranges) are reported.
+ **********************************************************************/
+void DecorationTree::query(size_t from, size_t to, std::vector<DecorationId> &out) const
+{ query(root, 0, from, to, out); }
+
+
+
+
+
+
+/**********************************************************************
+ * Update every decoration for the replacement of `length` bytes at
+ * `offset` with `inserted` bytes. Decorations that start after the
+ * replaced range are shifted lazily; those overlapping it are mapped
+ * one by one & re-inserted.
+ **********************************************************************/
+void DecorationTree::replace(size_t offset, size_t length, size_t inserted)
+{
+    const size_t limit = offset + length;
+    const auto   delta = int64_t(inserted) - int64_t(length);
+    uint32_t     before, rest, middle, after;
+
+    split(root, offset, before, rest);
+    split(rest, limit, middle, after);
+    apply(after, delta);
+
+    scratch.clear();
+    collectEndsAfter(before, offset, scratch);
+    for (const DecorationId id : scratch) { unlink(before, id); }
+    collectAll(middle, scratch);
+
+    root = merge(before, after);
+    counters.add(Stat::TREE_SPLITS, 2);
+    counters.add(Stat::TREE_MERGES);
+
+    for (const DecorationId id : scratch) {
+        Node &node = nodes[id];
+
+        if (node.start >= offset) { node.start = offset + inserted; }
+
+        if (node.end >= limit) {
+            node.end = size_t(int64_t(node.end) + delta);
+        }
+        else if (node.end > offset) {
+            node.end = offset;
+        }
+
+        node.end = std::max(node.end, node.start);
+        insert(root, id);
+    }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * @returns <uint32_t> A pseudo-random treap priority (xorshift32).
+ **********************************************************************/
+uint32_t DecorationTree::nextPriority() noexcept
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Shift node `n` by `add` & record the shift as pending for its
+ * children.
+ **********************************************************************/
+void DecorationTree::apply(uint32_t n, int64_t add) noexcept
+{
+    if (n == NIL || add == 0) { return; }
+
+    Node &node  = nodes[n];
+    node.start  = size_t(int64_t(node.start) + add);
+    node.end    = size_t(int64_t(node.end) + add);
+    node.maxEnd = size_t(int64_t(node.maxEnd) + add);
+    node.add += add;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Push the pending shift of node `n` down to its children.
+ **********************************************************************/
+void DecorationTree::push(uint32_t n) noexcept
+{
+    Node &node = nodes[n];
+    if (node.add == 0) { return; }
+
+    apply(node.left, node.add);
+    apply(node.right, node.add);
+    node.add = 0;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Push the pending shifts of every ancestor of node `n` down, from the
+ * root towards `n`.
+ **********************************************************************/
+void DecorationTree::pushPath(uint32_t n) noexcept
+{
+    const uint32_t parent = nodes[n].parent;
+    if (parent == NIL) { return; }
+
+    pushPath(parent);
+    push(parent);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Recompute the subtree maximum of node `n` & re-point the parent
+ * links of its children at it.
+ **********************************************************************/
+void DecorationTree::pull(uint32_t n) noexcept
+{
+    Node &node  = nodes[n];
+    node.maxEnd = node.end;
+
+    if (node.left != NIL) {
+        nodes[node.left].parent = n;
+        node.maxEnd             = std::max(node.maxEnd, nodes[node.left].maxEnd);
+    }
+
+    if (node.right != NIL) {
+        nodes[node.right].parent = n;
+        node.maxEnd              = std::max(node.maxEnd, nodes[node.right].maxEnd);
+    }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Split treap `n` into `lo` (start < `key`) & `hi` (start >= `key`).
+ **********************************************************************/
+void DecorationTree::split(uint32_t n, size_t key, uint32_t &lo, uint32_t &hi)
+{
+    if (n == NIL) {
+        lo = hi = NIL;
+        return;
+    }
+
+    push(n);
+
+    if (nodes[n].start < key) {
+        split(nodes[n].right, key, nodes[n].right, hi);
+        lo = n;
+    }
+    else {
+        split(nodes[n].left, key, lo, nodes[n].left);
+        hi = n;
+    }
+
+    pull(n);
+    if (lo != NIL) { nodes[lo].parent = NIL; }
+    if (hi != NIL) { nodes[hi].parent = NIL; }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Merge treaps `lo` & `hi`; every start in `lo` must be <= every
+ * start in `hi`.
+ * @returns <uint32_t> The root of the merged treap.
+ **********************************************************************/
+uint32_t DecorationTree::merge(uint32_t lo, uint32_t hi)
+{
+    if (lo == NIL) { return hi; }
+    if (hi == NIL) { return lo; }
+
+    if (nodes[lo].priority > nodes[hi].priority) {
+        push(lo);
+        nodes[lo].right = merge(nodes[lo].right, hi);
+        pull(lo);
+        return lo;
+    }
+
+    push(hi);
+    nodes[hi].left = merge(lo, nodes[hi].left);
+    pull(hi);
+    return hi;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Insert the detached node `n` into `tree` at its start offset.
+ **********************************************************************/
+void DecorationTree::insert(uint32_t &tree, uint32_t n)
+{
+    Node &node  = nodes[n];
+    node.left   = NIL;
+    node.right  = NIL;
+    node.parent = NIL;
+    node.add    = 0;
+    node.maxEnd = node.end;
+
+    uint32_t lo, hi;
+    split(tree, node.start, lo, hi);
+
+    tree               = merge(merge(lo, n), hi);
+    nodes[tree].parent = NIL;
+    counters.add(Stat::TREE_SPLITS);
+    counters.add(Stat::TREE_MERGES, 2);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Detach node `n` from `tree`, leaving its own offsets current, & fix
+ * the subtree maximums of its former ancestors.
+ **********************************************************************/
+void DecorationTree::unlink(uint32_t &tree, uint32_t n)
+{
+    pushPath(n);
+    push(n);
+
+    const uint32_t parent = nodes[n].parent;
+    const uint32_t joined = merge(nodes[n].left, nodes[n].right);
+    counters.add(Stat::TREE_MERGES);
+
+    if (parent == NIL) {
+        tree = joined;
+    }
+    else if (nodes[parent].left == n) {
+        nodes[parent].left = joined;
+    }
+    else {
+        nodes[parent].right = joined;
+    }
+
+    if (joined != NIL) { nodes[joined].parent = parent; }
+    for (uint32_t a = parent; a != NIL; a = nodes[a].parent) { pull(a); }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Append every node of treap `n` to `out`.
+ **********************************************************************/
+void DecorationTree::collectAll(uint32_t n, std::vector<DecorationId> &out)
+{
+    if (n == NIL) { return; }
+
+    push(n);
+    collectAll(nodes[n].left, out);
+    out.push_back(n);
+    collectAll(nodes[n].right, out);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Append the nodes of treap `n` whose end is past `offset` to `out`.
+ **********************************************************************/
+void DecorationTree::collectEndsAfter(
+  uint32_t                   n,
+  size_t                     offset,
+  std::vector<DecorationId> &out)
+{
+    if (n == NIL || nodes[n].maxEnd <= offset) { return; }
+
+    push(n);
+    collectEndsAfter(nodes[n].left, offset, out);
+    if (nodes[n].end > offset) { out.push_back(n); }
+    collectEndsAfter(nodes[n].right, offset, out);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Overlap query over treap `n`, see the public `query()`. `shift` is
+ * the sum of the pending shifts above `n`; they are added to what is
+ * read rather than pushed down.
+ **********************************************************************/
+void DecorationTree::query(
+  uint32_t                   n,
+  int64_t                    shift,
+  size_t                     from,
+  size_t                     to,
+  std::vector<DecorationId> &out) const
+{
+    if (n == NIL) { return; }
+
+    const Node &node = nodes[n];
+    if (size_t(int64_t(node.maxEnd) + shift) < from) { return; }
+
+    query(node.left, shift + node.add, from, to, out);
+
+    if (size_t(int64_t(node.start) + shift) > to) { return; }
+    if (size_t(int64_t(node.end) + shift) >= from) { out.push_back(n); }
+
+    query(node.right, shift + node.add, from, to, out);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live decoration.
+ **********************************************************************/
+void DecorationTree::check(DecorationId id) const
+{
+    if (!contains(id)) {
+        raise_error(generate_out_of_range_exception(
+          "Decoration #{} does not exist.", id));
+    }
+}
+
+}  // namespace Text
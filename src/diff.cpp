@@ -0,0 +1,543 @@
+#include <text/buffer.hpp>
+#include <text/diff.hpp>
+#include <text/trace.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Text {
+
+namespace {
+
+    constexpr size_t PARALLEL_BYTES = size_t(1) << 22;  /// Texts hashed by several threads
+    constexpr size_t PARALLEL_LINES = size_t(1) << 14;  /// Middles cut into regions at anchors
+    constexpr size_t TRACE_LIMIT    = size_t(1) << 22;  /// Greedy trace entries before falling back
+    constexpr size_t SPLIT_MIN_COST = 4096;             /// Edits a middle-snake search may always try
+
+
+    /**************************************************************
+     * The lines of a Buffer as byte ranges including their line
+     * breaks, so lines differing only in a missing final break
+     * differ. The empty row after a final break is not a line.
+     **************************************************************/
+    struct Lines
+    {
+        std::string_view      text;
+        std::vector<size_t>   starts;  /// Start of each line, then the text's size
+        std::vector<uint64_t> hashes;
+
+        size_t size() const noexcept { return starts.size() - 1; }
+
+        std::string_view at(size_t i) const noexcept
+        { return text.substr(starts[i], starts[i + 1] - starts[i]); }
+    };
+
+
+    /**************************************************************
+     * Run `work(i)` for every i in [0, tasks) on up to `threads`
+     * threads, the calling one included.
+     **************************************************************/
+    void parallel(size_t tasks, size_t threads, const std::function<void(size_t)> &work)
+    {
+        threads = std::min(threads, tasks);
+        if (threads <= 1) {
+            for (size_t i = 0; i < tasks; ++i) { work(i); }
+            return;
+        }
+
+        std::atomic<size_t> next{ 0 };
+        const auto          run = [&] {
+            for (size_t i; (i = next.fetch_add(1)) < tasks;) { work(i); }
+        };
+
+        // Threads that fail to start leave their share to the others, & the
+        // ones that did start are joined on the way out either way.
+        std::vector<std::jthread> pool;
+        pool.reserve(threads - 1);
+#if defined(__cpp_exceptions)
+        try {
+            for (size_t t = 1; t < threads; ++t) { pool.emplace_back(run); }
+        }
+        catch (...) {}
+#else
+        for (size_t t = 1; t < threads; ++t) { pool.emplace_back(run); }
+#endif
+        run();
+    }
+
+
+    /**************************************************************
+     * Split `buffer` into lines & hash them, a run of rows of about
+     * equal bytes per thread.
+     **************************************************************/
+    Lines hashLines(const Buffer &buffer, size_t threads)
+    {
+        Lines lines;
+        lines.text = buffer.text();
+
+        size_t rows = buffer.lineCount();
+        if (lines.text.empty() || lines.text.ends_with('\n')) { --rows; }
+
+        lines.starts.resize(rows + 1);
+        lines.hashes.resize(rows);
+        lines.starts[rows] = lines.text.size();
+        if (rows == 0) { return lines; }
+
+        const size_t parts = buffer.size() < PARALLEL_BYTES ? 1 : threads * 4;
+        std::vector<LineView> views(parts);
+        buffer.lines(1, rows).partition(views);
+
+        // First the starts, then the hashes, which need the next row's start.
+        const auto base = lines.text.data();
+        parallel(parts, threads, [&](size_t i) {
+            for (const BufferLine line : views[i]) {
+                lines.starts[line.row.get() - 1] = size_t(line.text.data() - base);
+            }
+        });
+        parallel(parts, threads, [&](size_t i) {
+            const std::hash<std::string_view> hash;
+            for (const BufferLine line : views[i]) {
+                const size_t row0  = line.row.get() - 1;
+                lines.hashes[row0] = hash(lines.at(row0));
+            }
+        });
+        return lines;
+    }
+
+
+    /**************************************************************
+     * Numbers the distinct lines of both Buffers, so lines compare
+     * as integers. An open-addressing table of line hashes; equal
+     * hashes are confirmed by comparing the bytes.
+     **************************************************************/
+    class LineClasses
+    {
+        std::vector<uint32_t>         slots = std::vector<uint32_t>(1024, 0);  /// Class + 1
+        std::vector<std::string_view> texts;
+        std::vector<uint64_t>         hashes;
+
+      public:
+        size_t size() const noexcept { return texts.size(); }
+
+        uint32_t classOf(std::string_view text, uint64_t hash)
+        {
+            const size_t mask = slots.size() - 1;
+
+            for (size_t i = hash & mask;; i = (i + 1) & mask) {
+                const uint32_t slot = slots[i];
+
+                if (slot == 0) {
+                    texts.push_back(text);
+                    hashes.push_back(hash);
+                    slots[i] = uint32_t(texts.size());
+                    if (texts.size() * 2 > slots.size()) { grow(); }
+                    return uint32_t(texts.size() - 1);
+                }
+                if (hashes[slot - 1] == hash && texts[slot - 1] == text) { return slot - 1; }
+            }
+        }
+
+      private:
+        void grow()
+        {
+            slots.assign(slots.size() * 2, 0);
+
+            const size_t mask = slots.size() - 1;
+            for (size_t c = 0; c < texts.size(); ++c) {
+                size_t i = hashes[c] & mask;
+                while (slots[i] != 0) { i = (i + 1) & mask; }
+                slots[i] = uint32_t(c + 1);
+            }
+        }
+    };
+
+
+    struct Region
+    {
+        size_t xoff, xlim;  /// Old lines [xoff, xlim)
+        size_t yoff, ylim;  /// New lines [yoff, ylim)
+    };
+
+
+    /**************************************************************
+     * Myers' O(ND) difference algorithm over line classes, marking
+     * the old lines deleted & the new lines inserted.
+     *
+     * A region is first tried greedily, keeping the furthest
+     * reaching path of every diagonal per edit distance so the
+     * script can be traced back; past `TRACE_LIMIT` entries it falls
+     * back to the linear-space refinement, which finds the middle
+     * snake of an optimal path by searching from both ends & diffs
+     * the halves on either side of it the same way.
+     *
+     * Like GNU diff, a middle-snake search gives up after about
+     * max(SPLIT_MIN_COST, sqrt(N + M)) edits & cuts at the furthest
+     * reaching path instead, so inputs with few common lines stay
+     * near-linear; the script is then valid but may not be minimal.
+     **************************************************************/
+    class Myers
+    {
+        const uint32_t       *a;
+        const uint32_t       *b;
+        uint8_t              *deleted;
+        uint8_t              *inserted;
+        std::vector<int64_t>  forward;  /// Furthest x per diagonal
+        std::vector<int64_t>  backward;
+        std::vector<uint32_t> trace;
+
+      public:
+        Myers(const uint32_t *old, const uint32_t *now, uint8_t *del, uint8_t *ins)
+        : a(old)
+        , b(now)
+        , deleted(del)
+        , inserted(ins)
+        {}
+
+        void compare(size_t xoff, size_t xlim, size_t yoff, size_t ylim)
+        {
+            while (xoff < xlim && yoff < ylim && a[xoff] == b[yoff]) { ++xoff, ++yoff; }
+            while (xoff < xlim && yoff < ylim && a[xlim - 1] == b[ylim - 1]) { --xlim, --ylim; }
+
+            if (xoff == xlim) {
+                std::fill(inserted + yoff, inserted + ylim, 1);
+                return;
+            }
+            if (yoff == ylim) {
+                std::fill(deleted + xoff, deleted + xlim, 1);
+                return;
+            }
+            if (greedy(xoff, xlim, yoff, ylim)) { return; }
+
+            const auto [xmid, ymid] = split(xoff, xlim, yoff, ylim);
+            compare(xoff, xmid, yoff, ymid);
+            compare(xmid, xlim, ymid, ylim);
+        }
+
+      private:
+        bool greedy(size_t xoff, size_t xlim, size_t yoff, size_t ylim)
+        {
+            const auto n   = int64_t(xlim - xoff);
+            const auto m   = int64_t(ylim - yoff);
+            const auto max = n + m;
+
+            forward.assign(size_t(2 * max + 3), 0);
+            trace.clear();
+
+            const uint32_t *pa = a + xoff;
+            const uint32_t *pb = b + yoff;
+            int64_t        *v  = forward.data() + max + 1;  // Indexed by diagonal k = x - y
+            for (int64_t d = 0; d <= max; ++d) {
+                if (trace.size() + size_t(d) + 1 > TRACE_LIMIT) { return false; }
+
+                for (int64_t k = -d; k <= d; k += 2) {
+                    const bool down = k == -d || (k != d && v[k - 1] < v[k + 1]);
+                    int64_t    x    = down ? v[k + 1] : v[k - 1] + 1;
+                    int64_t    y    = x - k;
+
+                    while (x < n && y < m && pa[x] == pb[y]) { ++x, ++y; }
+                    v[k] = x;
+
+                    if (x >= n && y >= m) {
+                        traceBack(d, n, m, xoff, yoff);
+                        return true;
+                    }
+                }
+                for (int64_t k = -d; k <= d; k += 2) { trace.push_back(uint32_t(v[k])); }
+            }
+            return false;
+        }
+
+        void traceBack(int64_t d, int64_t x, int64_t y, size_t xoff, size_t yoff)
+        {
+            for (; d > 0; --d) {
+                // Row d - 1 of the trace holds diagonals -(d - 1) to d - 1, every other one.
+                const uint32_t *row = trace.data() + size_t((d - 1) * d / 2);
+                const auto      at  = [&](int64_t k) { return int64_t(row[(k + d - 1) / 2]); };
+
+                const int64_t k    = x - y;
+                const bool    down = k == -d || (k != d && at(k - 1) < at(k + 1));
+                const int64_t prev = down ? k + 1 : k - 1;
+
+                x = at(prev);
+                y = x - prev;
+
+                if (down) { inserted[yoff + size_t(y)] = 1; }
+                else { deleted[xoff + size_t(x)] = 1; }
+            }
+        }
+
+        std::pair<size_t, size_t> split(size_t xoff, size_t xlim, size_t yoff, size_t ylim)
+        {
+            const auto    x0 = int64_t(xoff), x1 = int64_t(xlim);
+            const auto    y0 = int64_t(yoff), y1 = int64_t(ylim);
+            const int64_t dmin = x0 - y1, dmax = x1 - y0;
+            const int64_t fmid = x0 - y0, bmid = x1 - y1;
+            const bool    odd  = (fmid - bmid) & 1;
+
+            // About sqrt(N + M), as a power of two, but at least SPLIT_MIN_COST.
+            size_t limit = 1;
+            for (auto diagonals = size_t(dmax - dmin + 3); diagonals != 0; diagonals >>= 2) {
+                limit <<= 1;
+            }
+            limit = std::max(limit, SPLIT_MIN_COST);
+
+            const auto need = size_t(dmax - dmin + 3);
+            if (forward.size() < need) { forward.resize(need); }
+            if (backward.size() < need) { backward.resize(need); }
+
+            // Indexed by diagonal x - y, which may be far below zero.
+            const auto fd = [&](int64_t d) -> int64_t & { return forward[size_t(d - dmin + 1)]; };
+            const auto bd = [&](int64_t d) -> int64_t & { return backward[size_t(d - dmin + 1)]; };
+
+            int64_t fmin = fmid, fmax = fmid, bmin = bmid, bmax = bmid;
+            fd(fmid) = x0;
+            bd(bmid) = x1;
+
+            while (true) {
+                // Extend the forward search by one edit.
+                if (fmin > dmin) { fd(--fmin - 1) = -1; }
+                else { ++fmin; }
+                if (fmax < dmax) { fd(++fmax + 1) = -1; }
+                else { --fmax; }
+
+                for (int64_t d = fmax; d >= fmin; d -= 2) {
+                    const int64_t lo = fd(d - 1), hi = fd(d + 1);
+                    int64_t       x  = lo >= hi ? lo + 1 : hi;
+                    int64_t       y  = x - d;
+
+                    while (x < x1 && y < y1 && a[x] == b[y]) { ++x, ++y; }
+                    fd(d) = x;
+                    if (odd && bmin <= d && d <= bmax && bd(d) <= x) {
+                        return { size_t(x), size_t(y) };
+                    }
+                }
+
+                // Extend the backward search by one edit.
+                if (bmin > dmin) { bd(--bmin - 1) = INT64_MAX; }
+                else { ++bmin; }
+                if (bmax < dmax) { bd(++bmax + 1) = INT64_MAX; }
+                else { --bmax; }
+
+                for (int64_t d = bmax; d >= bmin; d -= 2) {
+                    const int64_t lo = bd(d - 1), hi = bd(d + 1);
+                    int64_t       x  = lo < hi ? lo : hi - 1;
+                    int64_t       y  = x - d;
+
+                    while (x > x0 && y > y0 && a[x - 1] == b[y - 1]) { --x, --y; }
+                    bd(d) = x;
+                    if (!odd && fmin <= d && d <= fmax && x <= fd(d)) {
+                        return { size_t(x), size_t(y) };
+                    }
+                }
+
+                if (--limit == 0) { return furthest(fd, bd, fmin, fmax, bmin, bmax, x0, x1, y0, y1); }
+            }
+        }
+
+        /**********************************************************
+         * The cut of a search that ran out of budget: the point
+         * the forward or backward search got furthest with, by
+         * x + y covered from its end of the region.
+         **********************************************************/
+        template <typename Forward, typename Backward>
+        static std::pair<size_t, size_t> furthest(
+          const Forward  &fd,
+          const Backward &bd,
+          int64_t         fmin,
+          int64_t         fmax,
+          int64_t         bmin,
+          int64_t         bmax,
+          int64_t         x0,
+          int64_t         x1,
+          int64_t         y0,
+          int64_t         y1)
+        {
+            int64_t fbest = -1, fx = x0;
+            for (int64_t d = fmax; d >= fmin; d -= 2) {
+                int64_t x = std::min(fd(d), x1);
+                int64_t y = x - d;
+                if (y > y1) { x = y1 + d, y = y1; }
+                if (x + y > fbest) { fbest = x + y, fx = x; }
+            }
+
+            int64_t bbest = INT64_MAX, bx = x1;
+            for (int64_t d = bmax; d >= bmin; d -= 2) {
+                int64_t x = std::max(x0, bd(d));
+                int64_t y = x - d;
+                if (y < y0) { x = y0 + d, y = y0; }
+                if (x + y < bbest) { bbest = x + y, bx = x; }
+            }
+
+            if ((x1 + y1) - bbest < fbest - (x0 + y0)) { return { size_t(fx), size_t(fbest - fx) }; }
+            return { size_t(bx), size_t(bbest - bx) };
+        }
+    };
+
+
+    /**************************************************************
+     * Cut the middle of the two files into regions diffed on their
+     * own, at anchors: lines occurring exactly once in each middle,
+     * kept where they appear in the same order in both (the longest
+     * increasing run, as patience diff picks them).
+     **************************************************************/
+    std::vector<Region> regions(
+      const std::vector<uint32_t> &a,
+      const std::vector<uint32_t> &b,
+      const Region                &middle,
+      size_t                       classes)
+    {
+        if ((middle.xlim - middle.xoff) + (middle.ylim - middle.yoff) < PARALLEL_LINES) {
+            return { middle };
+        }
+
+        std::vector<uint8_t>  countA(classes), countB(classes);
+        std::vector<uint32_t> where(classes);
+
+        for (size_t x = middle.xoff; x < middle.xlim; ++x) {
+            countA[a[x]] = uint8_t(std::min(countA[a[x]] + 1, 2));
+            where[a[x]]  = uint32_t(x);
+        }
+        for (size_t y = middle.yoff; y < middle.ylim; ++y) {
+            countB[b[y]] = uint8_t(std::min(countB[b[y]] + 1, 2));
+        }
+
+        // Unique pairs in new-line order; keep the longest run increasing in old lines.
+        std::vector<std::pair<size_t, size_t>> pairs;
+        for (size_t y = middle.yoff; y < middle.ylim; ++y) {
+            if (countA[b[y]] == 1 && countB[b[y]] == 1) { pairs.push_back({ where[b[y]], y }); }
+        }
+
+        std::vector<size_t> tails, previous(pairs.size());
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            const auto at = std::lower_bound(
+              tails.begin(), tails.end(), pairs[i].first, [&](size_t t, size_t x) {
+                  return pairs[t].first < x;
+              });
+
+            previous[i] = at == tails.begin() ? SIZE_MAX : *(at - 1);
+            if (at == tails.end()) { tails.push_back(i); }
+            else { *at = i; }
+        }
+
+        std::vector<size_t> anchors;
+        for (size_t i = tails.empty() ? SIZE_MAX : tails.back(); i != SIZE_MAX; i = previous[i]) {
+            anchors.push_back(i);
+        }
+        std::reverse(anchors.begin(), anchors.end());
+
+        std::vector<Region> out;
+        size_t              x = middle.xoff, y = middle.yoff;
+        for (const size_t i : anchors) {
+            const auto [ax, ay] = pairs[i];
+            if (ax > x || ay > y) { out.push_back({ x, ax, y, ay }); }
+            x = ax + 1;
+            y = ay + 1;
+        }
+        out.push_back({ x, middle.xlim, y, middle.ylim });
+        return out;
+    }
+
+
+    Position positionAt(const Buffer &buffer, const Lines &lines, size_t line)
+    {
+        return line < lines.size() ? Position(line + 1, 1) : buffer.positionOf(buffer.size());
+    }
+
+}  // namespace
+
+
+
+
+
+
+/**********************************************************************
+ * Compare two Buffers line by line.
+ *
+ * Lines are hashed in bulk & numbered by content, the common prefix
+ * & suffix are stripped, & the rest is diffed with Myers' algorithm,
+ * falling back to its linear-space refinement for large edit
+ * distances. Middles of more than a few thousand lines are first cut
+ * at lines unique to both sides into regions diffed in parallel; the
+ * result then need not be minimal, but does not depend on `threads`.
+ *
+ * @param threads Threads to use; 0 for one per hardware thread.
+ * @returns <std::vector<DiffHunk>> The hunks turning `from` into
+ *   `to`, in order; empty if the texts are equal.
+ **********************************************************************/
+std::vector<DiffHunk> diff(const Buffer &from, const Buffer &to, size_t threads)
+{
+    const TraceSpan span("diff", from.size() + to.size());
+
+    if (threads == 0) { threads = std::max<size_t>(1, std::thread::hardware_concurrency()); }
+
+    const Lines oldLines = hashLines(from, threads);
+    const Lines newLines = hashLines(to, threads);
+    const size_t n = oldLines.size(), m = newLines.size();
+
+    LineClasses           classes;
+    std::vector<uint32_t> a(n), b(m);
+    for (size_t x = 0; x < n; ++x) { a[x] = classes.classOf(oldLines.at(x), oldLines.hashes[x]); }
+    for (size_t y = 0; y < m; ++y) { b[y] = classes.classOf(newLines.at(y), newLines.hashes[y]); }
+
+    Region middle{ 0, n, 0, m };
+    while (middle.xoff < n && middle.yoff < m && a[middle.xoff] == b[middle.yoff]) {
+        ++middle.xoff, ++middle.yoff;
+    }
+    while (middle.xlim > middle.xoff && middle.ylim > middle.yoff
+           && a[middle.xlim - 1] == b[middle.ylim - 1]) {
+        --middle.xlim, --middle.ylim;
+    }
+
+    // Regions are handed out in batches of about equal lines.
+    const std::vector<Region> parts = regions(a, b, middle, classes.size());
+    std::vector<uint8_t>      deleted(n), inserted(m);
+    std::vector<size_t>       batches{ 0 };
+
+    const size_t total = (middle.xlim - middle.xoff) + (middle.ylim - middle.yoff);
+    size_t       sum   = 0;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        sum += (parts[i].xlim - parts[i].xoff) + (parts[i].ylim - parts[i].yoff);
+        if (sum * threads * 4 >= total * batches.size() || i + 1 == parts.size()) {
+            batches.push_back(i + 1);
+        }
+    }
+
+    parallel(batches.size() - 1, threads, [&](size_t batch) {
+        Myers myers(a.data(), b.data(), deleted.data(), inserted.data());
+        for (size_t i = batches[batch]; i < batches[batch + 1]; ++i) {
+            myers.compare(parts[i].xoff, parts[i].xlim, parts[i].yoff, parts[i].ylim);
+        }
+    });
+
+    // Runs of deleted & inserted lines meeting at the same place form a hunk.
+    std::vector<DiffHunk> hunks;
+    for (size_t x = 0, y = 0; x < n || y < m;) {
+        if ((x == n || !deleted[x]) && (y == m || !inserted[y])) {
+            ++x, ++y;
+            continue;
+        }
+
+        const size_t x0 = x, y0 = y;
+        while ((x < n && deleted[x]) || (y < m && inserted[y])) {
+            while (x < n && deleted[x]) { ++x; }
+            while (y < m && inserted[y]) { ++y; }
+        }
+
+        hunks.push_back(
+          { .oldStart = positionAt(from, oldLines, x0),
+            .oldEnd   = positionAt(from, oldLines, x),
+            .newStart = positionAt(to, newLines, y0),
+            .newEnd   = positionAt(to, newLines, y),
+            .oldLines = x - x0,
+            .newLines = y - y0 });
+    }
+    return hunks;
+}
+
+}  // namespace Text
@@ -0,0 +1,524 @@
+#include <text/buffer.hpp>
+#include <text/json-index.hpp>
+#include <text/trace.hpp>
+#include <utils/exception.hpp>
+#include <utils/raise.hpp>
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define TEXT_BUFFER_JSON_SSE2 1
+#else
+#    define TEXT_BUFFER_JSON_SSE2 0
+#endif
+
+using namespace Text_Buffer;
+
+namespace Text {
+
+namespace {
+
+    constexpr size_t   BLOCK     = 64;
+    constexpr uint64_t EVEN_BITS = 0x5555555555555555;
+    constexpr uint64_t ODD_BITS  = ~EVEN_BITS;
+
+
+    /******************************************************************
+     * One bit per byte of a 64-byte block, bit i describing byte i.
+     ******************************************************************/
+    struct BlockMasks
+    {
+        uint64_t quote     = 0;
+        uint64_t backslash = 0;
+        uint64_t op        = 0;  /// { } [ ] : ,
+        uint64_t space     = 0;  /// Space, tab, line feed & carriage return
+        uint64_t control   = 0;  /// Bytes below 0x20
+    };
+
+
+#if TEXT_BUFFER_JSON_SSE2
+
+    BlockMasks classify(const char *block) noexcept
+    {
+        const __m128i quote     = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i lower     = _mm_set1_epi8(0x20);  // Folds '[' & ']' onto '{' & '}'
+        const __m128i brace     = _mm_set1_epi8('{');
+        const __m128i close     = _mm_set1_epi8('}');
+        const __m128i colon     = _mm_set1_epi8(':');
+        const __m128i comma     = _mm_set1_epi8(',');
+        const __m128i space     = _mm_set1_epi8(' ');
+        const __m128i tab       = _mm_set1_epi8('\t');
+        const __m128i feed      = _mm_set1_epi8('\n');
+        const __m128i ret       = _mm_set1_epi8('\r');
+        const __m128i control   = _mm_set1_epi8(0x1F);
+
+        const auto bits = [](__m128i lanes) {
+            return uint64_t(uint32_t(_mm_movemask_epi8(lanes)));
+        };
+
+        BlockMasks masks;
+        for (unsigned i = 0; i < BLOCK / 16; ++i) {
+            const auto    *lanes  = reinterpret_cast<const __m128i *>(block) + i;
+            const __m128i  v      = _mm_loadu_si128(lanes);
+            const __m128i  folded = _mm_or_si128(v, lower);
+            const unsigned shift  = 16 * i;
+
+            const __m128i braces =
+              _mm_or_si128(_mm_cmpeq_epi8(folded, brace), _mm_cmpeq_epi8(folded, close));
+            const __m128i marks  = _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma));
+            const __m128i blanks = _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab));
+            const __m128i breaks = _mm_or_si128(_mm_cmpeq_epi8(v, feed), _mm_cmpeq_epi8(v, ret));
+
+            masks.quote |= bits(_mm_cmpeq_epi8(v, quote)) << shift;
+            masks.backslash |= bits(_mm_cmpeq_epi8(v, backslash)) << shift;
+            masks.op |= bits(_mm_or_si128(braces, marks)) << shift;
+            masks.space |= bits(_mm_or_si128(blanks, breaks)) << shift;
+            masks.control |= bits(_mm_cmpeq_epi8(_mm_min_epu8(v, control), v)) << shift;
+        }
+        return masks;
+    }
+
+#else
+
+    enum : uint8_t { QUOTE = 1, BACKSLASH = 2, OP = 4, SPACE = 8, CONTROL = 16 };
+
+
+    constexpr std::array<uint8_t, 256> BYTE_CLASSES = [] {
+        std::array<uint8_t, 256> classes{};
+        for (size_t c = 0; c < 0x20; ++c) { classes[c] = CONTROL; }
+        for (const char c : std::string_view("{}[]:,")) { classes[uint8_t(c)] = OP; }
+        for (const char c : std::string_view(" \t\n\r")) { classes[uint8_t(c)] |= SPACE; }
+        classes['"']  = QUOTE;
+        classes['\\'] = BACKSLASH;
+        return classes;
+    }();
+
+
+    BlockMasks classify(const char *block) noexcept
+    {
+        BlockMasks masks;
+        for (unsigned i = 0; i < BLOCK; ++i) {
+            const uint8_t kind = BYTE_CLASSES[static_cast<unsigned char>(block[i])];
+            masks.quote |= uint64_t((kind & QUOTE) != 0) << i;
+            masks.backslash |= uint64_t((kind & BACKSLASH) != 0) << i;
+            masks.op |= uint64_t((kind & OP) != 0) << i;
+            masks.space |= uint64_t((kind & SPACE) != 0) << i;
+            masks.control |= uint64_t((kind & CONTROL) != 0) << i;
+        }
+        return masks;
+    }
+
+#endif
+
+
+    /******************************************************************
+     * @returns <uint64_t> The bytes preceded by an odd-length run of
+     *   backslashes, i.e. the escaped ones. `carry` is 1 if the block
+     *   before ended in such a run & is updated for the next block.
+     ******************************************************************/
+    uint64_t escaped(uint64_t backslash, uint64_t &carry) noexcept
+    {
+        const uint64_t starts    = backslash & ~(backslash << 1);
+        const uint64_t evenMask  = EVEN_BITS ^ carry;  // A run continued from before flips parity
+        const uint64_t evenStart = starts & evenMask;
+        const uint64_t oddStart  = starts & ~evenMask;
+
+        const uint64_t evenEnds = (backslash + evenStart) & ~backslash;
+        uint64_t       oddCarries = backslash + oddStart;
+        const bool     overflow   = oddCarries < backslash;
+
+        oddCarries |= carry;
+        carry = overflow ? 1 : 0;
+
+        const uint64_t oddEnds = oddCarries & ~backslash;
+        return (evenEnds & ODD_BITS) | (oddEnds & EVEN_BITS);
+    }
+
+
+    /******************************************************************
+     * @returns <uint64_t> Bit i set if an odd number of bits up to &
+     *   including bit i are set.
+     ******************************************************************/
+    constexpr uint64_t prefixXor(uint64_t bits) noexcept
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+
+    constexpr bool isDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+
+    constexpr bool isHex(char c) noexcept
+    { return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); }
+
+
+    /******************************************************************
+     * @returns <size_t> End of the number or literal starting at `at`:
+     *   the first whitespace, structural character or quote after it.
+     ******************************************************************/
+    size_t atomEnd(std::string_view text, size_t at) noexcept
+    {
+        while (at < text.size()) {
+            switch (text[at]) {
+                case ' ': case '\t': case '\n': case '\r':
+                case '{': case '}': case '[': case ']': case ':': case ',': case '"': return at;
+                default: ++at;
+            }
+        }
+        return at;
+    }
+
+
+    /******************************************************************
+     * Check the string whose opening quote is at `at`. Escapes only
+     * need checking where `memchr` finds a backslash.
+     * @returns <std::pair<JsonError, size_t>> The first error in the
+     *   string & its offset, or NONE.
+     ******************************************************************/
+    std::pair<JsonError, size_t> checkString(std::string_view text, size_t at) noexcept
+    {
+        const char *data = text.data();
+        size_t      from = at + 1;
+
+        while (true) {
+            const void *quote = std::memchr(data + from, '"', text.size() - from);
+            if (quote == nullptr) { return { JsonError::UNTERMINATED_STRING, at }; }
+
+            const size_t close = size_t(static_cast<const char *>(quote) - data);
+            const void  *slash = std::memchr(data + from, '\\', close - from);
+            if (slash == nullptr) { return { JsonError::NONE, 0 }; }
+
+            size_t i = size_t(static_cast<const char *>(slash) - data);
+            while (i < close) {
+                if (text[i] != '\\') {
+                    ++i;
+                    continue;
+                }
+                if (i + 1 == close) { break; }  // The quote is escaped
+
+                switch (text[i + 1]) {
+                    case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                        i += 2;
+                        break;
+
+                    case 'u':
+                        if (i + 6 > text.size() || !isHex(text[i + 2]) || !isHex(text[i + 3])
+                            || !isHex(text[i + 4]) || !isHex(text[i + 5])) {
+                            return { JsonError::INVALID_ESCAPE, i };
+                        }
+                        i += 6;
+                        break;
+
+                    default: return { JsonError::INVALID_ESCAPE, i };
+                }
+            }
+
+            if (i >= close) { return { JsonError::NONE, 0 }; }
+            from = close + 1;
+        }
+    }
+
+
+    /******************************************************************
+     * @returns <bool> Whether `atom` is a JSON number:
+     *   -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+     ******************************************************************/
+    bool isNumber(std::string_view atom) noexcept
+    {
+        size_t i = 0;
+        const auto digits = [&] {
+            const size_t from = i;
+            while (i < atom.size() && isDigit(atom[i])) { ++i; }
+            return i > from;
+        };
+
+        if (i < atom.size() && atom[i] == '-') { ++i; }
+        if (i < atom.size() && atom[i] == '0') { ++i; }
+        else if (!digits()) { return false; }
+
+        if (i < atom.size() && atom[i] == '.') {
+            ++i;
+            if (!digits()) { return false; }
+        }
+        if (i < atom.size() && (atom[i] == 'e' || atom[i] == 'E')) {
+            ++i;
+            if (i < atom.size() && (atom[i] == '+' || atom[i] == '-')) { ++i; }
+            if (!digits()) { return false; }
+        }
+        return i == atom.size();
+    }
+
+}  // namespace
+
+
+
+
+
+
+/**********************************************************************
+ * Index & validate the text of `source`.
+ * @throws <Exception> OUT_OF_RANGE if the text is 4 GiB or larger.
+ **********************************************************************/
+JsonIndex::JsonIndex(const Buffer &source)
+: buffer(&source)
+{
+    const std::string_view text = source.text();
+
+    if (text.size() >= std::numeric_limits<uint32_t>::max()) {
+        raise_error(generate_out_of_range_exception(
+          "A JSON document of {} bytes is too large to index.", text.size()));
+    }
+
+    const TraceSpan span("json.index", text.size());
+
+    uint64_t escapeCarry = 0;  // Previous block ended in an odd run of backslashes
+    uint64_t inString    = 0;  // Previous block ended inside a string (all ones)
+    uint64_t scalarCarry = 0;  // Previous block ended inside a number or literal
+    size_t   controlAt   = text.size();
+
+    // One bit per block holding a backslash inside a string; stage two only
+    // re-reads strings overlapping such blocks.
+    std::vector<uint64_t>   escapes(text.size() / (BLOCK * 64) + 1);
+    std::array<char, BLOCK> tail;
+
+    tape.reserve(text.size() / 4 + BLOCK);  // Grown geometrically for denser documents
+
+    for (size_t base = 0; base < text.size(); base += BLOCK) {
+        const char *block = text.data() + base;
+
+        if (text.size() - base < BLOCK) {
+            tail.fill(' ');
+            std::memcpy(tail.data(), block, text.size() - base);
+            block = tail.data();
+        }
+
+        const BlockMasks masks  = classify(block);
+        const uint64_t   quotes = masks.quote & ~escaped(masks.backslash, escapeCarry);
+        const uint64_t   inside = prefixXor(quotes) ^ inString;  // Opening quotes & contents
+        inString = uint64_t(int64_t(inside) >> 63);
+
+        const uint64_t strings = inside | quotes;
+        const uint64_t scalars = ~(masks.op | masks.space | strings);
+        const uint64_t starts  = scalars & ~((scalars << 1) | scalarCarry);
+        scalarCarry = scalars >> 63;
+
+        uint64_t structural = (masks.op & ~strings) | (quotes & inside) | starts;
+
+        const uint64_t control = masks.control & inside;
+        if (control != 0 && controlAt == text.size()) {
+            controlAt = base + size_t(std::countr_zero(control));
+        }
+        if ((masks.backslash & inside) != 0) {
+            escapes[base / (BLOCK * 64)] |= uint64_t(1) << (base / BLOCK % 64);
+        }
+
+        const size_t count = size_t(std::popcount(structural));
+        const size_t used  = tape.size();
+        if (tape.capacity() - used < count) { tape.reserve(tape.capacity() * 2); }
+        tape.resize(used + count);
+
+        uint32_t *out = tape.data() + used;
+        while (structural != 0) {
+            *out++ = uint32_t(base + size_t(std::countr_zero(structural)));
+            structural &= structural - 1;
+        }
+    }
+
+    validate(text, escapes, inString != 0);
+    if (controlAt < text.size()) { fail(JsonError::CONTROL_CHARACTER, controlAt); }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <Position> Position of the `index`th tape entry, resolved
+ *   through the Buffer's line index.
+ * @throws <Exception> OUT_OF_RANGE if `index` is past the tape.
+ **********************************************************************/
+Position JsonIndex::position(size_t index) const
+{
+    if (index >= tape.size()) {
+        raise_error(generate_out_of_range_exception(
+          "Index {} is past the end of the {} tape entries.", index, tape.size()));
+    }
+
+    return buffer->positionOf(size_t(tape[index]));
+}
+
+
+/**********************************************************************
+ * Resolve `out.size()` tape entries from `first` on in one sweep of
+ * the line index.
+ * @throws <Exception> OUT_OF_RANGE if the entries run past the tape.
+ **********************************************************************/
+void JsonIndex::positions(size_t first, std::span<Position> out) const
+{
+    if (first > tape.size() || out.size() > tape.size() - first) {
+        raise_error(generate_out_of_range_exception(
+          "Entries {} to {} are past the end of the {} tape entries.",
+          first,
+          first + out.size(),
+          tape.size()));
+    }
+
+    std::array<size_t, 256> chunk;
+    for (size_t done = 0; done < out.size(); done += chunk.size()) {
+        const size_t count = std::min(chunk.size(), out.size() - done);
+        for (size_t i = 0; i < count; ++i) { chunk[i] = tape[first + done + i]; }
+        buffer->positionsOf(std::span(chunk.data(), count), out.subspan(done, count));
+    }
+}
+
+
+/**********************************************************************
+ * @returns <Position> Position of the first syntax error.
+ * @throws <Exception> OUT_OF_RANGE if the document is valid.
+ **********************************************************************/
+Position JsonIndex::errorPosition() const
+{
+    if (ok()) {
+        raise_error(generate_out_of_range_exception("The JSON document has no syntax error."));
+    }
+
+    return buffer->positionOf(errorAt);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Record a syntax error unless one was found earlier in the text.
+ **********************************************************************/
+void JsonIndex::fail(JsonError error, size_t offset) noexcept
+{
+    if (code == JsonError::NONE || offset < errorAt) {
+        code    = error;
+        errorAt = offset;
+    }
+}
+
+
+/**********************************************************************
+ * Walk the tape as a pushdown automaton over the JSON grammar,
+ * checking each number, literal & string the tape points at, & stop
+ * at the first error.
+ * @param escapes Bitmap of the blocks with backslashes in strings.
+ * @param unterminated Whether the text ends inside a string, which
+ *   then starts at the last tape entry.
+ **********************************************************************/
+void JsonIndex::validate(std::string_view text, std::span<const uint64_t> escapes, bool unterminated)
+{
+    enum class Expect : uint8_t { VALUE, VALUE_OR_CLOSE, KEY, KEY_OR_CLOSE, COLON, NEXT, END };
+
+    std::vector<char> containers;
+    Expect            expect = Expect::VALUE;
+
+    const auto valueDone = [&] { expect = containers.empty() ? Expect::END : Expect::NEXT; };
+    const auto wantValue = [&] {
+        return expect == Expect::VALUE || expect == Expect::VALUE_OR_CLOSE;
+    };
+
+    const auto hasEscapes = [&](size_t from, size_t to) {
+        for (size_t block = from / BLOCK; block <= (to - 1) / BLOCK; ++block) {
+            if ((escapes[block / 64] >> (block % 64)) & 1) { return true; }
+        }
+        return false;
+    };
+
+    for (size_t i = 0; i < tape.size(); ++i) {
+        const size_t at = tape[i];
+        const char   c  = text[at];
+
+        if (expect == Expect::END) { return fail(JsonError::TRAILING_CONTENT, at); }
+
+        switch (c) {
+            case '{':
+            case '[':
+                if (!wantValue()) { return fail(JsonError::UNEXPECTED_CHARACTER, at); }
+                containers.push_back(c);
+                expect = c == '{' ? Expect::KEY_OR_CLOSE : Expect::VALUE_OR_CLOSE;
+                break;
+
+            case '}':
+            case ']': {
+                const char open = c == '}' ? '{' : '[';
+                const bool empty =
+                  expect == (c == '}' ? Expect::KEY_OR_CLOSE : Expect::VALUE_OR_CLOSE);
+
+                if ((expect != Expect::NEXT && !empty) || containers.back() != open) {
+                    return fail(JsonError::UNEXPECTED_CHARACTER, at);
+                }
+                containers.pop_back();
+                valueDone();
+                break;
+            }
+
+            case ':':
+                if (expect != Expect::COLON) { return fail(JsonError::UNEXPECTED_CHARACTER, at); }
+                expect = Expect::VALUE;
+                break;
+
+            case ',':
+                if (expect != Expect::NEXT) { return fail(JsonError::UNEXPECTED_CHARACTER, at); }
+                expect = containers.back() == '{' ? Expect::KEY : Expect::VALUE;
+                break;
+
+            case '"': {
+                const bool key = expect == Expect::KEY || expect == Expect::KEY_OR_CLOSE;
+                if (!key && !wantValue()) { return fail(JsonError::UNEXPECTED_CHARACTER, at); }
+
+                if (unterminated && i + 1 == tape.size()) {
+                    return fail(JsonError::UNTERMINATED_STRING, at);
+                }
+
+                // The string closes before the next tape entry.
+                const size_t end = i + 1 < tape.size() ? tape[i + 1] : text.size();
+                if (hasEscapes(at, end)) {
+                    if (const auto [error, offset] = checkString(text, at); error != JsonError::NONE) {
+                        return fail(error, offset);
+                    }
+                }
+
+                if (key) { expect = Expect::COLON; }
+                else { valueDone(); }
+                break;
+            }
+
+            default: {
+                if (!wantValue()) { return fail(JsonError::UNEXPECTED_CHARACTER, at); }
+
+                const std::string_view atom = text.substr(at, atomEnd(text, at) - at);
+                if (c == '-' || isDigit(c)) {
+                    if (!isNumber(atom)) { return fail(JsonError::INVALID_NUMBER, at); }
+                }
+                else if (atom != "true" && atom != "false" && atom != "null") {
+                    return fail(JsonError::INVALID_LITERAL, at);
+                }
+                valueDone();
+            }
+        }
+    }
+
+    if (tape.empty()) { fail(JsonError::EMPTY_DOCUMENT, text.size()); }
+    else if (expect != Expect::END) { fail(JsonError::UNEXPECTED_END, text.size()); }
+}
+
+}  // namespace Text
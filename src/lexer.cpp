@@ -0,0 +1,338 @@
+#include <text/buffer.hpp>
+#include <text/lexer.hpp>
+#include <utils/exception.hpp>
+#include <utils/raise.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <limits>
+
+using namespace Text_Buffer;
+
+namespace Text {
+
+/**********************************************************************
+ * @param unknownKind Kind of the one-byte tokens made of bytes no
+ *   rule matches.
+ **********************************************************************/
+Lexicon::Lexicon(TokenKind unknownKind)
+: unknown(unknownKind)
+{}
+
+
+
+
+
+
+/**********************************************************************
+ * Add a rule matching a byte of `first` followed by any number of
+ * bytes of `rest`, e.g. identifiers, numbers & whitespace.
+ * @returns <Lexicon&> *this, so rules can be chained.
+ **********************************************************************/
+Lexicon &Lexicon::run(TokenKind kind, const CharSet &first, const CharSet &rest)
+{
+    const bool lines = first.contains('\n') || rest.contains('\n');
+    return add(
+      Rule{ .type = RuleType::RUN, .kind = kind, .rest = rest, .multiline = lines }, first);
+}
+
+
+/**********************************************************************
+ * Add a rule matching `text` exactly, e.g. operators.
+ * @throws <Exception> OUT_OF_RANGE if `text` is empty.
+ **********************************************************************/
+Lexicon &Lexicon::literal(TokenKind kind, std::string_view text)
+{
+    if (text.empty()) {
+        raise_error(generate_out_of_range_exception("A literal rule needs at least one byte."));
+    }
+
+    const auto first = CharSet::of(text.substr(0, 1));
+    return add(
+      Rule{ .type      = RuleType::LITERAL,
+            .kind      = kind,
+            .open      = std::string(text),
+            .multiline = text.find('\n') != std::string_view::npos },
+      first);
+}
+
+
+/**********************************************************************
+ * Add a rule matching text between two `quote`s. A `quote` preceded
+ * by `escape` does not close the token. Unless `multiline` is set an
+ * unterminated token ends before the line break; otherwise it runs
+ * to the end of the text.
+ **********************************************************************/
+Lexicon &Lexicon::quoted(TokenKind kind, char quote, char escape, bool multiline)
+{
+    const auto first = CharSet::of(std::string_view(&quote, 1));
+    return add(
+      Rule{ .type      = RuleType::QUOTED,
+            .kind      = kind,
+            .quote     = quote,
+            .escape    = escape,
+            .multiline = multiline },
+      first);
+}
+
+
+/**********************************************************************
+ * Add a rule matching `prefix` & the rest of its line, excluding the
+ * line break.
+ * @throws <Exception> OUT_OF_RANGE if `prefix` is empty.
+ **********************************************************************/
+Lexicon &Lexicon::lineComment(TokenKind kind, std::string_view prefix)
+{
+    if (prefix.empty()) {
+        raise_error(generate_out_of_range_exception("A line comment needs a prefix."));
+    }
+
+    const auto first = CharSet::of(prefix.substr(0, 1));
+    return add(
+      Rule{ .type      = RuleType::LINE,
+            .kind      = kind,
+            .open      = std::string(prefix),
+            .multiline = prefix.find('\n') != std::string_view::npos },
+      first);
+}
+
+
+/**********************************************************************
+ * Add a rule matching `open` up to & including the next `close`. An
+ * unterminated comment runs to the end of the text.
+ * @throws <Exception> OUT_OF_RANGE if `open` or `close` is empty.
+ **********************************************************************/
+Lexicon &Lexicon::blockComment(TokenKind kind, std::string_view open, std::string_view close)
+{
+    if (open.empty() || close.empty()) {
+        raise_error(generate_out_of_range_exception("A block comment needs both delimiters."));
+    }
+
+    const auto first = CharSet::of(open.substr(0, 1));
+    return add(
+      Rule{ .type      = RuleType::BLOCK,
+            .kind      = kind,
+            .open      = std::string(open),
+            .close     = std::string(close),
+            .multiline = true },
+      first);
+}
+
+
+/**********************************************************************
+ * Drop tokens of `kind` (e.g. whitespace & comments) from the output
+ * of Lexers using this Lexicon. Their bytes still advance Positions.
+ **********************************************************************/
+Lexicon &Lexicon::skip(TokenKind kind)
+{
+    if (kind < 64) { skipMask |= uint64_t(1) << kind; }
+    else if (!skips(kind)) { skipped.push_back(kind); }
+    return *this;
+}
+
+
+Lexicon &Lexicon::add(Rule rule, const CharSet &first)
+{
+    if (rules.size() > std::numeric_limits<uint16_t>::max()) {
+        raise_error(generate_out_of_range_exception(
+          "A Lexicon holds at most {} rules.", rules.size()));
+    }
+
+    const auto index = uint16_t(rules.size());
+    reach            = std::max(reach, rule.open.size());
+    rules.push_back(std::move(rule));
+
+    for (size_t c = 0; c < 256; ++c) {
+        if (first.contains(static_cast<unsigned char>(c))) { byFirst[c].push_back(index); }
+    }
+    return *this;
+}
+
+
+
+
+
+
+bool Lexicon::skips(TokenKind kind) const noexcept
+{
+    if (kind < 64) { return (skipMask >> kind) & 1; }
+    return std::find(skipped.begin(), skipped.end(), kind) != skipped.end();
+}
+
+
+/**********************************************************************
+ * @param rest Non-empty text starting at the token to match.
+ * @returns <Match> Length & kind of the longest token at the front of
+ *   `rest`; at least one byte long.
+ **********************************************************************/
+Lexicon::Match Lexicon::match(std::string_view rest) const noexcept
+{
+    Match  best{ 1, unknown, rest.front() == '\n' };
+    size_t longest = 0;
+
+    for (const uint16_t index : byFirst[static_cast<unsigned char>(rest.front())]) {
+        const Rule  &rule = rules[index];
+        const size_t n    = length(rule, rest);
+
+        if (n > longest) {
+            longest = n;
+            best    = { n, rule.kind, rule.multiline };
+        }
+    }
+    return best;
+}
+
+
+size_t Lexicon::length(const Rule &rule, std::string_view rest) const noexcept
+{
+    switch (rule.type) {
+        case RuleType::RUN: {
+            size_t n = 1;
+            while (n < rest.size() && rule.rest.contains(static_cast<unsigned char>(rest[n]))) {
+                ++n;
+            }
+            return n;
+        }
+
+        case RuleType::LITERAL: return rest.starts_with(rule.open) ? rule.open.size() : 0;
+
+        case RuleType::QUOTED: {
+            size_t n = 1;
+            while (n < rest.size()) {
+                const char c = rest[n];
+                if (c == rule.quote) { return n + 1; }
+                if (c == '\n' && !rule.multiline) { return n; }
+                if (c != rule.escape || rule.escape == 0) {
+                    ++n;
+                    continue;
+                }
+                if (!rule.multiline && n + 1 < rest.size() && rest[n + 1] == '\n') { return n + 1; }
+                n += 2;
+            }
+            return rest.size();
+        }
+
+        case RuleType::LINE: {
+            if (!rest.starts_with(rule.open)) { return 0; }
+            const size_t eol = rest.find('\n', rule.open.size());
+            return eol == std::string_view::npos ? rest.size() : eol;
+        }
+
+        case RuleType::BLOCK: {
+            if (!rest.starts_with(rule.open)) { return 0; }
+            const size_t close = rest.find(rule.close, rule.open.size());
+            return close == std::string_view::npos ? rest.size() : close + rule.close.size();
+        }
+    }
+    return 0;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Lex `source` from its start.
+ * @param rules Must outlive the Lexer.
+ **********************************************************************/
+Lexer::Lexer(std::string_view source, const Lexicon &rules)
+: text(source)
+, lexicon(&rules)
+, at(0)
+, row(1)
+, lineStart(0)
+{}
+
+
+/**********************************************************************
+ * Lex the text of `buffer`. Edits to the Buffer invalidate the Lexer
+ * & the tokens it produced.
+ **********************************************************************/
+Lexer::Lexer(const Buffer &buffer, const Lexicon &rules)
+: Lexer(buffer.text(), rules)
+{}
+
+
+/**********************************************************************
+ * Resume lexing `source` at `offset`, which is at `pos`.
+ * @throws <Exception> OUT_OF_RANGE if `offset` is past the end of
+ *   `source` or `pos` puts it before the start of its line.
+ **********************************************************************/
+Lexer::Lexer(std::string_view source, const Lexicon &rules, size_t offset, const Position &pos)
+: Lexer(source, rules)
+{
+    const size_t col = pos.getCol().get();
+
+    if (offset > source.size() || col - 1 > offset) {
+        raise_error(generate_out_of_range_exception(
+          "Offset {} cannot be at column {}.", offset, col));
+    }
+
+    at        = offset;
+    row       = pos.getRow().get();
+    lineStart = offset - (col - 1);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Produce the next token that is not skipped.
+ * @returns <bool> False once the text is exhausted; `token` is then
+ *   left unchanged.
+ **********************************************************************/
+bool Lexer::next(Token &token) noexcept
+{
+    while (at < text.size()) {
+        const size_t         from  = at;
+        const Lexicon::Match match = lexicon->match(text.substr(from));
+
+        if (lexicon->skips(match.kind)) {
+            advance(from + match.length, match.lines);
+            continue;
+        }
+
+        token.kind   = match.kind;
+        token.text   = text.substr(from, match.length);
+        token.offset = from;
+        token.start  = position();
+        advance(from + match.length, match.lines);
+        token.end = position();
+        return true;
+    }
+    return false;
+}
+
+
+/**********************************************************************
+ * @returns <Position> Position of the next token's first byte.
+ **********************************************************************/
+Position Lexer::position() const noexcept
+{
+    return Position::unchecked(row, at - lineStart + 1);
+}
+
+
+void Lexer::advance(size_t to, bool lines) noexcept
+{
+    if (!lines) {
+        at = to;
+        return;
+    }
+
+    const char *base = text.data();
+    const char *p    = base + at;
+    const char *end  = base + to;
+
+    while ((p = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)))) != nullptr) {
+        ++row;
+        lineStart = size_t(++p - base);
+    }
+    at = to;
+}
+
+}  // namespace Text
@@ -0,0 +1,447 @@
+#include <text/marker.hpp>
+#include <utils/exception.hpp>
+#include <utils/raise.hpp>
+
+#include <format>
+
+using namespace Text_Buffer;
+
+namespace Text {
+
+/**********************************************************************
+ * Add a Marker at `offset`.
+ * @param offset Byte offset the Marker is anchored to.
+ * @param gravity Side of an insertion at `offset` the Marker sticks to.
+ * @returns <MarkerId> Handle of the new Marker. Handles of removed
+ *   Markers are recycled.
+ **********************************************************************/
+MarkerId MarkerTree::add(size_t offset, Gravity gravity)
+{
+    MarkerId id;
+
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else {
+        id = MarkerId(nodes.size());
+        nodes.emplace_back();
+    }
+
+    Node &node    = nodes[id];
+    node          = Node{};
+    node.offset   = offset;
+    node.gravity  = gravity;
+    node.priority = nextPriority();
+    node.live     = true;
+
+    uint32_t &root = roots[size_t(gravity)];
+    uint32_t  lo, hi;
+
+    split(root, offset, true, lo, hi);
+    root = merge(merge(lo, id), hi);
+    nodes[root].parent = NIL;
+    counters.add(Stat::TREE_SPLITS);
+    counters.add(Stat::TREE_MERGES, 2);
+
+    ++count;
+    return id;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Remove a Marker.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live Marker.
+ **********************************************************************/
+void MarkerTree::remove(MarkerId id)
+{
+    check(id);
+    pushPath(id);
+    push(id);
+
+    Node          &node   = nodes[id];
+    const uint32_t parent = node.parent;
+    const uint32_t joined = merge(node.left, node.right);
+    counters.add(Stat::TREE_MERGES);
+
+    if (parent == NIL) {
+        roots[size_t(node.gravity)] = joined;
+    }
+    else if (nodes[parent].left == id) {
+        nodes[parent].left = joined;
+    }
+    else {
+        nodes[parent].right = joined;
+    }
+
+    if (joined != NIL) { nodes[joined].parent = parent; }
+
+    node.live = false;
+    freeIds.push_back(id);
+    --count;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <bool> true if `id` refers to a live Marker.
+ **********************************************************************/
+bool MarkerTree::contains(MarkerId id) const noexcept
+{ return id < nodes.size() && nodes[id].live; }
+
+
+
+
+
+
+/**********************************************************************
+ * Get the current offset of a Marker. The pending tags of its
+ * ancestors are applied to a copy of its offset, nearest first, in
+ * O(log n); nothing is pushed down, so readers may share the tree.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live Marker.
+ **********************************************************************/
+size_t MarkerTree::offsetOf(MarkerId id) const
+{
+    check(id);
+
+    // A tag is always newer than the tags of the nodes below it.
+    size_t offset = nodes[id].offset;
+    for (uint32_t n = nodes[id].parent; n != NIL; n = nodes[n].parent) {
+        const Node &node = nodes[n];
+        if (node.pending) { offset = size_t(int64_t(node.mul ? offset : 0) + node.add); }
+    }
+    return offset;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live Marker.
+ **********************************************************************/
+Gravity MarkerTree::gravityOf(MarkerId id) const
+{
+    check(id);
+    return nodes[id].gravity;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> The number of live Markers.
+ **********************************************************************/
+size_t MarkerTree::size() const noexcept { return count; }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> Heap bytes held by the tree, including the slots
+ *   of removed Markers kept for reuse.
+ **********************************************************************/
+size_t MarkerTree::memoryUsage() const noexcept
+{
+    return nodes.capacity() * sizeof(Node) + freeIds.capacity() * sizeof(uint32_t);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Release spare capacity: trailing slots of removed Markers are
+ * dropped (their ids are no longer recycled) & the arrays shrunk.
+ **********************************************************************/
+void MarkerTree::shrinkToFit()
+{
+    while (!nodes.empty() && !nodes.back().live) { nodes.pop_back(); }
+
+    const auto limit = uint32_t(nodes.size());
+    std::erase_if(freeIds, [limit](uint32_t id) { return id >= limit; });
+
+    // Exact-size copies swapped in; see Buffer::shrinkToFit() for why not shrink_to_fit().
+    decltype(nodes)(nodes).swap(nodes);
+    decltype(freeIds)(freeIds).swap(freeIds);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Remove every Marker.
+ **********************************************************************/
+void MarkerTree::clear() noexcept
+{
+    nodes.clear();
+    freeIds.clear();
+    roots[0] = roots[1] = NIL;
+    count               = 0;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Append the ids of all Markers whose offset is in [from, to] to
+ * `out`, ordered by offset within each gravity.
+ **********************************************************************/
+void MarkerTree::collect(size_t from, size_t to, std::vector<MarkerId> &out)
+{
+    collect(roots[0], from, to, out);
+    collect(roots[1], from, to, out);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Update every Marker for the replacement of `length` bytes at
+ * `offset` with `inserted` bytes. Markers inside the replaced range
+ * collapse onto its start (LEFT) or the end of the new text (RIGHT);
+ * Markers after it shift by the difference in length.
+ **********************************************************************/
+void MarkerTree::replace(size_t offset, size_t length, size_t inserted)
+{
+    const auto delta = int64_t(inserted) - int64_t(length);
+
+    for (size_t g = 0; g < 2; ++g) {
+        const bool right = g == size_t(Gravity::RIGHT);
+        uint32_t   before, middle, after, rest;
+
+        // LEFT markers at `offset` stay put, RIGHT markers follow the
+        // inserted text. Both shift if they sit at the end of the range.
+        split(roots[g], offset, !right, before, rest);
+        split(rest, offset + length, false, middle, after);
+
+        apply(middle, false, int64_t(right ? offset + inserted : offset));
+        apply(after, true, delta);
+
+        roots[g] = merge(merge(before, middle), after);
+        if (roots[g] != NIL) { nodes[roots[g]].parent = NIL; }
+    }
+
+    counters.add(Stat::TREE_SPLITS, 4);
+    counters.add(Stat::TREE_MERGES, 4);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * @returns <uint32_t> A pseudo-random treap priority (xorshift32).
+ **********************************************************************/
+uint32_t MarkerTree::nextPriority() noexcept
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Apply the affine tag `offset * mul + add` to node `n` & record it as
+ * pending for its children.
+ **********************************************************************/
+void MarkerTree::apply(uint32_t n, bool mul, int64_t add) noexcept
+{
+    if (n == NIL) { return; }
+
+    Node &node  = nodes[n];
+    node.offset = size_t(int64_t(mul ? node.offset : 0) + add);
+
+    // Composing with an existing tag: (v * m1 + a1) * m2 + a2
+    node.add     = (mul ? node.add : 0) + add;
+    node.mul     = node.mul && mul;
+    node.pending = true;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Push the pending tag of node `n` down to its children.
+ **********************************************************************/
+void MarkerTree::push(uint32_t n) noexcept
+{
+    Node &node = nodes[n];
+    if (!node.pending) { return; }
+
+    apply(node.left, node.mul, node.add);
+    apply(node.right, node.mul, node.add);
+
+    node.add     = 0;
+    node.mul     = true;
+    node.pending = false;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Push the pending tags of every ancestor of node `n` down, from the
+ * root towards `n`, so that the offset stored in `n` is current.
+ **********************************************************************/
+void MarkerTree::pushPath(uint32_t n) noexcept
+{
+    const uint32_t parent = nodes[n].parent;
+    if (parent == NIL) { return; }
+
+    pushPath(parent);
+    push(parent);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Re-point the parent links of node `n`'s children at `n`.
+ **********************************************************************/
+void MarkerTree::attach(uint32_t n) noexcept
+{
+    if (nodes[n].left != NIL) { nodes[nodes[n].left].parent = n; }
+    if (nodes[n].right != NIL) { nodes[nodes[n].right].parent = n; }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Split treap `n` into `lo` & `hi`. With `inclusive` set, `lo` takes
+ * the nodes whose offset is <= `key`, otherwise those < `key`.
+ **********************************************************************/
+void MarkerTree::split(uint32_t n, size_t key, bool inclusive, uint32_t &lo, uint32_t &hi)
+{
+    if (n == NIL) {
+        lo = hi = NIL;
+        return;
+    }
+
+    push(n);
+    Node &node = nodes[n];
+
+    if (inclusive ? node.offset <= key : node.offset < key) {
+        split(node.right, key, inclusive, nodes[n].right, hi);
+        lo = n;
+    }
+    else {
+        split(node.left, key, inclusive, lo, nodes[n].left);
+        hi = n;
+    }
+
+    attach(n);
+    if (lo != NIL) { nodes[lo].parent = NIL; }
+    if (hi != NIL) { nodes[hi].parent = NIL; }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Merge treaps `lo` & `hi`; every offset in `lo` must be <= every
+ * offset in `hi`.
+ * @returns <uint32_t> The root of the merged treap.
+ **********************************************************************/
+uint32_t MarkerTree::merge(uint32_t lo, uint32_t hi)
+{
+    if (lo == NIL) { return hi; }
+    if (hi == NIL) { return lo; }
+
+    if (nodes[lo].priority > nodes[hi].priority) {
+        push(lo);
+        nodes[lo].right = merge(nodes[lo].right, hi);
+        attach(lo);
+        return lo;
+    }
+
+    push(hi);
+    nodes[hi].left = merge(lo, nodes[hi].left);
+    attach(hi);
+    return hi;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * In-order walk of treap `n` limited to offsets in [from, to]. Equal
+ * offsets may sit on either side of a node (inserts split inclusively
+ * & merges rotate), so both children are walked on a tie.
+ **********************************************************************/
+void MarkerTree::collect(uint32_t n, size_t from, size_t to, std::vector<MarkerId> &out)
+{
+    if (n == NIL) { return; }
+
+    push(n);
+    const size_t offset = nodes[n].offset;
+
+    if (offset >= from) { collect(nodes[n].left, from, to, out); }
+    if (offset >= from && offset <= to) { out.push_back(MarkerId(n)); }
+    if (offset <= to) { collect(nodes[n].right, from, to, out); }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live Marker.
+ **********************************************************************/
+void MarkerTree::check(MarkerId id) const
+{
+    if (!contains(id)) {
+        raise_error(generate_out_of_range_exception(
+          "Marker #{} does not exist.", id));
+    }
+}
+
+}  // namespace Text
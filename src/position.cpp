@@ -1,4 +1,5 @@
 #include <text/position.hpp>
+#include <text/shift-kernels.hpp>
 
 #include <compare>
 #include <cstddef>
@@ -11,10 +12,11 @@ namespace Text {
 /**********************************************************************
  * Default Constructor: Initializes Position to (1, 1).
  **********************************************************************/
-Position::Position()
+template <std::unsigned_integral Int>
+BasicPosition<Int>::BasicPosition()
 {
-    row = Coordinate(1);
-    col = Coordinate(1);
+    row = BasicCoordinate<Int>(1);
+    col = BasicCoordinate<Int>(1);
 }
 
 
@@ -26,10 +28,11 @@ Position::Position()
  * Constructor with only row number.
  * @param rowNum The row number of the Position.
  **********************************************************************/
-Position::Position(size_t rowNum)
+template <std::unsigned_integral Int>
+BasicPosition<Int>::BasicPosition(size_t rowNum)
 {
-    row = Coordinate(rowNum);
-    col = Coordinate(1);
+    row = BasicCoordinate<Int>(rowNum);
+    col = BasicCoordinate<Int>(1);
 }
 
 
@@ -42,7 +45,8 @@ Position::Position(size_t rowNum)
  * @param rowNum The row number of the Position.
  * @param colNum The column number of the Position.
  **********************************************************************/
-Position::Position(size_t rowNum, size_t colNum)
+template <std::unsigned_integral Int>
+BasicPosition<Int>::BasicPosition(size_t rowNum, size_t colNum)
 : row(rowNum)
 , col(colNum)
 {}
@@ -52,11 +56,33 @@ Position::Position(size_t rowNum, size_t colNum)
 
 
 
+/**********************************************************************
+ * Construct a Position from row and column numbers that are known to
+ * be valid, without checking them. Used by the Buffer's indexing code.
+ * @param rowNum The row number of the Position.
+ * @param colNum The column number of the Position.
+ **********************************************************************/
+template <std::unsigned_integral Int>
+BasicPosition<Int> BasicPosition<Int>::unchecked(Int rowNum, Int colNum) noexcept
+{
+    BasicPosition pos;
+    pos.row = BasicCoordinate<Int, Unchecked>(rowNum);
+    pos.col = BasicCoordinate<Int, Unchecked>(colNum);
+    return pos;
+}
+
+
+
+
+
+
 /**********************************************************************
  * Get the Coordinates of the Position.
  * @return <Coordinates> An object containing Coordinate objs row & col.
  **********************************************************************/
-Coordinates Position::getCoordinates() noexcept { return Coordinates{ row, col }; }
+template <std::unsigned_integral Int>
+BasicCoordinates<Int> BasicPosition<Int>::getCoordinates() const noexcept
+{ return BasicCoordinates<Int>{ row, col }; }
 
 
 
@@ -67,7 +93,8 @@ Coordinates Position::getCoordinates() noexcept { return Coordinates{ row, col }
  * Get the row Coordinate of the Position.
  * @return <Text::Coordinate> The row Coordinate of the Position.
  **********************************************************************/
-Coordinate Position::getRow() noexcept { return row; }
+template <std::unsigned_integral Int>
+BasicCoordinate<Int> BasicPosition<Int>::getRow() const noexcept { return row; }
 
 
 
@@ -78,7 +105,8 @@ Coordinate Position::getRow() noexcept { return row; }
  * Get the col Coordinate of the Position.
  * @return <Text::Coordinate> The col Coordinate of the Position.
  **********************************************************************/
-Coordinate Position::getCol() noexcept { return col; }
+template <std::unsigned_integral Int>
+BasicCoordinate<Int> BasicPosition<Int>::getCol() const noexcept { return col; }
 
 
 
@@ -89,10 +117,11 @@ Coordinate Position::getCol() noexcept { return col; }
  * @param rowNum The new row number to set.
  * @param colNum The new column number to set.
  **********************************************************************/
-void Position::setPosition(size_t rowNum, size_t colNum)
+template <std::unsigned_integral Int>
+void BasicPosition<Int>::setPosition(size_t rowNum, size_t colNum)
 {
-    row = Coordinate(rowNum);
-    col = Coordinate(colNum);
+    row = BasicCoordinate<Int>(rowNum);
+    col = BasicCoordinate<Int>(colNum);
 }
 
 
@@ -103,7 +132,8 @@ void Position::setPosition(size_t rowNum, size_t colNum)
  * Set the row Coordinate of the Position.
  * @param rowNum The new row number to set.
  **********************************************************************/
-void Position::setRow(size_t rowNum) { row = Coordinate(rowNum); }
+template <std::unsigned_integral Int>
+void BasicPosition<Int>::setRow(size_t rowNum) { row = BasicCoordinate<Int>(rowNum); }
 
 
 
@@ -113,7 +143,60 @@ void Position::setRow(size_t rowNum) { row = Coordinate(rowNum); }
  * Set the col Coordinate of the Position.
  * @param colNum The new column number to set.
  **********************************************************************/
-void Position::setCol(size_t colNum) { col = Coordinate(colNum); }
+template <std::unsigned_integral Int>
+void BasicPosition<Int>::setCol(size_t colNum) { col = BasicCoordinate<Int>(colNum); }
+
+
+
+
+
+
+/**********************************************************************
+ * Add `delta` to the row of every Position whose row is at least
+ * `fromRow`, in one pass. See shift-kernels.hpp for the errors.
+ **********************************************************************/
+template <std::unsigned_integral Int>
+void BasicPosition<Int>::shiftRows(
+  std::span<BasicPosition> positions,
+  Int                      fromRow,
+  std::make_signed_t<Int>  delta)
+{
+    shiftKernel(
+      positions,
+      fromRow,
+      delta,
+      [](const BasicPosition &pos) { return pos.row.get(); },
+      [](BasicPosition &pos, Int shifted) { pos.row = BasicCoordinate<Int>::narrow(shifted); },
+      [](size_t) { return true; });
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Add `delta` to the column of every Position on `row` whose column
+ * is at least `fromCol`, in one pass. See shift-kernels.hpp for the
+ * errors.
+ **********************************************************************/
+template <std::unsigned_integral Int>
+void BasicPosition<Int>::shiftCols(
+  std::span<BasicPosition> positions,
+  Int                      row,
+  Int                      fromCol,
+  std::make_signed_t<Int>  delta)
+{
+    const BasicPosition *data = positions.data();
+
+    shiftKernel(
+      positions,
+      fromCol,
+      delta,
+      [](const BasicPosition &pos) { return pos.col.get(); },
+      [](BasicPosition &pos, Int shifted) { pos.col = BasicCoordinate<Int>::narrow(shifted); },
+      [data, row](size_t i) { return data[i].row.get() == row; });
+}
 
 
 
@@ -123,7 +206,8 @@ void Position::setCol(size_t colNum) { col = Coordinate(colNum); }
 /**********************************************************************
  *  Increment the calling Position's column by 1.
  **********************************************************************/
-Position &Position::operator ++ () noexcept
+template <std::unsigned_integral Int>
+BasicPosition<Int> &BasicPosition<Int>::operator ++ () noexcept
 {
     ++col;
     return *this;
@@ -137,7 +221,8 @@ Position &Position::operator ++ () noexcept
 /**********************************************************************
  *  Increment the calling Position's row by 1.
  **********************************************************************/
-Position &Position::operator ++ (int) noexcept
+template <std::unsigned_integral Int>
+BasicPosition<Int> &BasicPosition<Int>::operator ++ (int) noexcept
 {
     ++row;
     return *this;
@@ -151,7 +236,8 @@ Position &Position::operator ++ (int) noexcept
 /**********************************************************************
  *  Decrement the calling Position's column by 1.
  **********************************************************************/
-Position &Position::operator -- () noexcept
+template <std::unsigned_integral Int>
+BasicPosition<Int> &BasicPosition<Int>::operator -- () noexcept
 {
     --col;
     return *this;
@@ -165,14 +251,16 @@ Position &Position::operator -- () noexcept
 /**********************************************************************
  *  Decrement the calling Position's row by 1.
  **********************************************************************/
-Position &Position::operator -- (int) noexcept
+template <std::unsigned_integral Int>
+BasicPosition<Int> &BasicPosition<Int>::operator -- (int) noexcept
 {
     --row;
     return *this;
 }
 
-bool operator == (const Position &lhs, const Position &rhs) noexcept
-{ return (lhs.row == rhs.row) && (lhs.col == rhs.col); }
+template <std::unsigned_integral Int>
+bool BasicPosition<Int>::operator == (const BasicPosition &rhs) const noexcept
+{ return (row == rhs.row) && (col == rhs.col); }
 
 
 
@@ -182,19 +270,19 @@ bool operator == (const Position &lhs, const Position &rhs) noexcept
 /****************************************************************
  * @details Overloaded Three-Way Comparison Operator
  *  (`<=>`): Compares two Positions.
- * @param pos Reference to left Position.
- * @param other Reference to right Position.
+ * @param rhs Reference to right Position.
  * @returns `std::strong_ordering` result of comparison.
  ****************************************************************/
-std::strong_ordering operator <=> (const Position &lhs, const Position &rhs) noexcept
+template <std::unsigned_integral Int>
+std::strong_ordering BasicPosition<Int>::operator <=> (const BasicPosition &rhs) const noexcept
 {
     constexpr const auto EQUIVALENT = std::strong_ordering::equivalent;
     constexpr const auto LESSER     = std::strong_ordering::less;
     constexpr const auto GREATER    = std::strong_ordering::greater;
 
-    const auto L_row = lhs.row.get();
+    const auto L_row = row.get();
     const auto R_row = rhs.row.get();
-    const auto L_col = lhs.col.get();
+    const auto L_col = col.get();
     const auto R_col = rhs.col.get();
 
     // Object greatness can be determined if one row value is
@@ -218,4 +306,9 @@ std::strong_ordering operator <=> (const Position &lhs, const Position &rhs) noe
 // <=
 
 
+
+
+template class BasicPosition<size_t>;
+template class BasicPosition<uint32_t>;
+
 }  // close namespace (Text)
@@ -0,0 +1,123 @@
+#include <text/stats.hpp>
+
+#include <mutex>
+#include <new>
+
+namespace Text {
+
+#if TEXT_BUFFER_STATS
+
+namespace {
+
+    /******************************************************************
+     * The blocks of the live threads (a list linked through the
+     * blocks), & the sum of the blocks of the threads that have
+     * exited. Only touched when a thread starts or ends counting, or
+     * when a snapshot is taken. Nothing here allocates, as a thread
+     * registers from inside a noexcept increment.
+     ******************************************************************/
+    struct Registry
+    {
+        std::mutex   lock;
+        ThreadStats *live = nullptr;
+        Stats        retired;
+    };
+
+
+    Registry &registry() noexcept
+    {
+        // Never destroyed, so it outlives thread_local destructors.
+        alignas(Registry) static unsigned char storage[sizeof(Registry)];
+        static Registry *instance = ::new (storage) Registry();
+        return *instance;
+    }
+
+
+    Stats read(const ThreadStats &block) noexcept
+    {
+        Stats snapshot;
+        for (size_t i = 0; i < STAT_COUNT; ++i) {
+            snapshot.values[i] = block.values[i].load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+}  // namespace
+
+
+
+
+ThreadStats::ThreadStats() noexcept
+{
+    Registry &reg = registry();
+    const std::lock_guard guard(reg.lock);
+
+    next = reg.live;
+    if (next != nullptr) { next->prev = this; }
+    reg.live = this;
+}
+
+
+ThreadStats::~ThreadStats()
+{
+    Registry &reg = registry();
+    const std::lock_guard guard(reg.lock);
+    reg.retired += read(*this);
+
+    if (prev != nullptr) {
+        prev->next = next;
+    }
+    else {
+        reg.live = next;
+    }
+
+    if (next != nullptr) { next->prev = prev; }
+}
+
+#endif
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <Stats> The counters summed over every thread that has
+ *   counted, including threads that have exited. Counts of threads
+ *   still running are read without stopping them, so a snapshot may
+ *   miss their latest increments.
+ **********************************************************************/
+Stats stats()
+{
+#if TEXT_BUFFER_STATS
+    Registry &reg = registry();
+    const std::lock_guard guard(reg.lock);
+
+    Stats total = reg.retired;
+    for (const ThreadStats *block = reg.live; block != nullptr; block = block->next) {
+        total += read(*block);
+    }
+    return total;
+#else
+    return Stats{};
+#endif
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <Stats> The counters of the calling thread.
+ **********************************************************************/
+Stats threadStats()
+{
+#if TEXT_BUFFER_STATS
+    return read(thread_stats);
+#else
+    return Stats{};
+#endif
+}
+
+}  // namespace Text
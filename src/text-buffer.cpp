@@ -1,13 +1,1114 @@
 #include "coordinate.hpp"
 #include <text/buffer.hpp>
 #include <text/position.hpp>
+#include <text/trace.hpp>
 #include <utils/err.hpp>
+#include <utils/exception.hpp>
+#include <utils/raise.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <functional>
 #include <utility>
 
 using namespace Text_Buffer;
 
 namespace Text {
 
+namespace {
+
+    /******************************************************************
+     * Number of bytes in the UTF-8 sequence introduced by `lead`.
+     * Stray continuation bytes are treated as 1 byte sequences so
+     * malformed text can never stall a scan.
+     ******************************************************************/
+    inline size_t utf8_length(unsigned char lead) noexcept
+    {
+        if (lead < 0xE0) { return lead < 0xC0 ? 1 : 2; }
+        return lead < 0xF0 ? 3 : 4;
+    }
+
+
+    /******************************************************************
+     * Number of UTF-16 code units that encode the code point whose
+     * UTF-8 sequence is `length` bytes long.
+     ******************************************************************/
+    inline size_t utf16_width(size_t length) noexcept { return length == 4 ? 2 : 1; }
+
+}  // namespace
+
+
+
+
+/**********************************************************************
+ * Default Constructor: Initializes an empty Buffer with one row.
+ **********************************************************************/
+Buffer::Buffer() { reindex(); }
+
+
+
+
+
+
+/**********************************************************************
+ * Constructor that copies `text` into the Buffer & indexes its rows.
+ * @param text The initial contents of the Buffer.
+ **********************************************************************/
+Buffer::Buffer(const std::string &text)
+{
+    const TraceSpan span("buffer.load", text.size());
+
+    internal = text;
+    reindex();
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <std::string_view> A view of the Buffer's entire contents.
+ *   The view is invalidated by any edit.
+ **********************************************************************/
+std::string_view Buffer::text() const noexcept { return internal; }
+
+
+
+
+
+
+/**********************************************************************
+ * Get the contents of a single row, without its line terminator.
+ * @param row One-based row number.
+ * @throws <Exception> OUT_OF_RANGE if the row does not exist.
+ **********************************************************************/
+std::string_view Buffer::line(size_t row) const
+{
+    if (row == 0 || row > lineCount()) {
+        raise_error(generate_out_of_range_exception(
+          "Row {} is outside of the Buffer's {} rows.", row, lineCount()));
+    }
+
+    const size_t start = lineStarts[row - 1];
+    return std::string_view(internal).substr(start, lineEnd(row - 1) - start);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <LineView> A lazy range of every row of the Buffer, each as
+ *   a string_view without its line break, paired with its row.
+ **********************************************************************/
+LineView Buffer::lines() const noexcept
+{ return LineView(internal, lineStarts, 0, lineStarts.size()); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <LineView> A lazy range of rows `first` through `last`
+ *   (inclusive, one-based).
+ * @throws <Exception> OUT_OF_RANGE if the rows are not in the Buffer.
+ **********************************************************************/
+LineView Buffer::lines(size_t first, size_t last) const
+{
+    if (first == 0 || first > last || last > lineCount()) {
+        raise_error(generate_out_of_range_exception(
+          "Rows {} to {} are outside of the Buffer's {} rows.", first, last, lineCount()));
+    }
+
+    return LineView(internal, lineStarts, first - 1, last);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> The number of bytes stored in the Buffer.
+ **********************************************************************/
+size_t Buffer::size() const noexcept { return internal.size(); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> The number of rows in the Buffer. An empty Buffer,
+ *   or a Buffer whose text ends in a newline, has a final empty row.
+ **********************************************************************/
+size_t Buffer::lineCount() const noexcept { return lineStarts.size(); }
+
+
+
+
+
+
+/**********************************************************************
+ * Convert a Position into a byte offset.
+ * @param pos One-based row & one-based byte column. The column may
+ *   address the row's line terminator, but not the following row.
+ * @throws <Exception> OUT_OF_RANGE if `pos` is not inside the Buffer.
+ **********************************************************************/
+size_t Buffer::offsetOf(const Position &pos) const
+{
+    const size_t row = pos.getRow().get();
+    const size_t col = pos.getCol().get();
+
+    if (row == 0 || row > lineCount() || col == 0) {
+        raise_error(generate_out_of_range_exception(
+          "Position ({}, {}) is outside of the Buffer.", row, col));
+    }
+
+    const size_t offset = lineStarts[row - 1] + (col - 1);
+    const size_t limit  = row < lineCount() ? lineStarts[row] - 1 : internal.size();
+
+    if (offset > limit) {
+        raise_error(generate_out_of_range_exception(
+          "Column {} is past the end of row {}.", col, row));
+    }
+
+    return offset;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Convert a byte offset into a Position.
+ * @param offset Byte offset, `size()` addresses the end of the Buffer.
+ * @throws <Exception> OUT_OF_RANGE if `offset > size()`.
+ **********************************************************************/
+Position Buffer::positionOf(size_t offset) const
+{
+    if (offset > internal.size()) {
+        raise_error(generate_out_of_range_exception(
+          "Offset {} is past the end of the Buffer.", offset));
+    }
+
+    const auto   next = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    const size_t row  = size_t(next - lineStarts.begin());
+
+    return Position::unchecked(row, offset - lineStarts[row - 1] + 1);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Convert a batch of byte offsets into Positions.
+ * @details Sorted (non-decreasing) input is resolved in one merge-like
+ *   pass: the row of each offset is found by galloping forward from
+ *   the row of the offset before it, so a sorted batch costs
+ *   O(n + k log(rows / k)) rather than k independent binary searches.
+ *   Unsorted input is accepted & produces the same results; whenever
+ *   an offset is smaller than its predecessor the walk restarts with
+ *   a binary search from the first row.
+ * @param offsets Byte offsets, ideally sorted ascending.
+ * @param out Receives one Position per offset, `out[i]` for
+ *   `offsets[i]`. Must be at least as long as `offsets`.
+ * @throws <Exception> OUT_OF_RANGE if `out` is too short or an offset
+ *   is past the end of the Buffer. Entries before the bad offset have
+ *   already been written.
+ **********************************************************************/
+void Buffer::positionsOf(std::span<const size_t> offsets, std::span<Position> out) const
+{
+    if (out.size() < offsets.size()) {
+        raise_error(generate_out_of_range_exception(
+          "The output span holds {} Positions but {} offsets were given.",
+          out.size(),
+          offsets.size()));
+    }
+
+    size_t row0 = 0;
+    size_t prev = 0;
+
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        const size_t offset = offsets[i];
+
+        if (offset > internal.size()) {
+            raise_error(generate_out_of_range_exception(
+              "Offset {} is past the end of the Buffer.", offset));
+        }
+
+        row0   = rowAfter(offset < prev ? 0 : row0, offset);
+        prev   = offset;
+        out[i] = Position::unchecked(row0 + 1, offset - lineStarts[row0] + 1);
+    }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Convert a batch of byte offsets into PackedPositions, with the same
+ * merge-like walk & handling of unsorted input as the Position form.
+ * @throws <Exception> OUT_OF_RANGE if `out` is too short, an offset is
+ *   past the end of the Buffer, or a Position exceeds the packed range.
+ **********************************************************************/
+void Buffer::positionsOf(
+  std::span<const size_t> offsets,
+  std::span<PackedPosition> out) const
+{
+    if (out.size() < offsets.size()) {
+        raise_error(generate_out_of_range_exception(
+          "The output span holds {} Positions but {} offsets were given.",
+          out.size(),
+          offsets.size()));
+    }
+
+    if (lineCount() > PackedPosition::MAX) {
+        raise_error(generate_out_of_range_exception(
+          "The Buffer's {} rows cannot be packed.", lineCount()));
+    }
+
+    size_t row0 = 0;
+    size_t prev = 0;
+
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        const size_t offset = offsets[i];
+
+        if (offset > internal.size()) {
+            raise_error(generate_out_of_range_exception(
+              "Offset {} is past the end of the Buffer.", offset));
+        }
+
+        row0 = rowAfter(offset < prev ? 0 : row0, offset);
+        prev = offset;
+
+        const size_t col = offset - lineStarts[row0] + 1;
+        if (col > PackedPosition::MAX) {
+            raise_error(generate_out_of_range_exception(
+              "Column {} cannot be packed.", col));
+        }
+
+        out[i] = PackedPosition(uint32_t(row0 + 1), uint32_t(col));
+    }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Convert a batch of Positions into byte offsets. Each conversion is
+ * a direct lookup in the line index, so the input order is irrelevant.
+ * @param positions One-based rows & one-based byte columns.
+ * @param out Receives one offset per Position. Must be at least as
+ *   long as `positions`.
+ * @throws <Exception> OUT_OF_RANGE if `out` is too short or a Position
+ *   is not inside the Buffer.
+ **********************************************************************/
+void Buffer::offsetsOf(std::span<const Position> positions, std::span<size_t> out) const
+{
+    if (out.size() < positions.size()) {
+        raise_error(generate_out_of_range_exception(
+          "The output span holds {} offsets but {} Positions were given.",
+          out.size(),
+          positions.size()));
+    }
+
+    for (size_t i = 0; i < positions.size(); ++i) { out[i] = offsetOf(positions[i]); }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Convert an LSP position into a byte offset. Following the LSP spec,
+ * a line past the end resolves to the end of the Buffer, & a column
+ * past the end of its line resolves to the end of that line.
+ * @param pos Zero-based line & UTF-16 code-unit column.
+ **********************************************************************/
+size_t Buffer::offsetOf(const Utf16Position &pos) const
+{
+    if (pos.line >= lineCount()) { return internal.size(); }
+    return lineStarts[pos.line] + utf16ToByte(pos.line, pos.character);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Convert an LSP position into a Position (one-based, byte column).
+ * @param pos Zero-based line & UTF-16 code-unit column.
+ **********************************************************************/
+Position Buffer::positionOf(const Utf16Position &pos) const
+{ return positionOf(offsetOf(pos)); }
+
+
+
+
+
+
+/**********************************************************************
+ * Convert a Position into an LSP position.
+ * @param pos One-based row & one-based byte column.
+ * @throws <Exception> OUT_OF_RANGE if `pos` is not inside the Buffer.
+ **********************************************************************/
+Utf16Position Buffer::utf16PositionOf(const Position &pos) const
+{ return utf16PositionOf(offsetOf(pos)); }
+
+
+
+
+
+
+/**********************************************************************
+ * Convert a byte offset into an LSP position. Offsets that address a
+ * line terminator resolve to the end of their line.
+ * @throws <Exception> OUT_OF_RANGE if `offset > size()`.
+ **********************************************************************/
+Utf16Position Buffer::utf16PositionOf(size_t offset) const
+{
+    const Position pos  = positionOf(offset);
+    const size_t   row0 = pos.getRow().get() - 1;
+
+    return Utf16Position{ row0, byteToUtf16(row0, pos.getCol().get() - 1) };
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Anchor a Marker to a byte offset. Markers follow the text they are
+ * anchored to through every later edit of the Buffer.
+ * @param offset Byte offset, `size()` addresses the end of the Buffer.
+ * @param gravity Side of an insertion at `offset` the Marker sticks to.
+ * @throws <Exception> OUT_OF_RANGE if `offset > size()`.
+ **********************************************************************/
+MarkerId Buffer::addMarker(size_t offset, Gravity gravity)
+{
+    if (offset > internal.size()) {
+        raise_error(generate_out_of_range_exception(
+          "Offset {} is past the end of the Buffer.", offset));
+    }
+
+    return markers.add(offset, gravity);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Anchor a Marker to a Position.
+ * @throws <Exception> OUT_OF_RANGE if `pos` is not inside the Buffer.
+ **********************************************************************/
+MarkerId Buffer::addMarker(const Position &pos, Gravity gravity)
+{ return markers.add(offsetOf(pos), gravity); }
+
+
+
+
+
+
+/**********************************************************************
+ * Remove a Marker. Its id may be handed out again by `addMarker()`.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live Marker.
+ **********************************************************************/
+void Buffer::removeMarker(MarkerId id) { markers.remove(id); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> The current byte offset of a Marker.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live Marker.
+ **********************************************************************/
+size_t Buffer::markerOffset(MarkerId id) const { return markers.offsetOf(id); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <Position> The current Position of a Marker.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live Marker.
+ **********************************************************************/
+Position Buffer::markerPosition(MarkerId id) const
+{ return positionOf(markers.offsetOf(id)); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> The number of live Markers.
+ **********************************************************************/
+size_t Buffer::markerCount() const noexcept { return markers.size(); }
+
+
+
+
+
+
+/**********************************************************************
+ * Attach a decoration (highlight, diagnostic, search hit, ...) to the
+ * range [start, end]. Decorations follow their text through every
+ * later edit of the Buffer, & never grow when text is typed at one of
+ * their edges.
+ * @param kind Caller-defined tag (style, severity, ...).
+ * @throws <Exception> OUT_OF_RANGE if either Position is not inside
+ *   the Buffer, or `end` precedes `start`.
+ **********************************************************************/
+DecorationId Buffer::addDecoration(const Position &start, const Position &end, uint32_t kind)
+{ return decorations.add(offsetOf(start), offsetOf(end), kind); }
+
+
+
+
+
+
+/**********************************************************************
+ * Remove a decoration. Its id may be handed out again.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live decoration.
+ **********************************************************************/
+void Buffer::removeDecoration(DecorationId id) { decorations.remove(id); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <uint32_t> The kind a decoration was added with.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live decoration.
+ **********************************************************************/
+uint32_t Buffer::decorationKind(DecorationId id) const { return decorations.kindOf(id); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> The number of live decorations.
+ **********************************************************************/
+size_t Buffer::decorationCount() const noexcept { return decorations.size(); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <std::pair<Position, Position>> The current start & end
+ *   Positions of a decoration.
+ * @throws <Exception> OUT_OF_RANGE if `id` is not a live decoration.
+ **********************************************************************/
+std::pair<Position, Position> Buffer::decorationRange(DecorationId id) const
+{
+    const auto [start, end] = decorations.rangeOf(id);
+    return { positionOf(start), positionOf(end) };
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Viewport query: append the ids of every decoration that overlaps
+ * rows `first` through `last` (inclusive, one-based) to `out`, ordered
+ * by start. Costs O(log n + k) for k results.
+ * @throws <Exception> OUT_OF_RANGE if the rows are not in the Buffer.
+ **********************************************************************/
+void Buffer::decorationsInRows(size_t first, size_t last, std::vector<DecorationId> &out) const
+{
+    if (first == 0 || first > last || last > lineCount()) {
+        raise_error(generate_out_of_range_exception(
+          "Rows {} to {} are outside of the Buffer's {} rows.", first, last, lineCount()));
+    }
+
+    const size_t to = last < lineCount() ? lineStarts[last] - 1 : internal.size();
+    decorations.query(lineStarts[first - 1], to, out);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Maintain an index of the brackets in the text, e.g. for jumping to
+ * a matching bracket, from now on. Replaces any index tracked before.
+ * @param classifier Lexes the text; tokens of the kinds in `pairs`
+ *   are brackets, so brackets inside its strings & comments are not.
+ *   Must outlive the tracking.
+ * @throws <Exception> OUT_OF_RANGE if there are more than 65536 pairs
+ *   or the text is 4 GiB or larger.
+ **********************************************************************/
+void Buffer::trackBrackets(const Lexicon &classifier, std::span<const BracketPair> pairs)
+{ brackets.track(*this, classifier, pairs); }
+
+
+
+
+
+
+/**********************************************************************
+ * Stop maintaining the bracket index & release it.
+ **********************************************************************/
+void Buffer::untrackBrackets() noexcept { brackets = BracketIndex(); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> The number of brackets in the text; 0 while none
+ *   are tracked.
+ **********************************************************************/
+size_t Buffer::bracketCount() const noexcept { return brackets.size(); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <int64_t> The number of opening less the number of closing
+ *   brackets before `pos`, counted over every pair; negative after
+ *   unbalanced closing brackets.
+ * @throws <Exception> OUT_OF_RANGE if `pos` is not in the Buffer.
+ **********************************************************************/
+int64_t Buffer::bracketDepth(const Position &pos) const { return brackets.depth(offsetOf(pos)); }
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <std::optional<Position>> The Position of the bracket that
+ *   pairs with the one at `pos`; nothing if there is no bracket at
+ *   `pos`, it is unbalanced or it would pair with another kind.
+ *   Costs O(log n) in the number of brackets.
+ * @throws <Exception> OUT_OF_RANGE if `pos` is not in the Buffer.
+ **********************************************************************/
+std::optional<Position> Buffer::matchingBracket(const Position &pos) const
+{
+    const auto partner = brackets.match(offsetOf(pos));
+    if (!partner) { return std::nullopt; }
+    return positionOf(*partner);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <std::optional<std::pair<Position, Position>>> The opening
+ *   & closing brackets of the innermost pair around `pos`: the opening
+ *   one before it & the closing one at or after it. Nothing if `pos`
+ *   is in no pair. Costs O(log n) in the number of brackets.
+ * @throws <Exception> OUT_OF_RANGE if `pos` is not in the Buffer.
+ **********************************************************************/
+std::optional<std::pair<Position, Position>> Buffer::enclosingBrackets(const Position &pos) const
+{
+    const auto pair = brackets.enclosing(offsetOf(pos));
+    if (!pair) { return std::nullopt; }
+    return std::pair{ positionOf(pair->first), positionOf(pair->second) };
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Replace `length` bytes starting at `offset` with `text`. Only the
+ * rows touched by the edit are re-indexed; the line starts after it
+ * are shifted, & the UTF-16 checkpoints of the touched rows dropped.
+ * Markers & decorations are updated in O(log n), plus O(log n) per
+ * decoration overlapping the edit; see `DecorationTree::replace()`.
+ * A tracked bracket index re-lexes the rows the edit can change; see
+ * `BracketIndex::update()`.
+ * @throws <Exception> OUT_OF_RANGE if the range is not in the Buffer,
+ *   or if brackets are tracked & the text would grow past 4 GiB; the
+ *   Buffer is unchanged either way.
+ **********************************************************************/
+void Buffer::replace(size_t offset, size_t length, std::string_view text)
+{
+    const TraceSpan span("buffer.edit", text.size());
+
+    if (offset > internal.size() || length > internal.size() - offset) {
+        raise_error(generate_out_of_range_exception(
+          "The range [{}, {}) is outside of the Buffer's {} bytes.",
+          offset,
+          offset + length,
+          internal.size()));
+    }
+    if (brackets.tracking() && internal.size() - length + text.size() > TokenTable::MAX_BYTES) {
+        raise_error(generate_out_of_range_exception(
+          "A text of {} bytes is too large to track brackets in.",
+          internal.size() - length + text.size()));
+    }
+
+    const auto first = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    const auto last  = std::upper_bound(first, lineStarts.end(), offset + length);
+    const auto row0  = size_t(first - lineStarts.begin()) - 1;
+
+    const size_t textCapacity  = internal.capacity();
+    const size_t indexCapacity = lineStarts.capacity();
+
+    internal.replace(offset, length, text);
+    markers.replace(offset, length, text.size());
+    decorations.replace(offset, length, text.size());
+
+    // Line starts that fell inside the replaced range are dropped and
+    // the starts introduced by the new text take their place, written
+    // straight into the index so an edit allocates nothing of its own.
+    const size_t removed = size_t(last - first);
+    const size_t added   = size_t(std::count(text.begin(), text.end(), '\n'));
+    const auto   at      = first - lineStarts.begin();
+
+    if (added > removed) {
+        lineStarts.insert(lineStarts.begin() + at + std::ptrdiff_t(removed), added - removed, 0);
+    }
+    else {
+        lineStarts.erase(
+          lineStarts.begin() + at + std::ptrdiff_t(added),
+          lineStarts.begin() + at + std::ptrdiff_t(removed));
+    }
+
+    auto row = size_t(at);
+    for (size_t i = text.find('\n'); i != text.npos; i = text.find('\n', i + 1)) {
+        lineStarts[row++] = offset + i + 1;
+    }
+
+    const auto delta = std::ptrdiff_t(text.size()) - std::ptrdiff_t(length);
+    for (; row < lineStarts.size(); ++row) {
+        lineStarts[row] = size_t(std::ptrdiff_t(lineStarts[row]) + delta);
+    }
+
+    utf16Lines[row0] = Utf16Line{};
+    utf16Lines.erase(
+      utf16Lines.begin() + std::ptrdiff_t(row0 + 1),
+      utf16Lines.begin() + std::ptrdiff_t(row0 + 1 + removed));
+    utf16Lines.insert(
+      utf16Lines.begin() + std::ptrdiff_t(row0 + 1), added, Utf16Line{});
+
+    brackets.update(*this, offset, length, text.size());
+
+    counters.add(Stat::EDITS_APPLIED);
+    counters.add(Stat::BYTES_SCANNED, text.size());
+    counters.add(Stat::ALLOCATIONS, internal.capacity() != textCapacity);
+    counters.add(Stat::ALLOCATIONS, lineStarts.capacity() != indexCapacity);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Insert `text` at byte `offset`.
+ **********************************************************************/
+void Buffer::insert(size_t offset, std::string_view text) { replace(offset, 0, text); }
+
+
+
+
+
+
+/**********************************************************************
+ * Erase `length` bytes starting at byte `offset`.
+ **********************************************************************/
+void Buffer::erase(size_t offset, size_t length) { replace(offset, length, {}); }
+
+
+
+
+
+
+/**********************************************************************
+ * Apply an LSP `textDocument/didChange` batch. As the spec requires,
+ * each change is resolved against the text left by the change before
+ * it. Ranges are translated through the cached UTF-16 checkpoints, so
+ * the cost of each change is bound by the rows it touches rather than
+ * by the length of those rows or the size of the Buffer.
+ * @param changes The `contentChanges` array, in order.
+ **********************************************************************/
+void Buffer::applyChanges(std::span<const Utf16Change> changes)
+{
+    const TraceSpan span("buffer.apply_changes");
+
+    for (const Utf16Change &change : changes) {
+        if (!change.range) {
+            replace(0, internal.size(), change.text);
+            continue;
+        }
+
+        size_t start = offsetOf(change.range->start);
+        size_t end   = offsetOf(change.range->end);
+
+        if (end < start) { std::swap(start, end); }
+        replace(start, end - start, change.text);
+    }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <Stats> The mutations counted by this Buffer, its Markers
+ *   & its decorations since it was created (or copied from). Const
+ *   queries (UTF-16 cache hits & misses) are counted per thread only,
+ *   by `Text::stats()` & `Text::threadStats()`.
+ **********************************************************************/
+Stats Buffer::stats() const noexcept
+{
+    Stats total = counters.snapshot();
+    total += markers.stats();
+    total += decorations.stats();
+    return total;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <MemoryUsage> The heap bytes held by the Buffer's text,
+ *   line index, UTF-16 caches, Markers, decorations & brackets.
+ **********************************************************************/
+MemoryUsage Buffer::memoryUsage() const noexcept
+{
+    MemoryUsage usage;
+
+    // A short text lives inside the std::string object itself. Plain < on
+    // pointers into unrelated objects is unspecified; std::less is not.
+    const auto *data  = internal.data();
+    const auto *self  = reinterpret_cast<const char *>(&internal);
+    const bool  local = !std::less<const char *>{}(data, self)
+                     && std::less<const char *>{}(data, self + sizeof(internal));
+    usage.text        = local ? 0 : internal.capacity() + 1;
+
+    usage.lineIndex   = lineStarts.capacity() * sizeof(size_t);
+    // Other readers may be building rows meanwhile, so no lock is taken
+    // (this cannot throw): only published rows are read, & rows hold no
+    // checkpoints until they are.
+    usage.utf16Caches = utf16Lines.capacity() * sizeof(Utf16Line);
+    for (const Utf16Line &line : utf16Lines) {
+        if (!line.built.load(std::memory_order_acquire)) { continue; }
+        usage.utf16Caches += line.checkpoints.capacity() * sizeof(line.checkpoints[0]);
+    }
+
+    usage.markers     = markers.memoryUsage();
+    usage.decorations = decorations.memoryUsage();
+    usage.brackets    = brackets.memoryUsage();
+    return usage;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Drop the UTF-16 column caches; they are rebuilt, row by row, when
+ * next needed. Meant for shedding memory under pressure.
+ * @returns <size_t> The number of heap bytes released.
+ **********************************************************************/
+size_t Buffer::dropCaches() noexcept
+{
+    const size_t before = memoryUsage().total();
+
+    for (Utf16Line &line : utf16Lines) {
+        line = Utf16Line{};  // Releases the checkpoints
+    }
+
+    return before - memoryUsage().total();
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Drop the caches & release the spare capacity of every structure,
+ * at the cost of reallocating when the Buffer next grows.
+ * @returns <size_t> The number of heap bytes released.
+ **********************************************************************/
+size_t Buffer::shrinkToFit()
+{
+    const size_t before = memoryUsage().total();
+
+    // Copy & swap rather than shrink_to_fit(), which libstdc++ ignores under -fno-exceptions.
+    dropCaches();
+    std::string(internal).swap(internal);
+    std::vector<size_t>(lineStarts).swap(lineStarts);
+    std::vector<Utf16Line>(utf16Lines).swap(utf16Lines);
+    markers.shrinkToFit();
+    decorations.shrinkToFit();
+    brackets.shrinkToFit();
+
+    return before - std::min(before, memoryUsage().total());
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Rebuild the line index from scratch & drop every UTF-16 cache.
+ **********************************************************************/
+void Buffer::reindex()
+{
+    const TraceSpan span("buffer.index", internal.size());
+    const size_t    indexCapacity = lineStarts.capacity();
+
+    lineStarts.assign(1, 0);
+
+    const char *data = internal.data();
+    const char *end  = data + internal.size();
+
+    for (const char *p = data; p < end;) {
+        const void *nl = std::memchr(p, '\n', size_t(end - p));
+        if (nl == nullptr) { break; }
+
+        p = static_cast<const char *>(nl) + 1;
+        lineStarts.push_back(size_t(p - data));
+    }
+
+    utf16Lines.assign(lineStarts.size(), Utf16Line{});
+
+    counters.add(Stat::INDEX_REBUILDS);
+    counters.add(Stat::BYTES_SCANNED, internal.size());
+    counters.add(Stat::ALLOCATIONS, lineStarts.capacity() != indexCapacity);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Find the zero-based row containing `offset`, searching forward from
+ * `row0`, which must not be past that row. The search gallops (1, 2,
+ * 4, ... rows) before binary searching the bracketed window, so nearby
+ * rows are found in a few steps & distant rows in O(log distance).
+ **********************************************************************/
+size_t Buffer::rowAfter(size_t row0, size_t offset) const noexcept
+{
+    const size_t rows = lineStarts.size();
+    size_t       step = 1;
+    size_t       low  = row0;
+
+    while (low + step < rows && lineStarts[low + step] <= offset) {
+        low += step;
+        step *= 2;
+    }
+
+    const auto begin = lineStarts.begin() + std::ptrdiff_t(low + 1);
+    const auto end   = lineStarts.begin() + std::ptrdiff_t(std::min(low + step, rows));
+
+    return size_t(std::upper_bound(begin, end, offset) - lineStarts.begin()) - 1;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * @returns <size_t> Offset one past the last content byte of the row,
+ *   excluding its `\n` or `\r\n` terminator.
+ **********************************************************************/
+size_t Buffer::lineEnd(size_t row0) const noexcept
+{
+    const size_t start = lineStarts[row0];
+    size_t end = row0 + 1 < lineStarts.size() ? lineStarts[row0 + 1] : internal.size();
+
+    if (end > start && internal[end - 1] == '\n') { --end; }
+    if (end > start && internal[end - 1] == '\r') { --end; }
+
+    return end;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Lazily build the UTF-16 checkpoints of a row. Rows that are pure
+ * ASCII are flagged & need no checkpoints, as byte & UTF-16 columns
+ * are identical. Other rows record a (byte, UTF-16) column pair at
+ * the first character boundary of every `UTF16_STRIDE` bytes.
+ *
+ * Threads reading the same Buffer may ask for the same row: a built
+ * row is found without locking, & rows are built under `utf16Build`,
+ * then published by setting `built`.
+ **********************************************************************/
+const Buffer::Utf16Line &Buffer::utf16Line(size_t row0) const
+{
+    Utf16Line &cache = utf16Lines[row0];
+    if (cache.built.load(std::memory_order_acquire)) {
+        thread_count(Stat::CACHE_HITS);
+        return cache;
+    }
+
+    const std::lock_guard lock(utf16Build.mutex);
+    if (cache.built.load(std::memory_order_relaxed)) {
+        thread_count(Stat::CACHE_HITS);
+        return cache;
+    }
+
+    const auto *data   = reinterpret_cast<const unsigned char *>(internal.data());
+    const auto *line   = data + lineStarts[row0];
+    const size_t length = lineEnd(row0) - lineStarts[row0];
+
+    cache.ascii = std::all_of(line, line + length, [](unsigned char c) { return c < 0x80; });
+    cache.checkpoints.clear();
+
+    if (!cache.ascii) {
+        size_t bytes = 0;
+        size_t units = 0;
+        size_t next  = 0;
+
+        while (bytes < length) {
+            if (bytes >= next) {
+                cache.checkpoints.emplace_back(uint32_t(bytes), uint32_t(units));
+                next = bytes + UTF16_STRIDE;
+            }
+
+            const size_t n = std::min(utf8_length(line[bytes]), length - bytes);
+            units += utf16_width(n);
+            bytes += n;
+        }
+    }
+
+    cache.built.store(true, std::memory_order_release);
+    thread_count(Stat::CACHE_MISSES);
+    thread_count(Stat::BYTES_SCANNED, length);
+    return cache;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Translate a UTF-16 column into a byte column of row `row0`. Columns
+ * past the end of the row clamp to its end, & a column that splits a
+ * surrogate pair resolves to the start of that pair.
+ **********************************************************************/
+size_t Buffer::utf16ToByte(size_t row0, size_t units) const
+{
+    const Utf16Line &cache  = utf16Line(row0);
+    const size_t     length = lineEnd(row0) - lineStarts[row0];
+
+    if (cache.ascii) { return std::min(units, length); }
+
+    const auto &cps = cache.checkpoints;
+    const auto  cp  = std::upper_bound(
+                     cps.begin(),
+                     cps.end(),
+                     units,
+                     [](size_t u, const auto &c) { return u < c.second; })
+                  - 1;
+
+    const auto *line = reinterpret_cast<const unsigned char *>(internal.data())
+                     + lineStarts[row0];
+
+    size_t bytes = cp->first;
+    size_t count = cp->second;
+
+    while (bytes < length) {
+        const size_t n = std::min(utf8_length(line[bytes]), length - bytes);
+        if (count + utf16_width(n) > units) { break; }
+
+        count += utf16_width(n);
+        bytes += n;
+    }
+
+    return bytes;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Translate a byte column of row `row0` into a UTF-16 column. Columns
+ * past the end of the row clamp to its end.
+ **********************************************************************/
+size_t Buffer::byteToUtf16(size_t row0, size_t bytes) const
+{
+    const Utf16Line &cache  = utf16Line(row0);
+    const size_t     length = lineEnd(row0) - lineStarts[row0];
+
+    bytes = std::min(bytes, length);
+    if (cache.ascii) { return bytes; }
+
+    const auto &cps = cache.checkpoints;
+    const auto  cp  = std::upper_bound(
+                     cps.begin(),
+                     cps.end(),
+                     bytes,
+                     [](size_t b, const auto &c) { return b < c.first; })
+                  - 1;
+
+    const auto *line = reinterpret_cast<const unsigned char *>(internal.data())
+                     + lineStarts[row0];
+
+    size_t at    = cp->first;
+    size_t units = cp->second;
+
+    while (at < bytes) {
+        const size_t n = std::min(utf8_length(line[at]), length - at);
+        units += utf16_width(n);
+        at += n;
+    }
+
+    return units;
+}
+
 
 
-}  // Text
\ No newline at end of file
+}  // Text
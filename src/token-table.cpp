@@ -0,0 +1,274 @@
+#include <text/buffer.hpp>
+#include <text/token-table.hpp>
+#include <text/trace.hpp>
+#include <utils/exception.hpp>
+#include <utils/raise.hpp>
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+using namespace Text_Buffer;
+
+namespace Text {
+
+namespace {
+
+    size_t lineStart(const Buffer &buffer, size_t row0)
+    {
+        return buffer.offsetOf(Position(row0 + 1, 1));
+    }
+
+
+    size_t lineEnd(const Buffer &buffer, size_t row0)
+    {
+        return row0 + 1 < buffer.lineCount() ? lineStart(buffer, row0 + 1) : buffer.size();
+    }
+
+}  // namespace
+
+
+
+
+
+
+/**********************************************************************
+ * Lex every row of `buffer`.
+ * @param rules Must outlive the table.
+ * @throws <Exception> OUT_OF_RANGE if the text is 4 GiB or larger.
+ **********************************************************************/
+TokenTable::TokenTable(const Buffer &buffer, const Lexicon &rules)
+: lexicon(&rules)
+{
+    if (buffer.size() > MAX_BYTES) {
+        raise_error(generate_out_of_range_exception(
+          "A text of {} bytes is too large for a TokenTable.", buffer.size()));
+    }
+
+    const TraceSpan span("tokens.build", buffer.size());
+
+    lines.resize(buffer.lineCount());
+
+    size_t pos = 0;
+    for (size_t row0 = 0; row0 < lines.size(); ++row0) {
+        pos = lexRow(buffer, row0, pos, lines[row0]);
+        count += lines[row0].tokens.size();
+    }
+    bytes     = buffer.size();
+    relexRows = lines.size();
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Bring the table up to date after `buffer` had `removed` bytes at
+ * `offset` replaced by `inserted` bytes.
+ * @returns <size_t> The number of rows re-lexed.
+ * @throws <Exception> OUT_OF_RANGE if the edit does not fit the
+ *   Buffer or the text the table was built from.
+ **********************************************************************/
+size_t TokenTable::update(const Buffer &buffer, size_t offset, size_t removed, size_t inserted)
+{
+    if (offset > buffer.size() || inserted > buffer.size() - offset
+        || buffer.size() + removed != bytes + inserted) {
+        raise_error(generate_out_of_range_exception(
+          "Replacing {} bytes at {} with {} does not turn {} bytes into {}.",
+          removed,
+          offset,
+          inserted,
+          bytes,
+          buffer.size()));
+    }
+    if (buffer.size() > MAX_BYTES) {
+        raise_error(generate_out_of_range_exception(
+          "A text of {} bytes is too large for a TokenTable.", buffer.size()));
+    }
+
+    const TraceSpan span("tokens.update", inserted);
+
+    // 1. Rows up to the edit start where they did; step back over rows whose
+    //    carried-in token ends too close to the edit to be trusted.
+    const size_t reach = lexicon->lookahead();
+    size_t       first = buffer.positionOf(offset).getRow().get() - 1;
+
+    while (first > 0 && lineStart(buffer, first) + lines[first].state + reach > offset) { --first; }
+
+    // 2. Re-lex until a row past the edit carries in what its old counterpart did.
+    const size_t      editEnd = offset + inserted;
+    const size_t      oldRows = lines.size();
+    const size_t      newRows = buffer.lineCount();
+    size_t            pos     = lineStart(buffer, first) + lines[first].state;
+    size_t            resume  = oldRows;  // Old row the table resumes at
+    std::vector<Line> fresh;
+
+    for (size_t row0 = first; row0 < newRows; ++row0) {
+        const size_t start = lineStart(buffer, row0);
+
+        // Rows starting after the edit map to old rows by the line count change.
+        if (start > editEnd) {
+            const size_t old = row0 + oldRows - newRows;
+            if (old < oldRows && lines[old].state == pos - start) {
+                resume = old;
+                break;
+            }
+        }
+
+        fresh.emplace_back();
+        pos = lexRow(buffer, row0, pos, fresh.back());
+    }
+
+    // 3. Splice the fresh rows over rows [first, resume) of the old table.
+    for (size_t row0 = first; row0 < resume; ++row0) { count -= lines[row0].tokens.size(); }
+    for (const Line &line : fresh) { count += line.tokens.size(); }
+
+    const size_t replaced = resume - first;
+    const size_t reused   = std::min(replaced, fresh.size());
+    const auto   at       = lines.begin() + ptrdiff_t(first);
+
+    std::move(fresh.begin(), fresh.begin() + ptrdiff_t(reused), at);
+    if (fresh.size() > replaced) {
+        lines.insert(
+          at + ptrdiff_t(reused),
+          std::make_move_iterator(fresh.begin() + ptrdiff_t(reused)),
+          std::make_move_iterator(fresh.end()));
+    }
+    else {
+        lines.erase(at + ptrdiff_t(reused), at + ptrdiff_t(replaced));
+    }
+
+    bytes      = buffer.size();
+    relexFirst = first + 1;
+    relexRows  = fresh.size();
+    return relexRows;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Release the spare capacity of the rows & of their token lists.
+ **********************************************************************/
+void TokenTable::shrinkToFit()
+{
+    // Exact-size copies swapped in; see Buffer::shrinkToFit() for why not shrink_to_fit().
+    for (Line &line : lines) { decltype(line.tokens)(line.tokens).swap(line.tokens); }
+    decltype(lines)(lines).swap(lines);
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <size_t> Heap bytes held by the table.
+ **********************************************************************/
+size_t TokenTable::memoryUsage() const noexcept
+{
+    size_t total = lines.capacity() * sizeof(Line);
+    for (const Line &line : lines) { total += line.tokens.capacity() * sizeof(LineToken); }
+    return total;
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <std::span<const LineToken>> The kept tokens starting in
+ *   `row` (1-based), in text order.
+ * @throws <Exception> OUT_OF_RANGE if `row` is not a row of the table.
+ **********************************************************************/
+std::span<const LineToken> TokenTable::tokensIn(size_t row) const
+{
+    return at(row).tokens;
+}
+
+
+/**********************************************************************
+ * @returns <size_t> The number of bytes at the start of `row` that
+ *   belong to a token started in an earlier row; 0 at a token
+ *   boundary. May exceed the row's length.
+ * @throws <Exception> OUT_OF_RANGE if `row` is not a row of the table.
+ **********************************************************************/
+size_t TokenTable::lineState(size_t row) const
+{
+    return at(row).state;
+}
+
+
+/**********************************************************************
+ * @returns <Token> The `index`th token of `row`, resolved against
+ *   `buffer`, which must hold the text the table is current for.
+ * @throws <Exception> OUT_OF_RANGE if there is no such token.
+ **********************************************************************/
+Token TokenTable::token(const Buffer &buffer, size_t row, size_t index) const
+{
+    const Line &line = at(row);
+
+    if (index >= line.tokens.size()) {
+        raise_error(generate_out_of_range_exception(
+          "Row {} has {} tokens, not {}.", row, line.tokens.size(), index + 1));
+    }
+
+    const LineToken &entry  = line.tokens[index];
+    const size_t     offset = lineStart(buffer, row - 1) + entry.column;
+
+    Token token;
+    token.kind   = entry.kind;
+    token.text   = buffer.text().substr(offset, entry.length);
+    token.offset = offset;
+    token.start  = Position(row, entry.column + 1);
+    token.end    = buffer.positionOf(offset + entry.length);
+    return token;
+}
+
+
+
+
+
+
+const TokenTable::Line &TokenTable::at(size_t row) const
+{
+    if (row == 0 || row > lines.size()) {
+        raise_error(generate_out_of_range_exception(
+          "Row {} is outside of the table's {} rows.", row, lines.size()));
+    }
+
+    return lines[row - 1];
+}
+
+
+/**********************************************************************
+ * Lex the tokens starting in `row0` (0-based), from `pos`, where the
+ * token carried into the row ends.
+ * @returns <size_t> Offset where the last of them ends.
+ **********************************************************************/
+size_t TokenTable::lexRow(const Buffer &buffer, size_t row0, size_t pos, Line &line) const
+{
+    const std::string_view text  = buffer.text();
+    const size_t           start = lineStart(buffer, row0);
+    const size_t           end   = lineEnd(buffer, row0);
+
+    line.state = pos - start;
+    line.tokens.clear();
+
+    while (pos < end) {
+        const Lexicon::Match match = lexicon->match(text.substr(pos));
+        if (!lexicon->skips(match.kind)) {
+            line.tokens.push_back({ match.kind, uint32_t(pos - start), uint32_t(match.length) });
+        }
+        pos += match.length;
+    }
+    return pos;
+}
+
+}  // namespace Text
@@ -0,0 +1,282 @@
+#include <text/trace.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Text {
+
+namespace {
+
+    struct TracedEvent
+    {
+        TraceEvent event;
+        uint32_t   tid;
+    };
+
+}  // namespace
+
+
+
+
+#if TEXT_BUFFER_TRACE
+
+namespace {
+
+    /******************************************************************
+     * The rings of the live threads (a list linked through the
+     * rings, newest first), & the latest spans left by the threads
+     * that have exited (at most TRACE_RETIRED_CAPACITY).
+     *
+     * `retired` is allocated once, by the first ring, with room for
+     * a full ring on top of the spans kept, so a ring can be merged
+     * in at thread exit without allocating.
+     ******************************************************************/
+    struct Registry
+    {
+        static constexpr size_t RETIRED_SLOTS = TRACE_RETIRED_CAPACITY + TRACE_CAPACITY;
+
+        std::mutex                     lock;
+        TraceRing                     *live = nullptr;
+        std::unique_ptr<TracedEvent[]> retired;          /// RETIRED_SLOTS, or null
+        size_t                         retiredSize = 0;
+        uint32_t                       nextTid     = 1;
+    };
+
+
+    Registry &registry() noexcept
+    {
+        // Never destroyed, so it outlives thread_local destructors.
+        alignas(Registry) static unsigned char storage[sizeof(Registry)];
+        static Registry *instance = ::new (storage) Registry();
+        return *instance;
+    }
+
+
+    void collect(const TraceRing &ring, std::vector<TracedEvent> &out)
+    {
+        for (size_t i = 0; i < ring.size; ++i) { out.push_back({ ring.events[i], ring.tid }); }
+    }
+
+
+    /******************************************************************
+     * Move the spans of an exiting thread's ring into `retired`,
+     * keeping the latest TRACE_RETIRED_CAPACITY. Allocation-free.
+     ******************************************************************/
+    void retire(Registry &reg, const TraceRing &ring) noexcept
+    {
+        if (reg.retired == nullptr) { return; }
+
+        for (size_t i = 0; i < ring.size; ++i) {
+            reg.retired[reg.retiredSize++] = { ring.events[i], ring.tid };
+        }
+
+        // Short-lived threads would otherwise grow the list without bound.
+        if (reg.retiredSize > TRACE_RETIRED_CAPACITY) {
+            const auto latest = [](const TracedEvent &a, const TracedEvent &b) {
+                return a.event.start > b.event.start;
+            };
+
+            TracedEvent *first = reg.retired.get();
+            std::nth_element(first, first + TRACE_RETIRED_CAPACITY, first + reg.retiredSize, latest);
+            reg.retiredSize = TRACE_RETIRED_CAPACITY;
+        }
+    }
+
+}  // namespace
+
+
+
+
+/**********************************************************************
+ * @private
+ * @returns <uint64_t> Nanoseconds since the first call.
+ **********************************************************************/
+uint64_t trace_clock() noexcept
+{
+    using clock = std::chrono::steady_clock;
+
+    static const clock::time_point epoch = clock::now();
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - epoch).count());
+}
+
+
+
+
+
+
+TraceRing::TraceRing() noexcept
+: events(new (std::nothrow) TraceEvent[TRACE_CAPACITY])  // record() never allocates
+{
+    Registry &reg = registry();
+    const std::lock_guard guard(reg.lock);
+    tid = reg.nextTid++;
+
+    if (reg.retired == nullptr) {
+        reg.retired.reset(new (std::nothrow) TracedEvent[Registry::RETIRED_SLOTS]);
+    }
+
+    older = reg.live;
+    if (older != nullptr) { older->newer = this; }
+    reg.live = this;
+}
+
+
+TraceRing::~TraceRing() noexcept
+{
+    Registry &reg = registry();
+    const std::lock_guard guard(reg.lock);
+    retire(reg, *this);
+
+    if (newer != nullptr) {
+        newer->older = older;
+    }
+    else {
+        reg.live = older;
+    }
+
+    if (older != nullptr) { older->newer = newer; }
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @private
+ * Append a finished span, overwriting the oldest once the ring is full.
+ **********************************************************************/
+void TraceRing::record(const TraceEvent &event) noexcept
+{
+    const std::lock_guard guard(lock);
+
+    if (events == nullptr) { return; }
+    if (size < TRACE_CAPACITY) {
+        events[size++] = event;
+        return;
+    }
+
+    events[next] = event;
+    next         = (next + 1) % TRACE_CAPACITY;
+}
+
+#endif
+
+
+
+
+
+
+/**********************************************************************
+ * Turn span recording on or off for every thread. Spans that started
+ * while tracing was off are not recorded.
+ **********************************************************************/
+void setTracing([[maybe_unused]] bool on) noexcept
+{
+#if TEXT_BUFFER_TRACE
+    if (on) { trace_clock(); }  // Fix the epoch before the first span
+    trace_enabled.store(on, std::memory_order_relaxed);
+#endif
+}
+
+
+bool tracing() noexcept
+{
+#if TEXT_BUFFER_TRACE
+    return trace_enabled.load(std::memory_order_relaxed);
+#else
+    return false;
+#endif
+}
+
+
+
+
+
+
+/**********************************************************************
+ * @returns <std::string> The recorded spans of every thread as Chrome
+ *   trace-event JSON (complete "X" events, times in microseconds).
+ **********************************************************************/
+std::string traceJson()
+{
+    std::vector<TracedEvent> events;
+
+#if TEXT_BUFFER_TRACE
+    {
+        Registry &reg = registry();
+        const std::lock_guard guard(reg.lock);
+
+        events.assign(reg.retired.get(), reg.retired.get() + reg.retiredSize);
+        for (TraceRing *ring = reg.live; ring != nullptr; ring = ring->older) {
+            const std::lock_guard ringGuard(ring->lock);
+            collect(*ring, events);
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const TracedEvent &a, const TracedEvent &b) {
+        return a.event.start < b.event.start;
+    });
+#endif
+
+    // Callers name their own spans, so names may hold any character.
+    const auto quoted = [](std::string_view text) {
+        std::string str = "\"";
+        for (const char c : text) {
+            if (c == '"' || c == '\\') { str += '\\'; }
+            if (static_cast<unsigned char>(c) >= 0x20) { str += c; }
+        }
+        return str + '"';
+    };
+
+    std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        const TraceEvent &event = events[i].event;
+
+        json += std::format(
+          "{}\n{{\"name\":{},\"cat\":\"text_buffer\",\"ph\":\"X\",\"pid\":1,\"tid\":{},"
+          "\"ts\":{:.3f},\"dur\":{:.3f}",
+          i ? "," : "",
+          quoted(event.name),
+          events[i].tid,
+          double(event.start) / 1e3,
+          double(event.duration) / 1e3);
+
+        if (event.bytes) { json += std::format(",\"args\":{{\"bytes\":{}}}", event.bytes); }
+        json += '}';
+    }
+
+    return json + "\n]}\n";
+}
+
+
+
+
+
+
+/**********************************************************************
+ * Drop every recorded span.
+ **********************************************************************/
+void clearTrace()
+{
+#if TEXT_BUFFER_TRACE
+    Registry &reg = registry();
+    const std::lock_guard guard(reg.lock);
+
+    reg.retiredSize = 0;
+    for (TraceRing *ring = reg.live; ring != nullptr; ring = ring->older) {
+        const std::lock_guard ringGuard(ring->lock);
+        ring->size = 0;
+        ring->next = 0;
+    }
+#endif
+}
+
+}  // namespace Text
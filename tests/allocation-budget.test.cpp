@@ -0,0 +1,239 @@
+#include <text/buffer.hpp>
+#include <text/coordinate.hpp>
+#include <text/lexer.hpp>
+#include <text/position-array.hpp>
+#include <text/position-map.hpp>
+#include <text/position.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utils/err.hpp>
+#include <vector>
+
+using namespace Text;
+using namespace Text_Buffer;
+using namespace std;
+
+
+/**************************************************************
+ * Allocation budgets: the global allocator of this executable
+ * counts every `operator new` made by the calling thread, & each
+ * test asserts how many allocations a hot-path operation may make
+ * (usually none). A test failing here means an operation started
+ * allocating; raise its budget only if that is intended.
+ **************************************************************/
+static thread_local size_t allocation_count = 0;
+
+
+static void *counted_alloc(size_t size, size_t align = alignof(max_align_t))
+{
+    ++allocation_count;
+
+    void *ptr = align > alignof(max_align_t)
+                ? std::aligned_alloc(align, (size + align - 1) / align * align)
+                : std::malloc(size ? size : 1);
+
+    if (ptr == nullptr) { std::abort(); }  // Builds may not have exceptions
+    return ptr;
+}
+
+
+void *operator new (size_t size) { return counted_alloc(size); }
+void *operator new[] (size_t size) { return counted_alloc(size); }
+void *operator new (size_t size, align_val_t align) { return counted_alloc(size, size_t(align)); }
+void *operator new[] (size_t size, align_val_t align) { return counted_alloc(size, size_t(align)); }
+void  operator delete (void *ptr) noexcept { std::free(ptr); }
+void  operator delete[] (void *ptr) noexcept { std::free(ptr); }
+void  operator delete (void *ptr, size_t) noexcept { std::free(ptr); }
+void  operator delete[] (void *ptr, size_t) noexcept { std::free(ptr); }
+void  operator delete (void *ptr, align_val_t) noexcept { std::free(ptr); }
+void  operator delete[] (void *ptr, align_val_t) noexcept { std::free(ptr); }
+void  operator delete (void *ptr, size_t, align_val_t) noexcept { std::free(ptr); }
+void  operator delete[] (void *ptr, size_t, align_val_t) noexcept { std::free(ptr); }
+
+
+/**************************************************************
+ * @returns <size_t> The allocations made while running `fn`.
+ **************************************************************/
+template <typename Fn>
+static size_t allocations(Fn &&fn)
+{
+    const size_t before = allocation_count;
+    fn();
+    return allocation_count - before;
+}
+
+
+static string sample_text(size_t rows)
+{
+    string text;
+    for (size_t row = 0; row < rows; ++row) { text += "h\xC3\xA9llo, row of text\n"; }
+    return text;
+}
+
+
+
+
+
+
+
+
+
+
+TEST(AllocationBudgetTestSuite, coordinates_and_positions)
+{
+    Coordinate a(5);
+    Coordinate b(3);
+    Position   p(4, 7);
+    Position   q(4, 9);
+    size_t     sink = 0;
+
+    EXPECT_EQ(allocations([&] { ++a; }), 0);
+    EXPECT_EQ(allocations([&] { --a; }), 0);
+    EXPECT_EQ(allocations([&] { sink += (a + b).get() + (a - b).get() + (a * b).get(); }), 0);
+    EXPECT_EQ(allocations([&] { sink += a < b; }), 0);
+    EXPECT_EQ(allocations([&] { sink += p < q; }), 0);
+    EXPECT_EQ(allocations([&] { p.setCol(12); }), 0);
+    EXPECT_EQ(allocations([&] { ++p; }), 0);
+    EXPECT_GT(sink, 0);
+}
+
+
+
+
+TEST(AllocationBudgetTestSuite, buffer_lookups)
+{
+    Buffer           buffer(sample_text(100));
+    vector<size_t>   offsets{ 0, 40, 400, 1999 };
+    vector<Position> out(offsets.size());
+
+    buffer.utf16PositionOf(size_t(50));  // Builds the cache of row 3
+
+    EXPECT_EQ(allocations([&] { buffer.positionOf(size_t(1234)); }), 0);
+    EXPECT_EQ(allocations([&] { buffer.offsetOf(Position(7, 3)); }), 0);
+    EXPECT_EQ(allocations([&] { buffer.positionsOf(offsets, out); }), 0);
+    EXPECT_EQ(allocations([&] { buffer.line(42); }), 0);
+    EXPECT_EQ(allocations([&] { buffer.utf16PositionOf(size_t(52)); }), 0);
+    EXPECT_EQ(allocations([&] { buffer.offsetOf(Utf16Position{ 2, 4 }); }), 0);
+    EXPECT_EQ(allocations([&] { buffer.stats(); }), 0);
+    EXPECT_EQ(allocations([&] { buffer.memoryUsage(); }), 0);
+}
+
+
+
+
+TEST(AllocationBudgetTestSuite, buffer_edits)
+{
+    Buffer buffer(sample_text(100));
+    buffer.addMarker(size_t(100));
+    buffer.addDecoration(Position(5, 1), Position(6, 2));
+
+    // Typing grows the text & the index geometrically: amortised O(1).
+    EXPECT_LE(allocations([&] {
+        for (size_t i = 0; i < 1000; ++i) { buffer.insert(500 + i, "x"); }
+    }), 12);
+    EXPECT_LE(allocations([&] {
+        for (size_t i = 0; i < 1000; ++i) { buffer.insert(500 + 2 * i, "\n"); }
+    }), 36);
+    EXPECT_EQ(allocations([&] { buffer.erase(500, 10); }), 0);
+    EXPECT_EQ(allocations([&] { buffer.replace(10, 3, "abc"); }), 0);
+}
+
+
+
+
+TEST(AllocationBudgetTestSuite, buffer_copies)
+{
+    Buffer source(sample_text(100));
+    EXPECT_EQ(allocations([&] { Buffer copy(source); }), 3);  // Text, line & cache arrays
+
+    source.addMarker(size_t(10));
+    source.addDecoration(Position(1, 1), Position(2, 1));
+    EXPECT_EQ(allocations([&] { Buffer copy(source); }), 5);
+}
+
+
+
+
+TEST(AllocationBudgetTestSuite, errors_defer_their_report)
+{
+    size_t length = 0;
+
+    // Building an error stores its arguments; the report is formatted by what().
+    EXPECT_EQ(allocations([] {
+        const X_ built(ERR_ID::INVALID_NUMBER_SIGN, "value {} of {}", 5, 7);
+    }), 0);
+
+    X_ error(ERR_ID::INVALID_NUMBER_SIGN, "value {} of {}", 5, 7);
+    EXPECT_GT(allocations([&] { length += string_view(error.what()).size(); }), 0);
+    EXPECT_EQ(allocations([&] { length += string_view(error.what()).size(); }), 0);
+    EXPECT_GT(length, 0);
+}
+
+
+
+
+TEST(AllocationBudgetTestSuite, position_array_sort)
+{
+    PositionArray32 same;
+    PositionArray32 mixed;
+    for (uint32_t i = 0; i < 300; ++i) {
+        same.push_back(7, 9);
+        mixed.push_back(300 - i, 1 + i % 3);
+    }
+
+    // Every radix pass is skipped: no scratch arrays.
+    EXPECT_EQ(allocations([&] { same.sort(); }), 0);
+    EXPECT_EQ(allocations([&] { mixed.sort(); }), 2);
+    EXPECT_TRUE(mixed.isSorted());
+}
+
+
+
+
+TEST(AllocationBudgetTestSuite, position_map)
+{
+    PositionMap<int> map(1000);
+
+    EXPECT_EQ(allocations([&] {
+        for (uint32_t i = 1; i <= 700; ++i) { map.insert(PackedPosition(i, i), int(i)); }
+    }), 0);
+    EXPECT_EQ(allocations([&] { map.find(Position(5, 5)); }), 0);
+    EXPECT_EQ(allocations([&] { map.erase(Position(5, 5)); }), 0);
+}
+
+
+
+
+TEST(AllocationBudgetTestSuite, lexing)
+{
+    const Buffer buffer(sample_text(200));
+    Lexicon      lexicon(0);
+    size_t       count = 0;
+
+    lexicon.run(1, CharSet::range('a', 'z'), CharSet::range('a', 'z'))
+      .run(2, CharSet::of(" \n"), CharSet::of(" \n"))
+      .skip(2);
+
+    EXPECT_EQ(allocations([&] {
+        for (const Token &token : Lexer(buffer, lexicon)) { count += token.text.size(); }
+    }), 0);
+    EXPECT_GT(count, 0);
+}
+
+
+
+
+TEST(AllocationBudgetTestSuite, line_iteration)
+{
+    const Buffer buffer(sample_text(200));
+    size_t       bytes = 0;
+
+    EXPECT_EQ(allocations([&] {
+        for (const BufferLine line : buffer.lines()) { bytes += line.text.size() + line.row.get(); }
+    }), 0);
+    EXPECT_GT(bytes, 0);
+}
@@ -0,0 +1,273 @@
+#include <text/bracket-index.hpp>
+#include <text/buffer.hpp>
+#include <text/lexer.hpp>
+
+#include <gtest/gtest.h>
+#include "raises.hpp"
+
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <utils/exception.hpp>
+#include <vector>
+
+using namespace Text;
+using namespace std;
+
+
+enum Kind : TokenKind
+{
+    OTHER,
+    WORD,
+    SPACE,
+    STRING,
+    COMMENT,
+    PAREN_OPEN,
+    PAREN_CLOSE,
+    BRACE_OPEN,
+    BRACE_CLOSE
+};
+
+static constexpr BracketPair PAIRS[] = {
+    { PAREN_OPEN, PAREN_CLOSE },
+    { BRACE_OPEN, BRACE_CLOSE },
+};
+
+
+static Lexicon code_lexicon()
+{
+    const CharSet alpha = CharSet::range('a', 'z');
+
+    Lexicon lexicon(OTHER);
+    lexicon.run(WORD, alpha, alpha)
+      .run(SPACE, CharSet::of(" \n"), CharSet::of(" \n"))
+      .quoted(STRING, '"')
+      .blockComment(COMMENT, "/*", "*/")
+      .literal(PAREN_OPEN, "(")
+      .literal(PAREN_CLOSE, ")")
+      .literal(BRACE_OPEN, "{")
+      .literal(BRACE_CLOSE, "}")
+      .skip(SPACE);
+    return lexicon;
+}
+
+
+/**************************************************************
+ * The brackets of `buffer` paired with a stack, the way a full
+ * rescan would: partner[i] is the offset paired with offset i.
+ **************************************************************/
+struct Reference
+{
+    vector<pair<size_t, int>>    brackets;  // (offset, +-(pair + 1))
+    vector<optional<size_t>>     partner;
+    vector<pair<size_t, size_t>> pairs;
+};
+
+
+static Reference scan(const Buffer &buffer, const Lexicon &lexicon)
+{
+    Reference ref;
+    for (const Token &token : Lexer(buffer, lexicon)) {
+        for (size_t p = 0; p < size(PAIRS); ++p) {
+            const int id = int(p) + 1;
+            if (token.kind == PAIRS[p].open) { ref.brackets.push_back({ token.offset, id }); }
+            if (token.kind == PAIRS[p].close) { ref.brackets.push_back({ token.offset, -id }); }
+        }
+    }
+
+    // Depth counts every pair together; an unbalanced closing bracket
+    // pairs with nothing & leaves the stack as it is.
+    ref.partner.resize(ref.brackets.size());
+    vector<size_t> stack;
+    for (size_t i = 0; i < ref.brackets.size(); ++i) {
+        if (ref.brackets[i].second > 0) {
+            stack.push_back(i);
+            continue;
+        }
+        if (stack.empty()) { continue; }
+
+        const size_t open = stack.back();
+        stack.pop_back();
+        if (ref.brackets[open].second == -ref.brackets[i].second) {
+            ref.partner[open] = ref.brackets[i].first;
+            ref.partner[i]    = ref.brackets[open].first;
+            ref.pairs.push_back({ ref.brackets[open].first, ref.brackets[i].first });
+        }
+    }
+    return ref;
+}
+
+
+static optional<pair<size_t, size_t>> innermost(const Reference &ref, size_t offset)
+{
+    optional<pair<size_t, size_t>> best;
+    for (const auto &pair : ref.pairs) {
+        if (pair.first < offset && offset <= pair.second && (!best || pair.first > best->first)) {
+            best = pair;
+        }
+    }
+    return best;
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BracketIndexTestSuite, matches_skip_strings_and_comments)
+{
+    const Lexicon lexicon = code_lexicon();
+    Buffer        buffer("f(a, \")\" /* ) */ {\n  b(c)\n}) x\n");
+    buffer.trackBrackets(lexicon, PAIRS);
+
+    EXPECT_EQ(buffer.bracketCount(), 6);
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 2)), Position(3, 2));
+    EXPECT_EQ(buffer.matchingBracket(Position(3, 2)), Position(1, 2));
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 18)), Position(3, 1));
+    EXPECT_EQ(buffer.matchingBracket(Position(2, 4)), Position(2, 6));
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 7)), nullopt);   // Inside a string
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 13)), nullopt);  // Inside a comment
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 1)), nullopt);
+
+    const auto inner = buffer.enclosingBrackets(Position(2, 5));
+    ASSERT_TRUE(inner.has_value());
+    EXPECT_EQ(inner->first, Position(2, 4));
+    EXPECT_EQ(inner->second, Position(2, 6));
+
+    const auto outer = buffer.enclosingBrackets(Position(2, 1));
+    ASSERT_TRUE(outer.has_value());
+    EXPECT_EQ(outer->first, Position(1, 18));
+    EXPECT_EQ(outer->second, Position(3, 1));
+
+    EXPECT_EQ(buffer.enclosingBrackets(Position(1, 2)), nullopt);  // Before the "("
+    EXPECT_EQ(buffer.enclosingBrackets(Position(3, 4)), nullopt);
+    EXPECT_EQ(buffer.bracketDepth(Position(2, 5)), 3);
+    EXPECT_EQ(buffer.bracketDepth(Position(3, 4)), 0);
+
+    EXPECT_RAISES(buffer.matchingBracket(Position(9, 1)), Text_Buffer::Exception);
+}
+
+
+
+
+TEST(BracketIndexTestSuite, unbalanced_and_mismatched_brackets_are_unmatched)
+{
+    const Lexicon lexicon = code_lexicon();
+    Buffer        buffer(") ( { ) } (");
+    buffer.trackBrackets(lexicon, PAIRS);
+
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 1)), nullopt);  // Nothing to close
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 5)), nullopt);  // "{" meets ")"
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 7)), nullopt);
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 3)), nullopt);   // "(" meets "}"
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 11)), nullopt);  // Never closed
+    EXPECT_EQ(buffer.bracketDepth(Position(1, 2)), -1);
+
+    buffer.replace(4, 3, "{ }");
+    EXPECT_EQ(buffer.text(), ") ( { } } (");
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 5)), Position(1, 7));
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 7)), Position(1, 5));
+}
+
+
+
+
+TEST(BracketIndexTestSuite, random_edits_match_a_rescan)
+{
+    const Lexicon     lexicon  = code_lexicon();
+    const string_view pieces[] = { "(", ")", "{", "}", "a", " ", "\n", "\"", "/*", "*/" };
+    mt19937           rng(3);
+
+    Buffer buffer("f(a) {\n  g(\"}\", /* ( */ b)\n}\n");
+    buffer.trackBrackets(lexicon, PAIRS);
+
+    for (size_t step = 0; step < 1500; ++step) {
+        const size_t offset  = rng() % (buffer.size() + 1);
+        const size_t removed = min<size_t>(rng() % 3, buffer.size() - offset);
+
+        string text;
+        for (size_t i = rng() % 4; i > 0; --i) { text += pieces[rng() % size(pieces)]; }
+        buffer.replace(offset, removed, text);
+
+        const Reference ref = scan(buffer, lexicon);
+        ASSERT_EQ(buffer.bracketCount(), ref.brackets.size()) << "step " << step;
+
+        for (size_t i = 0; i < ref.brackets.size(); ++i) {
+            const auto got = buffer.matchingBracket(buffer.positionOf(ref.brackets[i].first));
+            const auto want =
+              ref.partner[i] ? optional(buffer.positionOf(*ref.partner[i])) : nullopt;
+            ASSERT_EQ(got, want) << "step " << step << ", bracket " << i;
+        }
+
+        for (size_t probe = 0; probe < 8; ++probe) {
+            const size_t at   = rng() % (buffer.size() + 1);
+            const auto   want = innermost(ref, at);
+            const auto   got  = buffer.enclosingBrackets(buffer.positionOf(at));
+
+            // A mismatched pair in between hides the pairs around it.
+            if (!got) { continue; }
+            ASSERT_TRUE(want.has_value()) << "step " << step << ", offset " << at;
+            EXPECT_EQ(got->first, buffer.positionOf(want->first)) << "step " << step;
+            EXPECT_EQ(got->second, buffer.positionOf(want->second)) << "step " << step;
+        }
+    }
+}
+
+
+
+
+TEST(BracketIndexTestSuite, untracked_buffers_have_no_brackets)
+{
+    const Lexicon lexicon = code_lexicon();
+    Buffer        buffer("(a)");
+
+    EXPECT_EQ(buffer.bracketCount(), 0);
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 1)), nullopt);
+    EXPECT_EQ(buffer.memoryUsage().brackets, 0);
+
+    buffer.trackBrackets(lexicon, PAIRS);
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 1)), Position(1, 3));
+    EXPECT_GT(buffer.memoryUsage().brackets, 0);
+
+    const Buffer copy = buffer;
+    EXPECT_EQ(copy.matchingBracket(Position(1, 3)), Position(1, 1));
+
+    buffer.untrackBrackets();
+    buffer.insert(0, "(");
+    EXPECT_EQ(buffer.bracketCount(), 0);
+    EXPECT_EQ(buffer.memoryUsage().brackets, 0);
+}
+
+
+
+
+TEST(BracketIndexTestSuite, shrinking_releases_the_index)
+{
+    const Lexicon lexicon = code_lexicon();
+
+    string text;
+    for (int i = 0; i < 500; ++i) { text += "f(a) { b(c) }\n"; }
+
+    Buffer buffer(text);
+    buffer.trackBrackets(lexicon, PAIRS);
+    const size_t cut = buffer.offsetOf(Position(11, 1));
+    buffer.erase(cut, buffer.size() - cut);
+
+    const size_t before = buffer.memoryUsage().brackets;
+    EXPECT_GT(buffer.shrinkToFit(), 0);
+    EXPECT_LT(buffer.memoryUsage().brackets, before);
+
+    // The shrunk index still matches & takes edits.
+    EXPECT_EQ(buffer.bracketCount(), 60);
+    EXPECT_EQ(buffer.matchingBracket(Position(10, 6)), Position(10, 13));
+    buffer.insert(0, "{(x)}\n");
+    EXPECT_EQ(buffer.bracketCount(), 64);
+    EXPECT_EQ(buffer.matchingBracket(Position(1, 1)), Position(1, 5));
+    EXPECT_EQ(buffer.matchingBracket(Position(11, 2)), Position(11, 4));
+}
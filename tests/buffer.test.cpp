@@ -0,0 +1,514 @@
+#include <text/buffer.hpp>
+
+#include <gtest/gtest.h>
+#include "raises.hpp"
+
+#include <string>
+#include <thread>
+#include <utils/exception.hpp>
+#include <vector>
+
+using namespace Text;
+using namespace std;
+
+
+
+
+// "é" is 2 bytes & 1 UTF-16 unit, "😀" is 4 bytes & 2 UTF-16 units.
+const string SAMPLE = "abc\n"
+                      "h\xC3\xA9llo \xF0\x9F\x98\x80 world\r\n"
+                      "\n"
+                      "end";
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, line_index)
+{
+    Buffer empty;
+    Buffer buffer(SAMPLE);
+
+    EXPECT_EQ(empty.lineCount(), 1);
+    EXPECT_EQ(buffer.lineCount(), 4);
+
+    EXPECT_EQ(buffer.line(1), "abc");
+    EXPECT_EQ(buffer.line(2), "h\xC3\xA9llo \xF0\x9F\x98\x80 world");
+    EXPECT_EQ(buffer.line(3), "");
+    EXPECT_EQ(buffer.line(4), "end");
+
+    EXPECT_RAISES(buffer.line(0), Exception);
+    EXPECT_RAISES(buffer.line(5), Exception);
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, offset_position_round_trip)
+{
+    Buffer buffer(SAMPLE);
+
+    for (size_t offset = 0; offset <= buffer.size(); ++offset) {
+        EXPECT_EQ(buffer.offsetOf(buffer.positionOf(offset)), offset);
+    }
+
+    EXPECT_TRUE(buffer.positionOf(0) == Position(1, 1));
+    EXPECT_TRUE(buffer.positionOf(4) == Position(2, 1));
+    EXPECT_TRUE(buffer.positionOf(buffer.size()) == Position(4, 4));
+
+    EXPECT_RAISES(buffer.positionOf(buffer.size() + 1), Exception);
+    EXPECT_RAISES(buffer.offsetOf(Position(1, 6)), Exception);
+    EXPECT_RAISES(buffer.offsetOf(Position(5, 1)), Exception);
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, utf16_columns)
+{
+    Buffer buffer(SAMPLE);
+
+    // "h" "é" "llo " -> 6 units, 7 bytes. The emoji is 2 units wide.
+    EXPECT_EQ(buffer.offsetOf(Utf16Position{ 1, 6 }), 4 + 7);
+    EXPECT_EQ(buffer.offsetOf(Utf16Position{ 1, 8 }), 4 + 11);
+    EXPECT_EQ(buffer.offsetOf(Utf16Position{ 1, 7 }), 4 + 7);  // Splits the pair
+    EXPECT_EQ(buffer.offsetOf(Utf16Position{ 1, 99 }), 4 + 17);  // Clamps to "\r\n"
+    EXPECT_EQ(buffer.offsetOf(Utf16Position{ 9, 0 }), buffer.size());
+
+    EXPECT_TRUE(buffer.positionOf(Utf16Position{ 1, 8 }) == Position(2, 12));
+
+    const Utf16Position lsp = buffer.utf16PositionOf(Position(2, 12));
+    EXPECT_EQ(lsp.line, 1);
+    EXPECT_EQ(lsp.character, 8);
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, utf16_long_line_checkpoints)
+{
+    string row;
+    for (int i = 0; i < 500; ++i) { row += "x\xE2\x82\xAC\xF0\x9F\x98\x80"; }
+
+    Buffer buffer(row);
+
+    // Each repetition is 8 bytes & 4 UTF-16 units.
+    for (size_t i = 0; i <= 500; i += 7) {
+        EXPECT_EQ(buffer.offsetOf(Utf16Position{ 0, i * 4 }), i * 8);
+        EXPECT_EQ(buffer.utf16PositionOf(i * 8).character, i * 4);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, utf16_rows_built_from_threads)
+{
+    string text;
+    for (int i = 0; i < 300; ++i) { text += "x\xE2\x82\xAC" + string(size_t(i % 90), 'y') + "\n"; }
+
+    // Every reader asks for the same unbuilt rows at once.
+    const Buffer   buffer(text);
+    vector<thread> readers;
+    vector<size_t> mismatches(4);
+
+    for (size_t t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t]() {
+            for (size_t row = 1; row <= 300; ++row) {
+                const size_t length = 4 + (row - 1) % 90;
+                const auto   lsp    = buffer.utf16PositionOf(Position(row, length + 1));
+
+                mismatches[t] += lsp.character != length - 2;
+                mismatches[t] += buffer.offsetOf(lsp) != buffer.offsetOf(Position(row, length + 1));
+            }
+        });
+    }
+    for (thread &reader : readers) { reader.join(); }
+
+    EXPECT_EQ(mismatches, vector<size_t>(4, 0));
+    EXPECT_GT(buffer.memoryUsage().utf16Caches, 0);
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, edits_maintain_line_index)
+{
+    Buffer buffer("one\ntwo\nthree");
+
+    buffer.insert(4, "2a\n2b\n");
+    EXPECT_EQ(buffer.text(), "one\n2a\n2b\ntwo\nthree");
+    EXPECT_EQ(buffer.lineCount(), 5);
+    EXPECT_EQ(buffer.line(3), "2b");
+
+    buffer.erase(2, 8);
+    EXPECT_EQ(buffer.text(), "ontwo\nthree");
+    EXPECT_EQ(buffer.lineCount(), 2);
+    EXPECT_EQ(buffer.line(2), "three");
+
+    EXPECT_RAISES(buffer.replace(5, 100, ""), Exception);
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, apply_lsp_changes)
+{
+    Buffer buffer("h\xC3\xA9llo\nworld");
+
+    vector<Utf16Change> changes{
+        { Utf16Range{ { 0, 1 }, { 0, 2 } }, "e" },        // "é" -> "e"
+        { Utf16Range{ { 1, 0 }, { 1, 5 } }, "\xF0\x9F\x98\x80" },
+        { Utf16Range{ { 1, 2 }, { 1, 2 } }, "!\n" },      // After the emoji
+    };
+
+    buffer.applyChanges(changes);
+    EXPECT_EQ(buffer.text(), "hello\n\xF0\x9F\x98\x80!\n");
+    EXPECT_EQ(buffer.lineCount(), 3);
+
+    vector<Utf16Change> full{ { nullopt, "reset" } };
+    buffer.applyChanges(full);
+    EXPECT_EQ(buffer.text(), "reset");
+    EXPECT_EQ(buffer.lineCount(), 1);
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, batch_offset_conversion)
+{
+    string text;
+    for (int i = 0; i < 300; ++i) { text += string(size_t(i % 17), 'x') + "\n"; }
+
+    Buffer buffer(text);
+
+    vector<size_t> sorted;
+    for (size_t offset = 0; offset <= buffer.size(); offset += 3) { sorted.push_back(offset); }
+
+    vector<size_t> unsorted(sorted.rbegin(), sorted.rend());
+    unsorted.push_back(0);
+    unsorted.push_back(buffer.size());
+
+    for (const auto &offsets : { sorted, unsorted }) {
+        vector<Position> positions(offsets.size());
+        vector<size_t>   roundTrip(offsets.size());
+
+        buffer.positionsOf(offsets, positions);
+        buffer.offsetsOf(positions, roundTrip);
+
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            EXPECT_TRUE(positions[i] == buffer.positionOf(offsets[i]));
+        }
+
+        EXPECT_EQ(roundTrip, offsets);
+
+        vector<PackedPosition> packed(offsets.size());
+        buffer.positionsOf(offsets, packed);
+
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            EXPECT_TRUE(packed[i].toPosition() == positions[i]);
+        }
+    }
+
+    vector<Position> tooShort(1);
+    EXPECT_RAISES(buffer.positionsOf(sorted, tooShort), Exception);
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, markers_gravity)
+{
+    Buffer buffer("hello world");
+
+    const MarkerId left  = buffer.addMarker(5, Gravity::LEFT);
+    const MarkerId right = buffer.addMarker(5, Gravity::RIGHT);
+    const MarkerId after = buffer.addMarker(Position(1, 8));
+
+    buffer.insert(5, ",");
+    EXPECT_EQ(buffer.markerOffset(left), 5);
+    EXPECT_EQ(buffer.markerOffset(right), 6);
+    EXPECT_EQ(buffer.markerOffset(after), 8);
+
+    buffer.replace(0, 9, "X\nY");  // Swallows every marker
+    EXPECT_EQ(buffer.markerOffset(left), 0);
+    EXPECT_EQ(buffer.markerOffset(right), 3);
+    EXPECT_EQ(buffer.markerOffset(after), 0);
+    EXPECT_TRUE(buffer.markerPosition(right) == Position(2, 2));
+
+    buffer.removeMarker(after);
+    EXPECT_EQ(buffer.markerCount(), 2);
+    EXPECT_RAISES(buffer.markerOffset(after), Exception);
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, markers_follow_random_edits)
+{
+    // Cross-check the lazy tree against moving every marker by hand.
+    Buffer           buffer(string(2000, 'a'));
+    vector<size_t>   expected;
+    vector<MarkerId> ids;
+    uint32_t         seed = 12345;
+
+    auto next = [&seed](uint32_t bound) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % bound;
+    };
+
+    for (size_t i = 0; i < 500; ++i) {
+        const size_t offset = next(uint32_t(buffer.size() + 1));
+        ids.push_back(buffer.addMarker(offset, i % 2 ? Gravity::RIGHT : Gravity::LEFT));
+        expected.push_back(offset);
+    }
+
+    for (int step = 0; step < 300; ++step) {
+        const size_t offset   = next(uint32_t(buffer.size() + 1));
+        const size_t length   = next(uint32_t(std::min<size_t>(40, buffer.size() - offset) + 1));
+        const size_t inserted = next(30);
+
+        for (size_t i = 0; i < ids.size(); ++i) {
+            const bool right = i % 2;
+            size_t    &at    = expected[i];
+
+            if (at > offset + length || (at == offset + length && (length || right))) {
+                at = at - length + inserted;
+            }
+            else if (at > offset || (at == offset && right)) {
+                at = right ? offset + inserted : offset;
+            }
+        }
+
+        buffer.replace(offset, length, string(inserted, 'b'));
+    }
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        EXPECT_EQ(buffer.markerOffset(ids[i]), expected[i]);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+TEST(BufferClassTestSuite, decorations_viewport_query)
+{
+    string text;
+    for (int i = 0; i < 100; ++i) { text += "row\n"; }
+
+    Buffer               buffer(text);
+    vector<DecorationId> ids;
+
+    // One decoration per row, plus one spanning rows 10 - 60.
+    for (size_t row = 1; row <= 100; ++row) {
+        ids.push_back(buffer.addDecoration(Position(row, 1), Position(row, 3), uint32_t(row)));
+    }
+    const DecorationId wide = buffer.addDecoration(Position(10, 2), Position(60, 1));
+
+    vector<DecorationId> hits;
+    buffer.decorationsInRows(20, 22, hits);
+
+    EXPECT_EQ(hits.size(), 4);
+    EXPECT_NE(std::find(hits.begin(), hits.end(), wide), hits.end());
+    EXPECT_EQ(buffer.decorationKind(hits.back()), 22);
+
+    // Typing at an edge must not grow the range; a deletion shrinks it.
+    buffer.insert(buffer.offsetOf(Position(20, 1)), "xx");
+    buffer.insert(buffer.offsetOf(Position(20, 5)), "yy");
+    EXPECT_TRUE(buffer.decorationRange(ids[19]).first == Position(20, 3));
+    EXPECT_TRUE(buffer.decorationRange(ids[19]).second == Position(20, 5));
+
+    buffer.erase(buffer.offsetOf(Position(5, 1)), 4 * 10);  // Rows 5 - 14
+    EXPECT_TRUE(buffer.decorationRange(wide).first == Position(5, 1));
+    EXPECT_TRUE(buffer.decorationRange(wide).second == Position(50, 1));
+    EXPECT_EQ(buffer.decorationCount(), 101);
+
+    buffer.removeDecoration(wide);
+    hits.clear();
+    buffer.decorationsInRows(1, buffer.lineCount(), hits);
+    EXPECT_EQ(hits.size(), 100);
+}
+
+
+
+
+TEST(BufferClassTestSuite, markers_collected_at_shared_offsets)
+{
+    MarkerTree       tree;
+    vector<MarkerId> out;
+
+    for (int i = 0; i < 3; ++i) { tree.add(5); }
+    tree.collect(5, 5, out);
+    EXPECT_EQ(out.size(), 3);
+
+    // A deletion collapses every LEFT marker inside it onto one offset.
+    for (size_t offset = 10; offset < 60; ++offset) { tree.add(offset); }
+    tree.add(60, Gravity::RIGHT);
+    tree.replace(10, 50, 0);
+
+    out.clear();
+    tree.collect(10, 10, out);
+    EXPECT_EQ(out.size(), 51);
+
+    out.clear();
+    tree.collect(0, 10, out);
+    EXPECT_EQ(out.size(), 54);
+
+    out.clear();
+    tree.collect(6, 9, out);
+    EXPECT_TRUE(out.empty());
+}
+
+
+
+
+TEST(BufferClassTestSuite, markers_and_decorations_read_from_threads)
+{
+    string text;
+    for (int i = 0; i < 400; ++i) { text += "row\n"; }
+
+    Buffer               buffer(text);
+    vector<MarkerId>     markers;
+    vector<DecorationId> decorations;
+
+    for (size_t row = 1; row <= 400; ++row) {
+        markers.push_back(buffer.addMarker(Position(row, 2)));
+        decorations.push_back(buffer.addDecoration(Position(row, 1), Position(row, 3)));
+    }
+
+    // Leave shift tags pending all over both trees.
+    for (size_t row = 1; row <= 400; row += 7) {
+        buffer.insert(buffer.offsetOf(Position(row, 1)), "x");
+    }
+
+    // Const queries read the tags without pushing them, so readers can share the Buffer.
+    const Buffer &shared = buffer;
+    vector<thread> readers;
+    vector<size_t> mismatches(4);
+
+    for (size_t t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t]() {
+            for (size_t row = 1; row <= 400; ++row) {
+                const size_t column = (row - 1) % 7 == 0 ? 3 : 2;
+                const auto   range  = shared.decorationRange(decorations[row - 1]);
+
+                mismatches[t] += shared.markerPosition(markers[row - 1]) != Position(row, column);
+                mismatches[t] += range.second != Position(row, column + 1);
+
+                vector<DecorationId> hits;
+                shared.decorationsInRows(row, row, hits);
+                mismatches[t] += hits.size() != 1 || hits[0] != decorations[row - 1];
+            }
+        });
+    }
+    for (thread &reader : readers) { reader.join(); }
+
+    EXPECT_EQ(mismatches, vector<size_t>(4, 0));
+}
+
+
+
+
+TEST(BufferClassTestSuite, memory_usage)
+{
+    string text;
+    for (size_t row = 0; row < 200; ++row) { text += "h\xC3\xA9llo world, row of text\n"; }
+
+    Buffer buffer(text);
+    const MemoryUsage fresh = buffer.memoryUsage();
+
+    EXPECT_GE(fresh.text, text.size());
+    EXPECT_GE(fresh.lineIndex, 201 * sizeof(size_t));
+    EXPECT_EQ(fresh.markers, 0);
+    EXPECT_EQ(fresh.total(), fresh.text + fresh.lineIndex + fresh.utf16Caches);
+
+    for (size_t row = 0; row < 200; ++row) { buffer.utf16PositionOf(Position(row + 1, 3)); }
+    for (size_t i = 0; i < 50; ++i) { buffer.addMarker(i * 10); }
+
+    const MemoryUsage used = buffer.memoryUsage();
+    EXPECT_GT(used.utf16Caches, fresh.utf16Caches);
+    EXPECT_GT(used.markers, 0);
+
+    // Dropped caches are rebuilt on demand with the same results.
+    EXPECT_EQ(buffer.dropCaches(), used.utf16Caches - fresh.utf16Caches);
+    EXPECT_EQ(buffer.memoryUsage().utf16Caches, fresh.utf16Caches);
+    EXPECT_EQ(buffer.utf16PositionOf(Position(7, 4)).character, 2);
+
+    buffer.erase(0, text.size() / 2);
+    for (MarkerId id = 10; id < 50; ++id) { buffer.removeMarker(id); }
+
+    const size_t before   = buffer.memoryUsage().total();
+    const size_t released = buffer.shrinkToFit();
+    EXPECT_GT(released, 0);
+    EXPECT_EQ(buffer.memoryUsage().total(), before - released);
+    EXPECT_LT(buffer.memoryUsage().text, fresh.text);
+    EXPECT_LT(buffer.memoryUsage().markers, used.markers);
+    EXPECT_EQ(buffer.markerCount(), 10);
+    EXPECT_EQ(buffer.markerOffset(9), 0);
+    EXPECT_EQ(buffer.text(), string_view(text).substr(text.size() / 2));
+}
@@ -0,0 +1,76 @@
+#include <text/coordinate-arithmetic.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <utils/err.hpp>
+
+using namespace Text;
+using namespace std;
+
+
+
+
+
+
+
+
+
+
+TEST(CoordinateArithmeticTestSuite, checked_operations)
+{
+    static_assert(checked_add(Coordinate(2), 3).value() == 5);
+
+    EXPECT_EQ(checked_add(Coordinate(2), Coordinate(3)).value(), 5);
+    EXPECT_EQ(checked_add(Coordinate(2), -2).value(), 0);
+    EXPECT_EQ(checked_add(Coordinate(2), -3).error(), ERR_ID::INVALID_NUMBER_SIGN);
+    EXPECT_EQ(checked_add(Coordinate(Coordinate::MAX), 1).error(), ERR_ID::SEG_FAULT_INT_MAX);
+
+    EXPECT_EQ(checked_sub(Coordinate(5), Coordinate(5)).value(), 0);
+    EXPECT_EQ(checked_sub(Coordinate(2), Coordinate(5)).error(), ERR_ID::INVALID_NUMBER_SIGN);
+    EXPECT_EQ(checked_sub(Coordinate(2), -5).value(), 7);
+
+    EXPECT_EQ(checked_mul(Coordinate(0), -4).value(), 0);
+    EXPECT_EQ(checked_mul(Coordinate(3), -4).error(), ERR_ID::INVALID_NUMBER_SIGN);
+    EXPECT_EQ(checked_mul(Coordinate32(1u << 20), 1u << 20).error(), ERR_ID::SEG_FAULT_INT_MAX);
+
+    EXPECT_EQ(checked_div(Coordinate(9), 2).value(), 4);
+    EXPECT_EQ(checked_div(Coordinate(1), -2).value(), 0);
+    EXPECT_EQ(checked_div(Coordinate(9), -2).error(), ERR_ID::INVALID_NUMBER_SIGN);
+    EXPECT_EQ(checked_div(Coordinate(9), Coordinate(0)).error(), ERR_ID::DIVISION_BY_ZERO);
+    EXPECT_EQ(checked_div(Coordinate32(9u), uint64_t(1) << 40).value(), 0u);
+}
+
+
+
+
+TEST(CoordinateArithmeticTestSuite, saturating_operations)
+{
+    constexpr auto MAX32 = Coordinate32::MAX;
+
+    EXPECT_EQ(saturating_add(Coordinate32(MAX32 - 1), 5), MAX32);
+    EXPECT_EQ(saturating_add(Coordinate32(3u), -5), 0u);
+    EXPECT_EQ(saturating_sub(Coordinate32(3u), Coordinate32(5u)), 0u);
+    EXPECT_EQ(saturating_sub(Coordinate32(3u), -5), 8u);
+    EXPECT_EQ(saturating_mul(Coordinate32(MAX32 / 2), 3), MAX32);
+    EXPECT_EQ(saturating_mul(Coordinate32(7u), -1), 0u);
+    EXPECT_EQ(saturating_div(Coordinate32(7u), 0), MAX32);
+    EXPECT_EQ(saturating_div(Coordinate32(7u), -3), 0u);
+}
+
+
+
+
+TEST(CoordinateArithmeticTestSuite, wrapping_operations)
+{
+    constexpr auto MAX32 = Coordinate32::MAX;
+
+    EXPECT_EQ(wrapping_add(Coordinate32(MAX32), 2), 1u);
+    EXPECT_EQ(wrapping_sub(Coordinate32(0u), Coordinate32(1u)), MAX32);
+    EXPECT_EQ(wrapping_add(Coordinate32(1u), -2), MAX32);
+    EXPECT_EQ(wrapping_mul(Coordinate32(1u << 31), 2), 0u);
+    EXPECT_EQ(wrapping_mul(UncheckedCoordinate(3), -1), UncheckedCoordinate::MAX - 2);
+    EXPECT_EQ(wrapping_div(Coordinate32(9u), Coordinate32(2u)), 4u);
+    EXPECT_EQ(wrapping_div(Coordinate32(9u), -3), MAX32 - 2);
+    EXPECT_EQ(wrapping_div(Coordinate32(9u), 0), 0u);
+}
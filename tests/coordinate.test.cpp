@@ -14,9 +14,12 @@
 #include <text/coordinate.hpp>
 
 #include <gtest/gtest.h>
+#include "raises.hpp"
 
 #include <cstdint>
+#include <thread>
 #include <utils/err.hpp>
+#include <vector>
 
 using namespace Text;
 using namespace std;
@@ -71,9 +74,9 @@ TEST(CoordinateBasicTests, standard_constructor)
   EXPECT_NO_THROW(Coordinate coord);
   EXPECT_NO_THROW(Coordinate coord(1));
   EXPECT_NO_THROW(Coordinate coord{ 1 });
-  EXPECT_THROW(Coordinate coord(-2), X_);    // Exception Tests
-  EXPECT_THROW(Coordinate coord{ -1 }, X_);  // Exception Tests
-  EXPECT_THROW(Coordinate coord(NEG_5), X_);
+  EXPECT_RAISES(Coordinate coord(-2), X_);    // Exception Tests
+  EXPECT_RAISES(Coordinate coord{ -1 }, X_);  // Exception Tests
+  EXPECT_RAISES(Coordinate coord(NEG_5), X_);
 }
 
 
@@ -127,8 +130,8 @@ TEST(CoordinateBasicTests, set_func)
   EXPECT_EQ(gamma(), 2);
   EXPECT_EQ(delta(), 3);
 
-  EXPECT_THROW(alpha.set(-1), X_);              // Exception Tests
-  EXPECT_THROW(alpha.set(-9999999999999), X_);  // Exception Tests
+  EXPECT_RAISES(alpha.set(-1), X_);              // Exception Tests
+  EXPECT_RAISES(alpha.set(-9999999999999), X_);  // Exception Tests
 }
 
 
@@ -157,8 +160,8 @@ TEST(CoordinateBasicTests, assignment_operator)
   EXPECT_EQ(gamma(), 2);
   EXPECT_EQ(delta(), 3);
 
-  EXPECT_THROW(alpha = -1, X_);               // Exception Tests
-  EXPECT_THROW(Coordinate epsilon = -2, X_);  // Exception Tests
+  EXPECT_RAISES(alpha = -1, X_);               // Exception Tests
+  EXPECT_RAISES(Coordinate epsilon = -2, X_);  // Exception Tests
 }
 
 
@@ -690,7 +693,7 @@ TEST(CoordinateArithmetic_CC, subtraction)
 {
     // The EXPECT_THROW tests ensures that an exception is thrown
     // if an operation would result in a negative Coordinate value.
-    EXPECT_THROW(c00 - c01, X_ );  //  (0 - 1) -> Ex
+    EXPECT_RAISES(c00 - c01, X_ );  //  (0 - 1) -> Ex
     EXPECT_EQ   (c01 - c01, c00);  //  (1 - 1) -> 0
     EXPECT_EQ   (c02 - c01, c01);  //  (2 - 1) -> 1
 
@@ -698,8 +701,8 @@ TEST(CoordinateArithmetic_CC, subtraction)
     EXPECT_EQ   (c03 - c01, c02);  //  (3 - 1) -> 2
     EXPECT_EQ   (c03 - c02, c01);  //  (3 - 2) -> 1
     EXPECT_EQ   (c03 - c03, c00);  //  (3 - 3) -> 0
-    EXPECT_THROW(c03 - c04, X_ );  //  (3 - 4) -> Ex
-    EXPECT_THROW(c03 - c05, X_ );  //  (3 - 5) -> Ex
+    EXPECT_RAISES(c03 - c04, X_ );  //  (3 - 4) -> Ex
+    EXPECT_RAISES(c03 - c05, X_ );  //  (3 - 5) -> Ex
 }
 
 
@@ -739,8 +742,8 @@ TEST(CoordinateArithmetic_CC, multiplication)
 TEST(CoordinateArithmetic_CC, division) {
     EXPECT_NO_THROW(c00 / c01);  // Dividing into zero should not throw
 
-    EXPECT_THROW(c00 / c00, X_);  // Division by zero should throw
-    EXPECT_THROW(c01 / c00, X_);  // Division by zero should throw
+    EXPECT_RAISES(c00 / c00, X_);  // Division by zero should throw
+    EXPECT_RAISES(c01 / c00, X_);  // Division by zero should throw
 
     EXPECT_EQ(c00 / c02, c00);  // (00 / 2) -> 0
     EXPECT_EQ(c05 / c02, c02);  // (05 / 2) -> 2
@@ -762,7 +765,7 @@ TEST(CoordinateArithmetic_CI, addition)
     EXPECT_EQ   (c03 +  2, c05);  // (3 +  2) ->  5
     EXPECT_EQ   (c02 +  1, c03);  // (2 +  1) ->  3
     EXPECT_EQ   (c01 +  0, c01);  // (1 +  0) ->  1
-    EXPECT_THROW(c00 + -1,  X_);  // (0 + -1) -> -1 (THROWS EXCEPTION)
+    EXPECT_RAISES(c00 + -1,  X_);  // (0 + -1) -> -1 (THROWS EXCEPTION)
 
     // Make sure negative numbers on rightside don't throw errors if
     // the result is a non-negative Coordinate.
@@ -786,8 +789,8 @@ TEST(CoordinateArithmetic_CI, subtraction)
     EXPECT_EQ   (c02 -  0, c02);  // (2 -  0) ->  2
     EXPECT_EQ   (c02 -  1, c01);  // (2 -  1) ->  1
     EXPECT_EQ   (c02 -  2, c00);  // (2 -  2) ->  0
-    EXPECT_THROW(c02 -  3, X_);   // (2 -  3) -> -1 (THROWS EXCEPTION)
-    EXPECT_THROW(c02 -  4, X_);   // (2 -  3) -> -2 (THROWS EXCEPTION)
+    EXPECT_RAISES(c02 -  3, X_);   // (2 -  3) -> -1 (THROWS EXCEPTION)
+    EXPECT_RAISES(c02 -  4, X_);   // (2 -  3) -> -2 (THROWS EXCEPTION)
 }
 
 
@@ -804,8 +807,8 @@ TEST(CoordinateArithmetic_CI, multiplication)
     EXPECT_EQ(   c03 *  2, c06); // (3 *  2) ->  6
     EXPECT_EQ(   c03 *  1, c03); // (3 *  1) ->  3
     EXPECT_EQ(   c03 *  0, c00); // (3 *  0) ->  0
-    EXPECT_THROW(c03 * -1, X_);  // (3 * -1) -> -3 (THROWS EXCEPTION)
-    EXPECT_THROW(c03 * -2, X_);  // (3 * -2) -> -6 (THROWS EXCEPTION)
+    EXPECT_RAISES(c03 * -1, X_);  // (3 * -1) -> -3 (THROWS EXCEPTION)
+    EXPECT_RAISES(c03 * -2, X_);  // (3 * -2) -> -6 (THROWS EXCEPTION)
 }
 
 
@@ -822,9 +825,9 @@ TEST(CoordinateArithmetic_CI, division)
     EXPECT_EQ   (c06 / 3, c02);  // (6 / 3) -> 2
     EXPECT_EQ   (c06 / 2, c03);  // (6 / 2) -> 3
     EXPECT_EQ   (c06 / 1, c06);  // (6 / 1) -> 6
-    EXPECT_THROW(c06 / 0, X_);   // (6 / 0) NOT A REAL NUM -> (THROWS EXCEPTION)
-    EXPECT_THROW(c06 /-1, X_);   // (6 /-1) -> -6 (THROWS EXCEPTION)
-    EXPECT_THROW(c06 /-2, X_);   // (6 /-2) -> -3 (THROWS EXCEPTION)
+    EXPECT_RAISES(c06 / 0, X_);   // (6 / 0) NOT A REAL NUM -> (THROWS EXCEPTION)
+    EXPECT_RAISES(c06 /-1, X_);   // (6 /-1) -> -6 (THROWS EXCEPTION)
+    EXPECT_RAISES(c06 /-2, X_);   // (6 /-2) -> -3 (THROWS EXCEPTION)
 }
 
 
@@ -842,7 +845,7 @@ TEST(CoordinateArithmetic_IC, addition)
     EXPECT_EQ   ( 2 + c03, c05);  // (2 +  3) -> 5
     EXPECT_EQ   ( 1 + c02, c03);  // (1 +  2) -> 3
     EXPECT_EQ   ( 0 + c01, c01);  // (0 +  1) -> 1
-    EXPECT_THROW(-1 + c00,  X_);  // (-1 + 0) -> -1 (THROWS EXCEPTION)
+    EXPECT_RAISES(-1 + c00,  X_);  // (-1 + 0) -> -1 (THROWS EXCEPTION)
 
     // Make sure negative numbers on rightside don't throw errors if
     // the result is a non-negative Coordinate.
@@ -863,7 +866,7 @@ TEST(CoordinateArithmetic_IC, addition)
 
 TEST(CoordinateArithmetic_IC, subtraction)
 {
-    EXPECT_THROW(0 - c01, X_);   // (0 - 1) -> -1 (THROWS EXCEPTION)
+    EXPECT_RAISES(0 - c01, X_);   // (0 - 1) -> -1 (THROWS EXCEPTION)
     EXPECT_EQ   (1 - c01, c00);  // (1 - 1) ->  0
     EXPECT_EQ   (2 - c01, c01);  // (2 - 2) ->  1
     EXPECT_EQ   (3 - c01, c02);  // (3 - 3) ->  2
@@ -883,8 +886,8 @@ TEST(CoordinateArithmetic_IC, multiplication)
     EXPECT_EQ(    2 * c02, c04); // ( 2 * 2) ->  4
     EXPECT_EQ(    1 * c02, c02); // ( 1 * 2) ->  2
     EXPECT_EQ(    0 * c02, c00); // ( 0 * 2) ->  0
-    EXPECT_THROW(-1 * c02, X_);  // (-1 * 2) -> -2 (THROWS EXCEPTION)
-    EXPECT_THROW(-2 * c02, X_);  // (-2 * 2) -> -4 (THROWS EXCEPTION)
+    EXPECT_RAISES(-1 * c02, X_);  // (-1 * 2) -> -2 (THROWS EXCEPTION)
+    EXPECT_RAISES(-2 * c02, X_);  // (-2 * 2) -> -4 (THROWS EXCEPTION)
 }
 
 
@@ -901,10 +904,10 @@ TEST(CoordinateArithmetic_IC, division)
     EXPECT_EQ   ( 6 / c03, c02);  // ( 6 / 3) ->  2
     EXPECT_EQ   ( 3 / c03, c01);  // ( 3 / 3) ->  1
     EXPECT_EQ   ( 0 / c03, c00);  // ( 0 / 3) ->  0
-    EXPECT_THROW(-3 / c03, X_);   // (-3 / 3) -> -1 (THROWS EXCEPTION)
-    EXPECT_THROW(-6 / c03, X_);   // (-6 / 3) -> -2 (THROWS EXCEPTION)
+    EXPECT_RAISES(-3 / c03, X_);   // (-3 / 3) -> -1 (THROWS EXCEPTION)
+    EXPECT_RAISES(-6 / c03, X_);   // (-6 / 3) -> -2 (THROWS EXCEPTION)
 
-    EXPECT_THROW(100 / c00, X_);  // Division by zero should throw
+    EXPECT_RAISES(100 / c00, X_);  // Division by zero should throw
 }
 
 
@@ -945,4 +948,193 @@ TEST(CoordinateIncrementalOps, decrement)
     EXPECT_EQ(--coord, Coordinate(0));
     EXPECT_EQ(--coord, Coordinate(0));
     EXPECT_EQ(--coord, Coordinate(0));
-}
\ No newline at end of file
+}
+
+
+
+
+
+
+
+
+
+TEST(CoordinatePolicies, constexpr_and_trivially_copyable)
+{
+    static_assert(std::is_trivially_copyable_v<Coordinate>);
+    static_assert(Coordinate(3) + Coordinate(4) == Coordinate(7));
+    static_assert(Coordinate(9) - 4 == 5);
+    static_assert(UncheckedCoordinate(12) / UncheckedCoordinate(4) == UncheckedCoordinate(3));
+
+    EXPECT_EQ(sizeof(UncheckedCoordinate), sizeof(size_t));
+}
+
+
+
+
+
+
+
+
+
+
+TEST(CoordinatePolicies, unchecked_never_throws)
+{
+    UncheckedCoordinate coord(2);
+
+    EXPECT_NO_THROW(coord - 5);
+    EXPECT_NO_THROW(coord / 0);
+    EXPECT_NO_THROW(coord.set(-1));
+    EXPECT_RAISES(Coordinate(2) - Coordinate(5), X_);
+
+    // Converting between policies copies the value without a check.
+    Coordinate checked = UncheckedCoordinate(42);
+    EXPECT_EQ(checked, 42);
+}
+
+
+
+
+
+
+
+
+
+
+TEST(CoordinatePolicies, thirty_two_bit_width)
+{
+    constexpr size_t TOO_BIG = size_t(UINT32_MAX) + 1;
+
+    static_assert(sizeof(Coordinate32) == 4);
+    static_assert(Coordinate32(7u) + Coordinate32(8u) == Coordinate32(15u));
+
+    EXPECT_NO_THROW(Coordinate32 coord(size_t(UINT32_MAX)));
+    EXPECT_RAISES(Coordinate32 coord(TOO_BIG), Exception);
+    EXPECT_RAISES(Coordinate32(1u) + TOO_BIG, Exception);
+
+    // Widening is implicit & unchecked, narrowing must be explicit.
+    Coordinate wide = Coordinate32(9u);
+    EXPECT_EQ(wide, 9);
+    EXPECT_EQ(Coordinate32(Coordinate(9)), 9u);
+    EXPECT_RAISES(Coordinate32(Coordinate(TOO_BIG)), Exception);
+}
+
+
+
+
+TEST(CoordinatePolicies, sixteen_bit_width)
+{
+    using Coordinate16          = BasicCoordinate<uint16_t, Checked>;
+    using UncheckedCoordinate16 = BasicCoordinate<uint16_t, Unchecked>;
+
+    static_assert(!noexcept(Coordinate16() + Coordinate16()));
+    static_assert(noexcept(UncheckedCoordinate16() * UncheckedCoordinate16()));
+
+    // Sums & products of narrow Coordinates are computed in `unsigned`, then range-checked.
+    EXPECT_EQ(Coordinate16(uint16_t(300)) * Coordinate16(uint16_t(200)), 60000u);
+    EXPECT_RAISES(Coordinate16(uint16_t(60000)) + Coordinate16(uint16_t(60000)), Exception);
+    EXPECT_RAISES(Coordinate16(uint16_t(65535)) * Coordinate16(uint16_t(65535)), Exception);
+    EXPECT_EQ(UncheckedCoordinate16(uint16_t(65535)) * UncheckedCoordinate16(uint16_t(65535)), 1u);
+}
+
+
+
+
+
+
+
+
+
+
+#ifndef TEXT_BUFFER_NO_EXCEPTIONS
+TEST(CoordinateErrors, report_is_built_lazily)
+{
+    try {
+        Coordinate(2) - Coordinate(5);
+        FAIL();
+    }
+    catch (const X_ &err) {
+        EXPECT_EQ(err.getId(), ERR_ID::INVALID_NUMBER_SIGN);
+        EXPECT_NE(err.getMessage().find("'2 - 5'"), std::string::npos);
+
+        const char *report = err.what();
+        EXPECT_NE(std::string(report).find("'2 - 5'"), std::string::npos);
+        EXPECT_EQ(err.what(), report);  // Cached after the first call
+    }
+
+    try {
+        throw generate_division_by_zero_exception("Divided 6 by 0.");
+    }
+    catch (const Exception &err) {
+        const std::string report = err.what();
+        EXPECT_NE(report.find("Divided 6 by 0."), std::string::npos);
+        EXPECT_NE(report.find("Division by zero is undefined"), std::string::npos);
+        EXPECT_EQ(err.getMessage(), "Divided 6 by 0.");
+        EXPECT_EQ(err.getCause(), default_cause(ERROR_ID::DIVISION_BY_ZERO));
+        EXPECT_EQ(err.getFix(), default_fix(ERROR_ID::DIVISION_BY_ZERO));
+    }
+
+    // An explicitly empty fix is reported as no fix at all.
+    try {
+        throw generate_negative_number_exception("Row -1.", "A negative row.", "");
+    }
+    catch (const Exception &err) {
+        EXPECT_EQ(err.getCause(), "A negative row.");
+        EXPECT_EQ(err.getFix(), "");
+        EXPECT_EQ(std::string(err.what()).find("SUGGESTED FIX"), std::string::npos);
+    }
+
+    // Deferred: the raw arguments are kept & formatted by the first what().
+    try {
+        throw generate_out_of_range_exception("Offset {} is past {}.", size_t(12), -3);
+    }
+    catch (const Exception &err) {
+        EXPECT_EQ(err.getMessage(), "Offset 12 is past -3.");
+        EXPECT_EQ(err.getFix(), default_fix(ERROR_ID::OUT_OF_RANGE));
+
+        const char *reports[4] = {};
+        std::vector<std::thread> readers;
+        for (const char *&report : reports) {
+            readers.emplace_back([&err, &report] { report = err.what(); });
+        }
+        for (std::thread &reader : readers) { reader.join(); }
+
+        for (const char *report : reports) { EXPECT_EQ(report, reports[0]); }
+        EXPECT_NE(std::string(reports[0]).find("Offset 12 is past -3."), std::string::npos);
+    }
+}
+#endif
+
+
+
+
+TEST(CoordinateErrors, text_arguments_are_copied)
+{
+    char oper[] = "-";
+    const X_ err(ERR_ID::INVALID_NUMBER_SIGN, "'{} {} {}'", 2, oper, 5);
+
+    oper[0] = '+';  // The error keeps its own copy of the text
+    EXPECT_EQ(err.getMessage(), "'2 - 5'");
+}
+
+
+
+
+
+
+
+
+
+
+#ifdef TEXT_BUFFER_NO_EXCEPTIONS
+TEST(CoordinateErrors, errors_reach_the_error_handler)
+{
+    set_error_handler([](int code, const std::exception &) {
+        std::fprintf(stderr, "handled error #%d", code);
+    });
+
+    EXPECT_DEATH(Coordinate(2) - Coordinate(5), "handled error #6");
+    EXPECT_DEATH(Coordinate32(1u) + (size_t(UINT32_MAX) + 1), "handled error #10");
+
+    set_error_handler(nullptr);
+}
+#endif
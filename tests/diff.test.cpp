@@ -0,0 +1,234 @@
+#include <text/buffer.hpp>
+#include <text/diff.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Text;
+using namespace std;
+
+
+// Replace each hunk's old range by its new text, last hunk first.
+static string apply(const Buffer &from, const Buffer &to, const vector<DiffHunk> &hunks)
+{
+    Buffer result{ string(from.text()) };
+
+    for (auto hunk = hunks.rbegin(); hunk != hunks.rend(); ++hunk) {
+        const size_t start = from.offsetOf(hunk->oldStart);
+        const size_t from0 = to.offsetOf(hunk->newStart);
+
+        result.replace(
+          start,
+          from.offsetOf(hunk->oldEnd) - start,
+          to.text().substr(from0, to.offsetOf(hunk->newEnd) - from0));
+    }
+    return string(result.text());
+}
+
+
+static vector<string> splitLines(string_view text)
+{
+    vector<string> lines;
+    while (!text.empty()) {
+        const size_t end = std::min(text.find('\n'), text.size() - 1) + 1;
+        lines.emplace_back(text.substr(0, end));
+        text.remove_prefix(end);
+    }
+    return lines;
+}
+
+
+// The fewest lines deleted & inserted, by the longest common subsequence.
+static size_t minimalEdits(string_view from, string_view to)
+{
+    const vector<string> a = splitLines(from), b = splitLines(to);
+    vector<size_t>       row(b.size() + 1), next(b.size() + 1);
+
+    for (size_t i = a.size(); i-- > 0;) {
+        for (size_t j = b.size(); j-- > 0;) {
+            next[j] = a[i] == b[j] ? row[j + 1] + 1 : std::max(row[j], next[j + 1]);
+        }
+        swap(row, next);
+    }
+    return a.size() + b.size() - 2 * row[0];
+}
+
+
+static size_t edits(const vector<DiffHunk> &hunks)
+{
+    size_t total = 0;
+    for (const DiffHunk &hunk : hunks) { total += hunk.oldLines + hunk.newLines; }
+    return total;
+}
+
+
+static string randomLines(mt19937 &random, size_t count, size_t distinct)
+{
+    string text;
+    for (size_t i = 0; i < count; ++i) { text += "line " + to_string(random() % distinct) + "\n"; }
+    return text;
+}
+
+
+static string mutate(mt19937 &random, const string &text, size_t changes)
+{
+    vector<string> lines = splitLines(text);
+
+    for (size_t i = 0; i < changes; ++i) {
+        const size_t at = lines.empty() ? 0 : random() % lines.size();
+        switch (random() % 3) {
+        case 0:
+            lines.insert(lines.begin() + ptrdiff_t(at), "new " + to_string(random()) + "\n");
+            break;
+        case 1:
+            if (!lines.empty()) { lines.erase(lines.begin() + ptrdiff_t(at)); }
+            break;
+        default:
+            if (!lines.empty()) { lines[at] = "changed " + to_string(random()) + "\n"; }
+        }
+    }
+
+    string out;
+    for (const string &line : lines) { out += line; }
+    return out;
+}
+
+
+
+
+
+
+
+
+
+
+TEST(DiffTestSuite, hunks_are_position_ranges)
+{
+    const Buffer from("a\nb\nc\nd\n");
+    const Buffer to("a\nB\nc\nd\ne\n");
+
+    const auto hunks = diff(from, to);
+    ASSERT_EQ(hunks.size(), 2);
+
+    EXPECT_EQ(hunks[0].oldStart, Position(2, 1));
+    EXPECT_EQ(hunks[0].oldEnd, Position(3, 1));
+    EXPECT_EQ(hunks[0].newStart, Position(2, 1));
+    EXPECT_EQ(hunks[0].newEnd, Position(3, 1));
+    EXPECT_EQ(hunks[0].oldLines, 1);
+    EXPECT_EQ(hunks[0].newLines, 1);
+
+    // Appended lines: an empty old range at the end of the old Buffer.
+    EXPECT_EQ(hunks[1].oldStart, Position(5, 1));
+    EXPECT_EQ(hunks[1].oldEnd, Position(5, 1));
+    EXPECT_EQ(hunks[1].newStart, Position(5, 1));
+    EXPECT_EQ(hunks[1].newEnd, Position(6, 1));
+    EXPECT_EQ(hunks[1].oldLines, 0);
+
+    EXPECT_TRUE(diff(from, from).empty());
+    EXPECT_TRUE(diff(Buffer(), Buffer()).empty());
+    EXPECT_EQ(apply(from, to, hunks), to.text());
+}
+
+
+
+
+TEST(DiffTestSuite, final_line_breaks_count)
+{
+    const Buffer broken("x\ny\n");
+    const Buffer unbroken("x\ny");
+
+    const auto hunks = diff(broken, unbroken);
+    ASSERT_EQ(hunks.size(), 1);
+    EXPECT_EQ(hunks[0].oldStart, Position(2, 1));
+    EXPECT_EQ(hunks[0].oldEnd, Position(3, 1));
+    EXPECT_EQ(hunks[0].newEnd, Position(2, 2));
+    EXPECT_EQ(apply(broken, unbroken, hunks), unbroken.text());
+    EXPECT_EQ(apply(unbroken, broken, diff(unbroken, broken)), broken.text());
+
+    EXPECT_EQ(apply(Buffer(), broken, diff(Buffer(), broken)), broken.text());
+    EXPECT_EQ(apply(broken, Buffer(), diff(broken, Buffer())), "");
+}
+
+
+
+
+TEST(DiffTestSuite, small_diffs_are_minimal)
+{
+    mt19937 random(7);
+
+    for (size_t round = 0; round < 300; ++round) {
+        const string old  = randomLines(random, random() % 40, 1 + random() % 8);
+        const string next = round % 2 ? mutate(random, old, random() % 6)
+                                      : randomLines(random, random() % 40, 1 + random() % 8);
+
+        const Buffer from(old), to(next);
+        const auto   hunks = diff(from, to);
+
+        ASSERT_EQ(apply(from, to, hunks), next) << "round " << round;
+        EXPECT_EQ(edits(hunks), minimalEdits(old, next)) << "round " << round;
+    }
+}
+
+
+
+
+TEST(DiffTestSuite, large_edit_distances_stay_minimal)
+{
+    mt19937 random(11);
+
+    // Far apart enough that the greedy trace overflows & the linear-space search takes over.
+    const string old  = randomLines(random, 6000, 4);
+    const string next = randomLines(random, 6000, 4);
+    const Buffer from(old), to(next);
+
+    const auto hunks = diff(from, to, 1);
+    EXPECT_EQ(apply(from, to, hunks), next);
+    EXPECT_EQ(edits(hunks), minimalEdits(old, next));
+}
+
+
+
+
+TEST(DiffTestSuite, parallel_regions_match_one_thread)
+{
+    mt19937 random(3);
+
+    string old;
+    for (size_t i = 0; i < 60000; ++i) { old += "row " + to_string(i % 7 ? i : 0) + "\n"; }
+    const string next = mutate(random, old, 500);
+    const Buffer from(old), to(next);
+
+    const auto single = diff(from, to, 1);
+    const auto shared = diff(from, to, 4);
+
+    EXPECT_EQ(apply(from, to, single), next);
+    ASSERT_EQ(single.size(), shared.size());
+    for (size_t i = 0; i < single.size(); ++i) {
+        EXPECT_EQ(single[i].oldStart, shared[i].oldStart);
+        EXPECT_EQ(single[i].newEnd, shared[i].newEnd);
+    }
+    EXPECT_LE(edits(single), 2 * 500);
+}
+
+
+
+
+TEST(DiffTestSuite, disjoint_texts_stay_valid)
+{
+    // No line in common: the middle-snake search runs out of budget & cuts where it got furthest.
+    string old, next;
+    for (size_t i = 0; i < 30000; ++i) {
+        old += "a " + to_string(i) + "\n";
+        next += "b " + to_string(i) + "\n";
+    }
+    const Buffer from(old), to(next);
+
+    const auto hunks = diff(from, to, 1);
+    EXPECT_EQ(apply(from, to, hunks), next);
+    EXPECT_EQ(edits(hunks), 2 * 30000);
+}
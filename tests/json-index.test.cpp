@@ -0,0 +1,232 @@
+#include <text/buffer.hpp>
+#include <text/json-index.hpp>
+
+#include <gtest/gtest.h>
+#include "raises.hpp"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utils/exception.hpp>
+#include <vector>
+
+using namespace Text;
+using namespace std;
+
+
+/**************************************************************
+ * The tape a byte-at-a-time scanner produces. Like the indexer,
+ * it lets a backslash escape the next byte outside strings too;
+ * such documents are invalid either way.
+ **************************************************************/
+static vector<uint32_t> reference_tape(string_view text)
+{
+    vector<uint32_t> tape;
+    bool             inString = false;
+    bool             inScalar = false;
+    bool             escape   = false;
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char c       = text[i];
+        const bool escaped = escape;
+        escape             = !escaped && c == '\\';
+
+        if (inString) {
+            inString = !(c == '"' && !escaped);
+        }
+        else if (c == '"' && !escaped) {
+            tape.push_back(uint32_t(i));
+            inString = true;
+            inScalar = false;
+        }
+        else if (strchr("{}[]:,", c) != nullptr) {
+            tape.push_back(uint32_t(i));
+            inScalar = false;
+        }
+        else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            inScalar = false;
+        }
+        else if (!inScalar) {
+            tape.push_back(uint32_t(i));
+            inScalar = true;
+        }
+    }
+    return tape;
+}
+
+
+static vector<uint32_t> tape_of(const JsonIndex &index)
+{
+    return vector<uint32_t>(index.offsets().begin(), index.offsets().end());
+}
+
+
+
+
+
+
+
+
+
+
+TEST(JsonIndexTestSuite, tape_of_a_document)
+{
+    const Buffer    buffer(R"({"a": [1, true, "x\"]y"], "b":-2.5e3})");
+    const JsonIndex index(buffer);
+
+    EXPECT_TRUE(index.ok());
+    EXPECT_EQ(index.error(), JsonError::NONE);
+    EXPECT_EQ(
+      tape_of(index), (vector<uint32_t>{ 0, 1, 4, 6, 7, 8, 10, 14, 16, 23, 24, 26, 29, 30, 36 }));
+}
+
+
+
+
+TEST(JsonIndexTestSuite, matches_a_byte_scanner)
+{
+    // Backslash runs & strings crossing 64-byte blocks are the interesting cases.
+    const string_view alphabet = "\"\\\\\\{}[]:, \na1";
+    mt19937           rng(7);
+
+    for (size_t round = 0; round < 3000; ++round) {
+        string text(rng() % 300, ' ');
+        for (char &c : text) { c = alphabet[rng() % alphabet.size()]; }
+
+        const Buffer    buffer(text);
+        const JsonIndex index(buffer);
+        ASSERT_EQ(tape_of(index), reference_tape(text)) << text;
+    }
+}
+
+
+
+
+TEST(JsonIndexTestSuite, valid_documents)
+{
+    const vector<string> documents = {
+        "0",
+        " -0.5 ",
+        "1e10",
+        "1E+2",
+        "-12.25e-3",
+        "true",
+        "null",
+        R"("")",
+        R"("\\\"\/\b\f\n\r\té")",
+        "[]",
+        "{}",
+        "[[], {}, [{}]]",
+        "{\"k\": {\"nested\": [1, 2, {\"x\": false}]}}",
+        "\n\t{ \"a\" :\r\n1 }\n",
+        "\"caf\xC3\xA9\"",
+        string(100, '[') + string(100, ']'),
+    };
+
+    for (const string &document : documents) {
+        const Buffer    buffer(document);
+        const JsonIndex index(buffer);
+        EXPECT_TRUE(index.ok()) << document << ": " << jsonErrorName(index.error());
+    }
+}
+
+
+
+
+TEST(JsonIndexTestSuite, syntax_errors)
+{
+    struct Case
+    {
+        string    document;
+        JsonError error;
+        size_t    offset;
+    };
+
+    const vector<Case> cases = {
+        { "", JsonError::EMPTY_DOCUMENT, 0 },
+        { "  \n", JsonError::EMPTY_DOCUMENT, 3 },
+        { "[1, 2", JsonError::UNEXPECTED_END, 5 },
+        { "{\"a\" 1}", JsonError::UNEXPECTED_CHARACTER, 5 },
+        { "{\"a\": 1,}", JsonError::UNEXPECTED_CHARACTER, 8 },
+        { "[1,, 2]", JsonError::UNEXPECTED_CHARACTER, 3 },
+        { "[1}", JsonError::UNEXPECTED_CHARACTER, 2 },
+        { "{a: 1}", JsonError::UNEXPECTED_CHARACTER, 1 },
+        { "[1 2]", JsonError::UNEXPECTED_CHARACTER, 3 },
+        { "[] []", JsonError::TRAILING_CONTENT, 3 },
+        { "[tru]", JsonError::INVALID_LITERAL, 1 },
+        { "[nulls]", JsonError::INVALID_LITERAL, 1 },
+        { "[01]", JsonError::INVALID_NUMBER, 1 },
+        { "[1.]", JsonError::INVALID_NUMBER, 1 },
+        { "[-]", JsonError::INVALID_NUMBER, 1 },
+        { "[1e+]", JsonError::INVALID_NUMBER, 1 },
+        { R"(["a\qb"])", JsonError::INVALID_ESCAPE, 3 },
+        { R"(["\u12G4"])", JsonError::INVALID_ESCAPE, 2 },
+        { "[\"a\tb\"]", JsonError::CONTROL_CHARACTER, 3 },
+        { "[\"abc", JsonError::UNTERMINATED_STRING, 1 },
+        { R"(["abc\"])", JsonError::UNTERMINATED_STRING, 1 },
+        { "[\"a\nb\", x]", JsonError::CONTROL_CHARACTER, 3 },  // The earliest error wins
+        { "[x, \"a\nb\"]", JsonError::INVALID_LITERAL, 1 },
+    };
+
+    for (const Case &test : cases) {
+        const Buffer    buffer(test.document);
+        const JsonIndex index(buffer);
+
+        EXPECT_FALSE(index.ok()) << test.document;
+        EXPECT_EQ(jsonErrorName(index.error()), jsonErrorName(test.error)) << test.document;
+        EXPECT_EQ(index.errorOffset(), test.offset) << test.document;
+    }
+}
+
+
+
+
+TEST(JsonIndexTestSuite, positions_resolve_lazily)
+{
+    string document = "{\n  \"rows\": [\n";
+    for (size_t i = 0; i < 200; ++i) { document += "    {\"id\": " + to_string(i) + "},\n"; }
+    document += "    {\"id\": 200 }\n  ]\n}\n";
+
+    const Buffer    buffer(document);
+    const JsonIndex index(buffer);
+    ASSERT_TRUE(index.ok());
+
+    vector<Position> all(index.size());
+    index.positions(0, all);
+
+    for (size_t i = 0; i < index.size(); ++i) {
+        const Position expected = buffer.positionOf(size_t(index.offsets()[i]));
+        ASSERT_EQ(index.position(i), expected);
+        ASSERT_EQ(all[i], expected);
+    }
+
+    EXPECT_EQ(index.position(0), Position(1, 1));
+    EXPECT_EQ(index.position(1), Position(2, 3));
+    EXPECT_EQ(index.position(index.size() - 1), Position(205, 1));
+
+    vector<Position> some(3);
+    index.positions(index.size() - 3, some);
+    EXPECT_EQ(some.back(), Position(205, 1));
+
+    EXPECT_RAISES(index.position(index.size()), Text_Buffer::Exception);
+    EXPECT_RAISES(index.positions(index.size() - 2, some), Text_Buffer::Exception);
+    EXPECT_RAISES(index.errorPosition(), Text_Buffer::Exception);
+}
+
+
+
+
+TEST(JsonIndexTestSuite, error_positions)
+{
+    string document = "[\n";
+    for (size_t i = 0; i < 50; ++i) { document += "  \"line " + to_string(i) + "\",\n"; }
+    document += "  \"a\": 1\n]\n";
+
+    const Buffer    buffer(document);
+    const JsonIndex index(buffer);
+
+    EXPECT_EQ(index.error(), JsonError::UNEXPECTED_CHARACTER);
+    EXPECT_EQ(index.errorPosition(), Position(52, 6));
+    EXPECT_EQ(index.errorPosition(), buffer.positionOf(index.errorOffset()));
+}
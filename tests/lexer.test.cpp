@@ -0,0 +1,231 @@
+#include <text/buffer.hpp>
+#include <text/lexer.hpp>
+
+#include <gtest/gtest.h>
+#include "raises.hpp"
+
+#include <string>
+#include <string_view>
+#include <utils/exception.hpp>
+#include <vector>
+
+using namespace Text;
+using namespace std;
+
+
+enum Kind : TokenKind { UNKNOWN, IDENT, NUMBER, SPACE, STRING, COMMENT, OP };
+
+
+static Lexicon script_lexicon()
+{
+    const CharSet alpha = CharSet::range('a', 'z') | CharSet::range('A', 'Z') | CharSet::of("_");
+    const CharSet digit = CharSet::range('0', '9');
+
+    Lexicon lexicon(UNKNOWN);
+    lexicon.run(IDENT, alpha | CharSet::utf8(), alpha | digit | CharSet::utf8())
+      .run(NUMBER, digit, digit | CharSet::of("."))
+      .run(SPACE, CharSet::of(" \t\r\n"), CharSet::of(" \t\r\n"))
+      .quoted(STRING, '"')
+      .lineComment(COMMENT, "//")
+      .blockComment(COMMENT, "/*", "*/")
+      .literal(OP, "=")
+      .literal(OP, "==")
+      .literal(OP, "/")
+      .literal(OP, ";")
+      .skip(SPACE);
+    return lexicon;
+}
+
+
+static vector<Token> lex(string_view text, const Lexicon &lexicon)
+{
+    vector<Token> tokens;
+    for (const Token &token : Lexer(text, lexicon)) { tokens.push_back(token); }
+    return tokens;
+}
+
+
+
+
+
+
+
+
+
+
+TEST(LexerTestSuite, tokens_and_positions)
+{
+    const Lexicon lexicon = script_lexicon();
+    const auto    tokens  = lex("let x = 42;\n  y == x\n", lexicon);
+
+    ASSERT_EQ(tokens.size(), 8);
+
+    EXPECT_EQ(tokens[0].kind, IDENT);
+    EXPECT_EQ(tokens[0].text, "let");
+    EXPECT_EQ(tokens[0].start, Position(1, 1));
+    EXPECT_EQ(tokens[0].end, Position(1, 4));
+
+    EXPECT_EQ(tokens[3].kind, NUMBER);
+    EXPECT_EQ(tokens[3].text, "42");
+    EXPECT_EQ(tokens[3].offset, 8);
+    EXPECT_EQ(tokens[3].start, Position(1, 9));
+
+    EXPECT_EQ(tokens[4].text, ";");
+    EXPECT_EQ(tokens[4].end, Position(1, 12));
+
+    EXPECT_EQ(tokens[5].text, "y");
+    EXPECT_EQ(tokens[5].start, Position(2, 3));
+
+    EXPECT_EQ(tokens[6].kind, OP);  // Longest match wins over "="
+    EXPECT_EQ(tokens[6].text, "==");
+    EXPECT_EQ(tokens[6].start, Position(2, 5));
+    EXPECT_EQ(tokens[7].start, Position(2, 8));
+}
+
+
+
+
+TEST(LexerTestSuite, tokens_view_the_source)
+{
+    const Lexicon lexicon = script_lexicon();
+    const Buffer  buffer("alpha beta\ngamma");
+    Lexer         lexer(buffer, lexicon);
+    Token         token;
+
+    ASSERT_TRUE(lexer.next(token));
+    EXPECT_EQ(token.text.data(), buffer.text().data());
+
+    ASSERT_TRUE(lexer.next(token));
+    ASSERT_TRUE(lexer.next(token));
+    EXPECT_EQ(token.text.data(), buffer.text().data() + 11);
+    EXPECT_EQ(token.start, buffer.positionOf(size_t(11)));
+    EXPECT_EQ(token.end, buffer.positionOf(buffer.size()));
+
+    EXPECT_FALSE(lexer.next(token));
+    EXPECT_EQ(token.text, "gamma");  // Left unchanged
+    EXPECT_EQ(lexer.offset(), buffer.size());
+}
+
+
+
+
+TEST(LexerTestSuite, quoted_tokens)
+{
+    const Lexicon lexicon = script_lexicon();
+
+    auto tokens = lex(R"(s = "a \" b";)", lexicon);
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[2].kind, STRING);
+    EXPECT_EQ(tokens[2].text, R"("a \" b")");
+
+    // An unterminated string stops before the line break.
+    tokens = lex("\"open\nnext", lexicon);
+    ASSERT_EQ(tokens.size(), 2);
+    EXPECT_EQ(tokens[0].text, "\"open");
+    EXPECT_EQ(tokens[1].text, "next");
+    EXPECT_EQ(tokens[1].start, Position(2, 1));
+
+    tokens = lex("\"a\\\nb", lexicon);  // An escaped line break still ends the line
+    ASSERT_EQ(tokens.size(), 2);
+    EXPECT_EQ(tokens[0].text, "\"a\\");
+    EXPECT_EQ(tokens[1].start, Position(2, 1));
+
+    Lexicon multiline(UNKNOWN);
+    multiline.quoted(STRING, '`', 0, true);
+
+    tokens = lex("`a\\\nb`c", multiline);
+    ASSERT_EQ(tokens.size(), 2);
+    EXPECT_EQ(tokens[0].text, "`a\\\nb`");  // No escape byte, so the backslash is text
+    EXPECT_EQ(tokens[0].end, Position(2, 3));
+    EXPECT_EQ(tokens[1].kind, UNKNOWN);
+}
+
+
+
+
+TEST(LexerTestSuite, comments)
+{
+    const Lexicon lexicon = script_lexicon();
+    const auto    tokens  = lex("a // note\n/* one\n two */ b / c /* open", lexicon);
+
+    ASSERT_EQ(tokens.size(), 7);
+    EXPECT_EQ(tokens[1].kind, COMMENT);
+    EXPECT_EQ(tokens[1].text, "// note");
+    EXPECT_EQ(tokens[1].end, Position(1, 10));
+
+    EXPECT_EQ(tokens[2].text, "/* one\n two */");
+    EXPECT_EQ(tokens[2].start, Position(2, 1));
+    EXPECT_EQ(tokens[2].end, Position(3, 8));
+
+    EXPECT_EQ(tokens[3].start, Position(3, 9));
+    EXPECT_EQ(tokens[4].kind, OP);
+    EXPECT_EQ(tokens[6].text, "/* open");  // Runs to the end of the text
+}
+
+
+
+
+TEST(LexerTestSuite, skipped_and_unknown_bytes)
+{
+    Lexicon lexicon = script_lexicon();
+    lexicon.skip(COMMENT);
+
+    const auto tokens = lex("a @ /* x */ #\n", lexicon);
+
+    ASSERT_EQ(tokens.size(), 3);
+    EXPECT_EQ(tokens[1].kind, UNKNOWN);
+    EXPECT_EQ(tokens[1].text, "@");
+    EXPECT_EQ(tokens[2].text, "#");
+    EXPECT_EQ(tokens[2].start, Position(1, 13));
+
+    EXPECT_TRUE(lex("", lexicon).empty());
+    EXPECT_TRUE(lex(" \n\n /* */ ", lexicon).empty());
+}
+
+
+
+
+TEST(LexerTestSuite, utf8_columns_are_bytes)
+{
+    const Lexicon lexicon = script_lexicon();
+    const auto    tokens  = lex("caf\xC3\xA9 na\xC3\xAFve\n\xE4\xBD\xA0", lexicon);
+
+    ASSERT_EQ(tokens.size(), 3);
+    EXPECT_EQ(tokens[0].text, "caf\xC3\xA9");
+    EXPECT_EQ(tokens[1].start, Position(1, 7));
+    EXPECT_EQ(tokens[1].end, Position(1, 13));
+    EXPECT_EQ(tokens[2].end, Position(2, 4));
+}
+
+
+
+
+TEST(LexerTestSuite, resume_mid_text)
+{
+    const Lexicon lexicon = script_lexicon();
+    const string  text    = "a b\nc d\ne";
+    Lexer         lexer(text, lexicon, 6, Position(2, 3));
+    Token         token;
+
+    EXPECT_EQ(lexer.position(), Position(2, 3));
+    ASSERT_TRUE(lexer.next(token));
+    EXPECT_EQ(token.text, "d");
+    EXPECT_EQ(token.start, Position(2, 3));
+    ASSERT_TRUE(lexer.next(token));
+    EXPECT_EQ(token.start, Position(3, 1));
+
+    EXPECT_RAISES(Lexer(text, lexicon, 20, Position(1, 1)), Text_Buffer::Exception);
+    EXPECT_RAISES(Lexer(text, lexicon, 2, Position(1, 4)), Text_Buffer::Exception);
+}
+
+
+
+
+TEST(LexerTestSuite, invalid_rules)
+{
+    Lexicon lexicon(UNKNOWN);
+
+    EXPECT_RAISES(lexicon.literal(OP, ""), Text_Buffer::Exception);
+    EXPECT_RAISES(lexicon.lineComment(COMMENT, ""), Text_Buffer::Exception);
+    EXPECT_RAISES(lexicon.blockComment(COMMENT, "/*", ""), Text_Buffer::Exception);
+}
@@ -0,0 +1,139 @@
+#include <text/buffer.hpp>
+#include <text/line-view.hpp>
+
+#include <gtest/gtest.h>
+#include "raises.hpp"
+
+#include <array>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utils/exception.hpp>
+#include <vector>
+
+using namespace Text;
+using namespace std;
+
+
+static_assert(ranges::random_access_range<LineView>);
+static_assert(ranges::sized_range<LineView>);
+static_assert(ranges::view<LineView>);
+static_assert(ranges::borrowed_range<LineView>);
+
+
+static string numbered(size_t rows)
+{
+    string text;
+    for (size_t i = 1; i <= rows; ++i) { text += "line " + to_string(i) + (i % 3 ? "\n" : "\r\n"); }
+    return text;
+}
+
+
+
+
+
+
+
+
+
+
+TEST(LineViewTestSuite, rows_match_buffer_lines)
+{
+    const Buffer buffer("alpha\r\nbeta\n\ngamma");
+    const auto   lines = buffer.lines();
+
+    ASSERT_EQ(lines.size(), 4);
+
+    size_t row = 1;
+    for (const BufferLine line : lines) {
+        EXPECT_EQ(line.row.get(), row);
+        EXPECT_EQ(line.text, buffer.line(row));
+        ++row;
+    }
+
+    EXPECT_EQ(lines[0].text, "alpha");
+    EXPECT_EQ(lines[2].text, "");
+    EXPECT_EQ((*(lines.end() - 1)).text, "gamma");
+    EXPECT_EQ(lines.bytes(), buffer.size());
+
+    // A trailing line break leaves an empty last row, as lineCount() counts it.
+    EXPECT_EQ(Buffer("a\n").lines().back().text, "");
+    EXPECT_EQ(Buffer().lines().size(), 1);
+}
+
+
+
+
+TEST(LineViewTestSuite, composes_with_standard_views)
+{
+    const Buffer buffer(numbered(20));
+
+    const auto tens = [](const BufferLine &line) { return line.text.ends_with('0'); };
+
+    vector<size_t> rows;
+    for (const BufferLine line : buffer.lines() | views::filter(tens) | views::take(2)) {
+        rows.push_back(line.row.get());
+    }
+    EXPECT_EQ(rows, (vector<size_t>{ 10, 20 }));
+
+    const auto reversed = buffer.lines(3, 5) | views::reverse;
+    EXPECT_EQ((*reversed.begin()).text, "line 5");
+    EXPECT_EQ(ranges::distance(reversed), 3);
+
+    EXPECT_RAISES(buffer.lines(0, 2), Text_Buffer::Exception);
+    EXPECT_RAISES(buffer.lines(4, 3), Text_Buffer::Exception);
+    EXPECT_RAISES(buffer.lines(1, 22), Text_Buffer::Exception);
+}
+
+
+
+
+TEST(LineViewTestSuite, partitions_cover_every_row_once)
+{
+    const Buffer buffer(numbered(1000));
+    const auto   lines = buffer.lines(2, 1000);
+
+    for (const size_t parts : { 1, 3, 8, 2000 }) {
+        vector<LineView> views(parts);
+        lines.partition(views);
+
+        size_t next = 2, bytes = 0;
+        for (const LineView &view : views) {
+            for (const BufferLine line : view) { EXPECT_EQ(line.row.get(), next++); }
+            bytes += view.bytes();
+        }
+        EXPECT_EQ(next, 1001);
+        EXPECT_EQ(bytes, lines.bytes());
+
+        // Parts are balanced by bytes, to within one row.
+        if (parts == 8) {
+            for (const LineView &view : views) { EXPECT_NEAR(view.bytes(), lines.bytes() / 8, 16); }
+        }
+    }
+}
+
+
+
+
+TEST(LineViewTestSuite, partitions_can_be_walked_in_parallel)
+{
+    const Buffer buffer(numbered(5000));
+
+    array<LineView, 4> views;
+    array<size_t, 4>   sums{};
+    buffer.lines().partition(views);
+
+    vector<thread> workers;
+    for (size_t i = 0; i < views.size(); ++i) {
+        workers.emplace_back([&, i] {
+            for (const BufferLine line : views[i]) { sums[i] += line.text.size(); }
+        });
+    }
+    for (thread &worker : workers) { worker.join(); }
+
+    size_t expected = 0;
+    for (const BufferLine line : buffer.lines()) { expected += line.text.size(); }
+    EXPECT_EQ(sums[0] + sums[1] + sums[2] + sums[3], expected);
+}
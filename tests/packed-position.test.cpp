@@ -0,0 +1,64 @@
+#include <text/packed-position.hpp>
+
+#include <gtest/gtest.h>
+#include "raises.hpp"
+
+#include <algorithm>
+#include <utils/exception.hpp>
+#include <vector>
+
+using namespace Text;
+using namespace std;
+
+
+
+
+
+
+
+
+
+
+TEST(PackedPositionTestSuite, round_trip)
+{
+    EXPECT_TRUE(PackedPosition().toPosition() == Position(1, 1));
+    EXPECT_TRUE(PackedPosition(Position(7, 3)).toPosition() == Position(7, 3));
+
+    const PackedPosition max(UINT32_MAX, UINT32_MAX);
+    EXPECT_TRUE(PackedPosition(max.toPosition()) == max);
+    EXPECT_TRUE(PackedPosition::fromBits(max.toBits()) == max);
+
+    EXPECT_EQ(PackedPosition(9, 4).getRow(), 9);
+    EXPECT_EQ(PackedPosition(9, 4).getCol(), 4);
+
+    EXPECT_RAISES(PackedPosition(Position(size_t(UINT32_MAX) + 1, 1)), Exception);
+}
+
+
+
+
+
+
+
+
+
+
+TEST(PackedPositionTestSuite, ordering_matches_position)
+{
+    static_assert(PackedPosition(1, 900) < PackedPosition(2, 1));
+    static_assert(PackedPosition(2, 1) < PackedPosition(2, 2));
+
+    vector<Position> positions{ { 3, 1 }, { 1, 9 }, { 2, 4 }, { 1, 2 }, { 3, 0 } };
+    vector<PackedPosition> packed;
+
+    for (const Position &pos : positions) { packed.emplace_back(pos); }
+
+    sort(positions.begin(), positions.end());
+    sort(packed.begin(), packed.end());
+
+    for (size_t i = 0; i < positions.size(); ++i) {
+        EXPECT_TRUE(packed[i].toPosition() == positions[i]);
+    }
+
+    EXPECT_TRUE(binary_search(packed.begin(), packed.end(), PackedPosition(2, 4)));
+}
@@ -0,0 +1,179 @@
+#include <text/position-array.hpp>
+
+#include <gtest/gtest.h>
+#include "raises.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <utils/err.hpp>
+#include <utils/exception.hpp>
+#include <vector>
+
+using namespace Text;
+using namespace std;
+
+
+
+
+
+
+
+
+
+
+TEST(PositionArrayTestSuite, proxies_behave_like_positions)
+{
+    PositionArray<> arr;
+    arr.push_back(Position(3, 4));
+    arr.push_back(5, 6);
+
+    EXPECT_EQ(arr.size(), 2);
+    EXPECT_EQ(arr[0].getRow(), 3);
+    EXPECT_EQ(arr[0].getCol(), 4);
+
+    arr[1] = Position(8, 9);
+    Position pos = arr[1];
+    EXPECT_TRUE(pos == Position(8, 9));
+    EXPECT_TRUE(arr[1] == Position(8, 9));
+
+    size_t rows = 0;
+    for (auto ref : arr) { rows += ref.getRow().get(); }
+    EXPECT_EQ(rows, 11);
+
+    EXPECT_RAISES(arr.at(2), Text_Buffer::Exception);
+}
+
+
+
+
+TEST(PositionArrayTestSuite, const_arrays_iterate_positions)
+{
+    static_assert(std::ranges::random_access_range<const PositionArray<>>);
+
+    PositionArray<> arr;
+    arr.push_back(1, 2);
+    arr.push_back(3, 4);
+    arr.push_back(3, 9);
+
+    const PositionArray<> &view = arr;
+
+    size_t cols = 0;
+    for (const Position &pos : view) { cols += pos.getCol().get(); }
+    EXPECT_EQ(cols, 15);
+
+    EXPECT_TRUE(std::ranges::is_sorted(view));
+    EXPECT_EQ(std::ranges::find(view, Position(3, 4)) - view.begin(), 1);
+    EXPECT_EQ(std::ranges::lower_bound(view, Position(3, 5)) - view.cbegin(), 2);
+    EXPECT_TRUE(view.cend()[-1] == Position(3, 9));
+}
+
+
+
+
+TEST(PositionArrayTestSuite, std_sort_swaps_through_proxies)
+{
+    mt19937            rng(5);
+    PositionArray<>    arr;
+    vector<Position>   ref;
+
+    for (int i = 0; i < 1000; ++i) {
+        const size_t row = 1 + rng() % 50, col = 1 + rng() % 50;
+        arr.push_back(row, col);
+        ref.push_back(Position(row, col));
+    }
+
+    std::sort(arr.begin(), arr.end());
+    std::sort(ref.begin(), ref.end());
+    ASSERT_TRUE(arr.isSorted());
+    for (size_t i = 0; i < ref.size(); ++i) { ASSERT_TRUE(arr[i] == ref[i]); }
+
+    std::reverse(arr.begin(), arr.end());
+    EXPECT_TRUE(arr[0] == ref.back());
+    EXPECT_TRUE(arr[999] == ref.front());
+
+    swap(arr[0], arr[999]);
+    EXPECT_TRUE(arr[0] == ref.front());
+    EXPECT_TRUE(arr[999] == ref.back());
+}
+
+
+
+
+TEST(PositionArrayTestSuite, radix_sort_and_search)
+{
+    mt19937                  rng(7);
+    PositionArray32          arr;
+    vector<Position32>       ref;
+
+    for (int i = 0; i < 5000; ++i) {
+        const uint32_t row = 1 + rng() % 400;
+        const uint32_t col = 1 + ((i % 3) ? rng() % 80 : rng());
+        arr.push_back(row, col);
+        ref.push_back(Position32::unchecked(row, col));
+    }
+
+    arr.sort();
+    std::sort(ref.begin(), ref.end());
+    ASSERT_TRUE(arr.isSorted());
+    for (size_t i = 0; i < ref.size(); ++i) { ASSERT_TRUE(arr[i] == ref[i]); }
+
+    for (int i = 0; i < 500; ++i) {
+        const auto key = Position32::unchecked(1 + rng() % 402, 1 + rng() % 90);
+        const auto lo  = size_t(std::lower_bound(ref.begin(), ref.end(), key) - ref.begin());
+        const auto hi  = size_t(std::upper_bound(ref.begin(), ref.end(), key) - ref.begin());
+        ASSERT_EQ(arr.lowerBound(key), lo);
+        ASSERT_EQ(arr.upperBound(key), hi);
+    }
+
+    const auto [first, last] = arr.rowRange(10, 12);
+    for (size_t i = 0; i < arr.size(); ++i) {
+        const bool inside = arr.rows()[i] >= 10 && arr.rows()[i] <= 12;
+        EXPECT_EQ(inside, i >= first && i < last);
+    }
+
+    const auto [from, to] = arr.range(Position32(5, 10), Position32(5, 40));
+    for (size_t i = from; i < to; ++i) {
+        EXPECT_EQ(arr.rows()[i], 5);
+        EXPECT_TRUE(arr.cols()[i] >= 10 && arr.cols()[i] <= 40);
+    }
+}
+
+
+
+
+TEST(PositionArrayTestSuite, bulk_shifts)
+{
+    PositionArray<> arr;
+    arr.push_back(1, 5);
+    arr.push_back(2, 3);
+    arr.push_back(2, 9);
+    arr.push_back(4, 1);
+
+    arr.shiftRows(2, 3);
+    EXPECT_TRUE(arr[0] == Position(1, 5));
+    EXPECT_TRUE(arr[1] == Position(5, 3));
+    EXPECT_TRUE(arr[3] == Position(7, 1));
+
+    arr.shiftCols(5, 4, -2);
+    EXPECT_TRUE(arr[1] == Position(5, 3));
+    EXPECT_TRUE(arr[2] == Position(5, 7));
+    EXPECT_TRUE(arr.isSorted());
+
+    arr.shiftRows(5, -3);
+    EXPECT_TRUE(arr[3] == Position(4, 1));
+
+    // Failed shifts report the Coordinate's sign error & change nothing.
+    EXPECT_RAISES(arr.shiftRows(1, -2), Text_Buffer::X_);
+    EXPECT_RAISES(arr.shiftCols(1, 4, -6), Text_Buffer::X_);
+    EXPECT_TRUE(arr[0] == Position(1, 5));
+
+    // Only elements at or past the threshold move, so nothing can underflow here.
+    arr.shiftCols(1, 6, -6);
+    arr.shiftRows(8, std::numeric_limits<PositionArray<>::signed_type>::min());
+    EXPECT_TRUE(arr[0] == Position(1, 5));
+
+    PositionArray<> empty;
+    empty.shiftRows(1, -5);
+    EXPECT_TRUE(empty.empty());
+}
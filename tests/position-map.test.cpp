@@ -0,0 +1,176 @@
+#include <text/position-map.hpp>
+
+#include <gtest/gtest.h>
+#include "raises.hpp"
+
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utils/exception.hpp>
+
+using namespace Text;
+using namespace std;
+
+
+
+
+
+
+
+
+
+
+TEST(PositionMapTestSuite, std_hash_specialisations)
+{
+    unordered_map<Position, int>       byPosition;
+    unordered_map<Coordinate, int>     byCoordinate;
+    unordered_set<PackedPosition>      packed;
+    unordered_set<size_t>              hashes;
+
+    byPosition[Position(3, 4)] = 7;
+    byCoordinate[Coordinate(9)] = 2;
+    packed.insert(PackedPosition(1, 2));
+
+    EXPECT_EQ(byPosition.at(Position(3, 4)), 7);
+    EXPECT_EQ(byCoordinate.at(Coordinate(9)), 2);
+    EXPECT_TRUE(packed.contains(PackedPosition(1, 2)));
+
+    // A grid of nearby positions should not collide.
+    for (size_t row = 1; row <= 100; ++row) {
+        for (size_t col = 1; col <= 100; ++col) {
+            hashes.insert(hash<Position>()(Position(row, col)));
+        }
+    }
+    EXPECT_EQ(hashes.size(), 10000);
+    EXPECT_EQ(hash<Position>()(Position(5, 6)), hash<Position32>()(Position32(5, 6)));
+}
+
+
+
+
+TEST(PositionMapTestSuite, matches_a_reference_map)
+{
+    mt19937                             rng(11);
+    PositionMap<string>                 map;
+    std::map<pair<uint32_t, uint32_t>, string> reference;
+
+    for (int i = 0; i < 20000; ++i) {
+        const uint32_t row = 1 + rng() % 64;
+        const uint32_t col = 1 + rng() % 64;
+        const auto     key = PackedPosition(row, col);
+
+        switch (rng() % 3) {
+            case 0 :
+                EXPECT_EQ(map.insert(key, to_string(i)), !reference.contains({ row, col }));
+                reference.try_emplace({ row, col }, to_string(i));
+                break;
+            case 1 :
+                EXPECT_EQ(map.erase(key), reference.erase({ row, col }) == 1);
+                break;
+            default :
+                map[key] += "x";
+                reference[{ row, col }] += "x";
+        }
+
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    for (const auto &[key, value] : reference) {
+        const string *found = map.find(Position(key.first, key.second));
+        ASSERT_NE(found, nullptr);
+        EXPECT_EQ(*found, value);
+    }
+
+    size_t visited = 0;
+    map.forEach([&](PackedPosition, string &) { ++visited; });
+    EXPECT_EQ(visited, reference.size());
+
+    PositionMap<string> copy = map;
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(copy.size(), reference.size());
+}
+
+
+
+
+TEST(PositionMapTestSuite, key_range)
+{
+    PositionMap<int> map;
+
+    EXPECT_FALSE(map.contains(Position(size_t(1) << 40, 1)));
+    EXPECT_RAISES(map[Position(size_t(1) << 40, 1)], Text_Buffer::Exception);
+    EXPECT_RAISES(map.insert(PackedPosition(UINT32_MAX, UINT32_MAX), 1), Text_Buffer::Exception);
+    EXPECT_TRUE(map.insert(PackedPosition(UINT32_MAX, 1), 1));
+
+    // No slot count can hold these; the doubling search must not wrap to 0.
+    EXPECT_RAISES(map.reserve(SIZE_MAX), Text_Buffer::Exception);
+    EXPECT_RAISES(map.reserve(SIZE_MAX / 2 + 1), Text_Buffer::Exception);
+    EXPECT_EQ(map.size(), 1);
+}
+
+
+
+
+#ifndef TEXT_BUFFER_NO_EXCEPTIONS
+namespace {
+    /// Counts live instances & throws from its constructors on demand.
+    struct Fragile
+    {
+        static inline int live      = 0;
+        static inline int failAfter = -1;   /// Constructions left before one throws
+
+        int value = 0;
+
+        static void tick()
+        {
+            if (failAfter >= 0 && failAfter-- == 0) { throw runtime_error("Fragile"); }
+        }
+
+        Fragile() { tick(); ++live; }
+        Fragile(int v) : value(v) { ++live; }
+        Fragile(const Fragile &other) : value(other.value) { tick(); ++live; }
+        Fragile(Fragile &&other) : value(other.value) { tick(); ++live; }
+        ~Fragile() { --live; }
+    };
+}
+
+
+TEST(PositionMapTestSuite, throwing_values)
+{
+    {
+        PositionMap<Fragile> map;
+        for (uint32_t i = 1; i <= 8; ++i) { map.insert(PackedPosition(i, 1), Fragile(int(i))); }
+
+        // A failed default construction leaves no key behind.
+        Fragile::failAfter = 0;
+        EXPECT_THROW(map[PackedPosition(20, 1)], runtime_error);
+        EXPECT_FALSE(map.contains(PackedPosition(20, 1)));
+        EXPECT_EQ(map.size(), 8);
+
+        // Nor does a failed move into the slot.
+        Fragile::failAfter = 0;
+        EXPECT_THROW(map.insert(PackedPosition(21, 1), Fragile(21)), runtime_error);
+        EXPECT_FALSE(map.contains(PackedPosition(21, 1)));
+
+        // A copy failing part-way frees the values it already built.
+        Fragile::failAfter = 3;
+        EXPECT_THROW(PositionMap<Fragile> copy(map), runtime_error);
+
+        // Growing past 12 entries rehashes; a failing move leaves the map usable.
+        for (uint32_t i = 9; i <= 12; ++i) { map.insert(PackedPosition(i, 1), Fragile(int(i))); }
+        Fragile::failAfter = 5;
+        EXPECT_THROW(map.insert(PackedPosition(13, 1), Fragile(13)), runtime_error);
+
+        Fragile::failAfter = -1;
+        EXPECT_TRUE(map.erase(PackedPosition(1, 1)));
+        map[PackedPosition(30, 1)].value = 30;
+        EXPECT_EQ(map.find(PackedPosition(30, 1))->value, 30);
+        EXPECT_EQ(Fragile::live, int(map.size()));
+    }
+
+    EXPECT_EQ(Fragile::live, 0);
+}
+#endif
@@ -1,6 +1,7 @@
 #include <text/position.hpp>
 
 #include <gtest/gtest.h>
+#include "raises.hpp"
 
 using namespace Text;
 using namespace std;
@@ -41,7 +42,7 @@ TEST(PositionClassTestSuite, position_instantiation)
     EXPECT_NO_THROW(Position pos(1, 1));  // NO THROW
 
     // TODO: FIXME
-    // EXPECT_THROW(Position pos(-1, -1), X_);  // THROWS X_
+    // EXPECT_RAISES(Position pos(-1, -1), X_);  // THROWS X_
 
     // Position pos;
     EXPECT_EQ(1, 1);
@@ -174,4 +175,24 @@ TEST(PositionClassTestSuite, position_operator_lesser_or_equal)
     EXPECT_TRUE (pos_03_00 <= pos_03);      // (3, 0) <= (3, 1) -> T
     EXPECT_TRUE (pos_03_01 <= pos_03);      // (3, 1) <= (3, 1) -> T
     EXPECT_FALSE(pos_03_02 <= pos_03);      // (3, 2) <= (3, 1) -> F
-}
\ No newline at end of file
+}
+
+
+
+
+
+
+
+
+
+TEST(PositionClassTestSuite, position_thirty_two_bit)
+{
+    static_assert(sizeof(Position32) == 8);
+
+    Position32 pos(4, 2);
+    EXPECT_EQ(pos.getRow(), 4u);
+    EXPECT_EQ(pos.getCol(), 2u);
+    EXPECT_TRUE(Position32(1, 9) < Position32(2, 1));
+
+    EXPECT_RAISES(Position32(size_t(UINT32_MAX) + 1, 1), Exception);
+}
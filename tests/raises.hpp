@@ -0,0 +1,28 @@
+#pragma once
+#ifndef TESTS_RAISES_HPP
+#define TESTS_RAISES_HPP
+
+#include <gtest/gtest.h>
+
+
+/**************************************************************
+ * EXPECT_RAISES: Expect `statement` to report an error of type
+ * `type`. The library throws it by default; in no-exceptions
+ * builds (TEXT_BUFFER_NO_EXCEPTIONS) it reaches the error handler,
+ * which aborts, so the check becomes a death test.
+ **************************************************************/
+#ifdef TEXT_BUFFER_NO_EXCEPTIONS
+#    define EXPECT_RAISES(statement, type) EXPECT_DEATH(statement, "")
+
+// Tests compile without exceptions too, so gtest's try-based check cannot be used; an error
+// would abort the test instead.
+#    undef EXPECT_NO_THROW
+#    define EXPECT_NO_THROW(statement) \
+        do {                           \
+            statement;                 \
+        } while (false)
+#else
+#    define EXPECT_RAISES(statement, type) EXPECT_THROW(statement, type)
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+#include <text/shift-kernels.hpp>
+#include <text/position.hpp>
+
+#include <gtest/gtest.h>
+#include "raises.hpp"
+
+#include <cstdint>
+#include <random>
+#include <utils/err.hpp>
+#include <vector>
+
+using namespace Text;
+using namespace std;
+
+
+
+
+
+
+
+
+
+
+TEST(ShiftKernelsTestSuite, shift_from_threshold)
+{
+    mt19937          rng(3);
+    vector<uint32_t> values(1000);
+    for (auto &value : values) { value = rng() % 500; }
+
+    vector<uint32_t> expected = values;
+    for (auto &value : expected) { value += value >= 200 ? 7 : 0; }
+
+    shiftFrom(span<uint32_t>(values), 200u, 7);
+    EXPECT_EQ(values, expected);
+
+    for (auto &value : expected) { value -= value >= 207 ? 7 : 0; }
+    shiftFrom(span<uint32_t>(values), 207u, -7);
+    EXPECT_EQ(values, expected);
+}
+
+
+
+
+TEST(ShiftKernelsTestSuite, underflow_and_overflow)
+{
+    vector<uint32_t> values = { 1, 5, 9 };
+
+    // 5 - 6 is negative; nothing is shifted.
+    EXPECT_RAISES(shiftFrom(span<uint32_t>(values), 2u, -6), X_);
+    EXPECT_EQ(values, (vector<uint32_t>{ 1, 5, 9 }));
+
+    // Only values >= 6 move, & 9 - 6 stays positive.
+    shiftFrom(span<uint32_t>(values), 6u, -6);
+    EXPECT_EQ(values, (vector<uint32_t>{ 1, 5, 3 }));
+
+    // 3 would fit, but nothing is shifted when another value overflows.
+    vector<uint32_t> large = { 3, UINT32_MAX - 1 };
+    EXPECT_RAISES(shiftFrom(span<uint32_t>(large), 0u, 2), X_);
+    EXPECT_EQ(large, (vector<uint32_t>{ 3, UINT32_MAX - 1 }));
+
+#ifndef TEXT_BUFFER_NO_EXCEPTIONS
+    try {
+        shiftFrom(span<uint32_t>(values), 0u, -2);
+    }
+    catch (const X_ &err) {
+        EXPECT_EQ(err.getId(), ERR_ID::INVALID_NUMBER_SIGN);
+    }
+#endif
+}
+
+
+
+
+TEST(ShiftKernelsTestSuite, keyed_and_coordinate_shifts)
+{
+    vector<size_t>       cols = { 4, 8, 8, 2 };
+    const vector<size_t> rows = { 1, 1, 2, 1 };
+
+    shiftWhere(span<size_t>(cols), span<const size_t>(rows), size_t(1), size_t(3), 10);
+    EXPECT_EQ(cols, (vector<size_t>{ 14, 18, 8, 2 }));
+
+    vector<Coordinate> coords = { Coordinate(1), Coordinate(4), Coordinate(6) };
+    shiftFrom(span<Coordinate>(coords), Coordinate(4), -3);
+    EXPECT_EQ(coords[0], 1);
+    EXPECT_EQ(coords[1], 1);
+    EXPECT_EQ(coords[2], 3);
+    EXPECT_RAISES(shiftFrom(span<Coordinate>(coords), Coordinate(2), -4), X_);
+}
+
+
+
+
+TEST(ShiftKernelsTestSuite, position_shifts)
+{
+    vector<Position> positions = { Position(1, 5), Position(3, 2), Position(3, 9), Position(6, 1) };
+
+    Position::shiftRows(positions, 3, 2);
+    EXPECT_TRUE(positions[0] == Position(1, 5));
+    EXPECT_TRUE(positions[1] == Position(5, 2));
+    EXPECT_TRUE(positions[3] == Position(8, 1));
+
+    Position::shiftCols(positions, 5, 3, -1);
+    EXPECT_TRUE(positions[1] == Position(5, 2));
+    EXPECT_TRUE(positions[2] == Position(5, 8));
+
+    EXPECT_RAISES(Position::shiftRows(positions, 1, -2), X_);
+}
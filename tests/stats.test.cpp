@@ -0,0 +1,103 @@
+#include <text/buffer.hpp>
+#include <text/stats.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+using namespace Text;
+using namespace std;
+
+
+
+
+
+
+
+
+
+
+TEST(StatsTestSuite, buffer_counts_its_work)
+{
+    Buffer buffer("abc\nh\xC3\xA9llo\nend");
+    buffer.addMarker(size_t(2));
+    buffer.addDecoration(Position(1, 1), Position(2, 2));
+
+    const Stats before       = buffer.stats();
+    const Stats threadBefore = threadStats();
+    buffer.insert(1, "xy\n");
+    buffer.utf16PositionOf(size_t(8));
+    buffer.utf16PositionOf(size_t(10));
+    const Stats delta       = buffer.stats() - before;
+    const Stats threadDelta = threadStats() - threadBefore;
+
+#if TEXT_BUFFER_STATS
+    EXPECT_EQ(before[Stat::INDEX_REBUILDS], 1);
+    EXPECT_EQ(before[Stat::BYTES_SCANNED], 14);
+    EXPECT_EQ(delta[Stat::EDITS_APPLIED], 1);
+    EXPECT_EQ(delta[Stat::INDEX_REBUILDS], 0);
+    EXPECT_EQ(delta[Stat::BYTES_SCANNED], 3);
+
+    // Const queries count on the thread only, never on the Buffer.
+    EXPECT_EQ(delta[Stat::CACHE_MISSES], 0);
+    EXPECT_EQ(delta[Stat::CACHE_HITS], 0);
+    EXPECT_EQ(threadDelta[Stat::CACHE_MISSES], 1);
+    EXPECT_EQ(threadDelta[Stat::CACHE_HITS], 1);
+    EXPECT_EQ(threadDelta[Stat::EDITS_APPLIED], 1);
+    EXPECT_GE(delta[Stat::TREE_SPLITS], 4);
+    EXPECT_GE(delta[Stat::TREE_MERGES], 4);
+    EXPECT_EQ(statName(Stat::CACHE_HITS), "cache_hits");
+#else
+    EXPECT_EQ(delta[Stat::EDITS_APPLIED], 0);
+    EXPECT_EQ(before[Stat::INDEX_REBUILDS], 0);
+#endif
+}
+
+
+
+
+TEST(StatsTestSuite, totals_include_finished_threads)
+{
+    const Stats before = Text::stats();
+    const Stats mine   = threadStats();
+
+    thread worker([] {
+        Buffer buffer(string(1000, 'a'));
+        for (size_t i = 0; i < 10; ++i) { buffer.insert(i, "\n"); }
+    });
+    worker.join();
+
+    const Stats delta = Text::stats() - before;
+
+#if TEXT_BUFFER_STATS
+    EXPECT_EQ(delta[Stat::EDITS_APPLIED], 10);
+    EXPECT_EQ(delta[Stat::INDEX_REBUILDS], 1);
+    EXPECT_EQ(delta[Stat::BYTES_SCANNED], 1010);
+#else
+    EXPECT_EQ(delta[Stat::EDITS_APPLIED], 0);
+#endif
+
+    // Another thread's work is not counted on this one.
+    EXPECT_EQ(threadStats()[Stat::EDITS_APPLIED], mine[Stat::EDITS_APPLIED]);
+}
+
+
+
+
+TEST(StatsTestSuite, copies_keep_counts)
+{
+    Buffer buffer("one\ntwo\n");
+    buffer.insert(0, "zero\n");
+
+    const Buffer copy(buffer);
+    EXPECT_EQ(copy.stats()[Stat::EDITS_APPLIED], buffer.stats()[Stat::EDITS_APPLIED]);
+
+    buffer.insert(0, "-");
+#if TEXT_BUFFER_STATS
+    EXPECT_EQ(copy.stats()[Stat::EDITS_APPLIED], 1);
+    EXPECT_EQ(buffer.stats()[Stat::EDITS_APPLIED], 2);
+#else
+    EXPECT_EQ(buffer.stats()[Stat::EDITS_APPLIED], 0);
+#endif
+}
@@ -0,0 +1,208 @@
+#include <text/buffer.hpp>
+#include <text/lexer.hpp>
+#include <text/token-table.hpp>
+
+#include <gtest/gtest.h>
+#include "raises.hpp"
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <utils/exception.hpp>
+#include <vector>
+
+using namespace Text;
+using namespace std;
+
+
+enum Kind : TokenKind { UNKNOWN, IDENT, NUMBER, SPACE, STRING, COMMENT, OP };
+
+
+static Lexicon script_lexicon()
+{
+    const CharSet alpha = CharSet::range('a', 'z') | CharSet::range('A', 'Z') | CharSet::of("_");
+    const CharSet digit = CharSet::range('0', '9');
+
+    Lexicon lexicon(UNKNOWN);
+    lexicon.run(IDENT, alpha, alpha | digit)
+      .run(NUMBER, digit, digit)
+      .run(SPACE, CharSet::of(" \n"), CharSet::of(" \n"))
+      .quoted(STRING, '"')
+      .quoted(STRING, '`', '\\', true)
+      .lineComment(COMMENT, "//")
+      .blockComment(COMMENT, "/*", "*/")
+      .literal(OP, "=")
+      .literal(OP, "==")
+      .literal(OP, "===")
+      .literal(OP, "/")
+      .skip(SPACE);
+    return lexicon;
+}
+
+
+static string script(size_t rows)
+{
+    string text;
+    for (size_t i = 0; i < rows; ++i) { text += "let v" + to_string(i) + " = \"s\" // c\n"; }
+    return text;
+}
+
+
+static void expect_same(const TokenTable &table, const Buffer &buffer, const Lexicon &lexicon)
+{
+    const TokenTable fresh(buffer, lexicon);
+
+    ASSERT_EQ(table.lineCount(), fresh.lineCount());
+    ASSERT_EQ(table.tokenCount(), fresh.tokenCount());
+
+    for (size_t row = 1; row <= fresh.lineCount(); ++row) {
+        ASSERT_EQ(table.lineState(row), fresh.lineState(row)) << "row " << row;
+
+        const auto got  = table.tokensIn(row);
+        const auto want = fresh.tokensIn(row);
+        ASSERT_EQ(got.size(), want.size()) << "row " << row;
+        for (size_t i = 0; i < got.size(); ++i) {
+            ASSERT_EQ(got[i].kind, want[i].kind) << "row " << row;
+            ASSERT_EQ(got[i].column, want[i].column) << "row " << row;
+            ASSERT_EQ(got[i].length, want[i].length) << "row " << row;
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+TEST(TokenTableTestSuite, rows_match_the_lexer)
+{
+    const Lexicon    lexicon = script_lexicon();
+    const Buffer     buffer("a = 1 /* x\ny */ b\n`t\nu` c\n");
+    const TokenTable table(buffer, lexicon);
+
+    ASSERT_EQ(table.lineCount(), buffer.lineCount());
+    EXPECT_EQ(table.lineState(1), 0);
+    EXPECT_EQ(table.lineState(2), 4);  // Inside the comment up to "b"
+    EXPECT_EQ(table.lineState(4), 2);
+
+    size_t row = 1, index = 0, seen = 0;
+    for (const Token &token : Lexer(buffer, lexicon)) {
+        while (index == table.tokensIn(row).size()) {
+            ++row;
+            index = 0;
+        }
+
+        const Token stored = table.token(buffer, row, index++);
+        EXPECT_EQ(stored.kind, token.kind);
+        EXPECT_EQ(stored.text, token.text);
+        EXPECT_EQ(stored.start, token.start);
+        EXPECT_EQ(stored.end, token.end);
+        ++seen;
+    }
+    EXPECT_EQ(seen, table.tokenCount());
+
+    EXPECT_RAISES(table.tokensIn(0), Text_Buffer::Exception);
+    EXPECT_RAISES(table.lineState(6), Text_Buffer::Exception);
+    EXPECT_RAISES(table.token(buffer, 1, 4), Text_Buffer::Exception);
+}
+
+
+
+
+TEST(TokenTableTestSuite, edits_relex_a_bounded_number_of_rows)
+{
+    const Lexicon lexicon = script_lexicon();
+
+    for (const size_t rows : { size_t(10), size_t(10000) }) {
+        Buffer     buffer(script(rows));
+        TokenTable table(buffer, lexicon);
+
+        // Typing inside a row, then splitting a row in two.
+        const size_t offset = buffer.offsetOf(Position(rows / 2, 5));
+        buffer.insert(offset, "x");
+        EXPECT_LE(table.update(buffer, offset, 0, 1), 2);
+
+        buffer.insert(offset, "\n");
+        EXPECT_LE(table.update(buffer, offset, 0, 1), 3);
+
+        buffer.erase(offset, 2);
+        EXPECT_LE(table.update(buffer, offset, 2, 0), 2);
+
+        expect_same(table, buffer, lexicon);
+    }
+}
+
+
+
+
+TEST(TokenTableTestSuite, comments_relex_until_states_converge)
+{
+    const Lexicon lexicon = script_lexicon();
+    Buffer        buffer(script(100));
+    TokenTable    table(buffer, lexicon);
+
+    // Opening a block comment changes every later row's state.
+    const size_t open = buffer.offsetOf(Position(10, 1));
+    buffer.insert(open, "/*");
+    EXPECT_GE(table.update(buffer, open, 0, 2), 92);
+    EXPECT_EQ(table.lineState(50), buffer.size() - buffer.offsetOf(Position(50, 1)));
+    expect_same(table, buffer, lexicon);
+
+    // Closing it five rows later turns the rows after back into code.
+    const size_t close = buffer.offsetOf(Position(15, 1));
+    buffer.insert(close, "*/");
+    EXPECT_GE(table.update(buffer, close, 0, 2), 87);
+    EXPECT_EQ(table.lineState(16), 0);
+    expect_same(table, buffer, lexicon);
+
+    // Typing inside the comment re-lexes from its opening row & stops at the row after the edit.
+    const size_t inside = buffer.offsetOf(Position(12, 4));
+    buffer.insert(inside, "zz");
+    EXPECT_EQ(table.update(buffer, inside, 0, 2), 3);
+    expect_same(table, buffer, lexicon);
+}
+
+
+
+
+TEST(TokenTableTestSuite, random_edits_match_a_rebuild)
+{
+    const Lexicon     lexicon = script_lexicon();
+    const string_view pieces[] = { "a", "1", " ", "\n", "\"", "`", "/",
+                                   "*", "=", "//", "/*", "*/", "\\" };
+    mt19937           rng(11);
+
+    Buffer     buffer(script(30));
+    TokenTable table(buffer, lexicon);
+
+    for (size_t step = 0; step < 2000; ++step) {
+        const size_t offset  = rng() % (buffer.size() + 1);
+        const size_t removed = min<size_t>(rng() % 4, buffer.size() - offset);
+
+        string text;
+        for (size_t i = rng() % 4; i > 0; --i) { text += pieces[rng() % size(pieces)]; }
+
+        buffer.replace(offset, removed, text);
+        table.update(buffer, offset, removed, text.size());
+        ASSERT_NO_FATAL_FAILURE(expect_same(table, buffer, lexicon)) << "step " << step;
+    }
+}
+
+
+
+
+TEST(TokenTableTestSuite, mismatched_edits_raise)
+{
+    const Lexicon lexicon = script_lexicon();
+    Buffer        buffer("abc\n");
+    TokenTable    table(buffer, lexicon);
+
+    buffer.insert(1, "xy");
+    EXPECT_RAISES(table.update(buffer, 1, 0, 1), Text_Buffer::Exception);
+    EXPECT_RAISES(table.update(buffer, 10, 0, 2), Text_Buffer::Exception);
+    EXPECT_EQ(table.update(buffer, 1, 0, 2), 1);
+}
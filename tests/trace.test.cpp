@@ -0,0 +1,138 @@
+#include <text/buffer.hpp>
+#include <text/trace.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+using namespace Text;
+using namespace std;
+
+
+
+
+static size_t occurrences(const string &text, const string &needle)
+{
+    size_t count = 0;
+    for (size_t i = text.find(needle); i != text.npos; i = text.find(needle, i + 1)) { ++count; }
+    return count;
+}
+
+
+
+
+
+
+
+
+
+
+TEST(TraceTestSuite, spans_are_recorded_while_tracing)
+{
+    clearTrace();
+
+    Buffer untraced("abc\n");
+    untraced.insert(0, "x");
+
+    setTracing(true);
+    Buffer buffer("abc\ndef\n");
+    buffer.insert(1, "xy\n");
+    thread([] { Buffer other("in a thread"); }).join();
+    setTracing(false);
+
+    buffer.insert(0, "z");
+    const string json = traceJson();
+
+    EXPECT_TRUE(json.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+
+#if TEXT_BUFFER_TRACE
+    EXPECT_TRUE(tracing() == false);
+    EXPECT_EQ(occurrences(json, "\"name\":\"buffer.load\""), 2);
+    EXPECT_EQ(occurrences(json, "\"name\":\"buffer.index\""), 2);
+    EXPECT_EQ(occurrences(json, "\"name\":\"buffer.edit\""), 1);
+    EXPECT_EQ(occurrences(json, "\"ph\":\"X\""), 5);
+    EXPECT_EQ(occurrences(json, "\"args\":{\"bytes\":8}"), 2);
+    EXPECT_EQ(occurrences(json, "\"tid\":"), 5);
+#else
+    EXPECT_EQ(occurrences(json, "\"ph\":\"X\""), 0);
+#endif
+
+    clearTrace();
+    EXPECT_EQ(occurrences(traceJson(), "\"ph\":\"X\""), 0);
+}
+
+
+
+
+TEST(TraceTestSuite, ring_keeps_the_latest_spans)
+{
+    clearTrace();
+    setTracing(true);
+
+    for (size_t i = 0; i < TRACE_CAPACITY + 10; ++i) { const TraceSpan span("span"); }
+    { const TraceSpan span("last"); }
+
+    setTracing(false);
+    const string json = traceJson();
+
+#if TEXT_BUFFER_TRACE
+    EXPECT_EQ(occurrences(json, "\"name\":\"span\""), TRACE_CAPACITY - 1);
+    EXPECT_EQ(occurrences(json, "\"name\":\"last\""), 1);
+#else
+    EXPECT_EQ(occurrences(json, "\"name\":\"span\""), 0);
+#endif
+
+    clearTrace();
+}
+
+
+
+
+TEST(TraceTestSuite, exited_threads_keep_the_latest_spans)
+{
+    clearTrace();
+    setTracing(true);
+
+    // Enough full rings to overflow the spans kept from exited threads.
+    const size_t threads = TRACE_RETIRED_CAPACITY / TRACE_CAPACITY + 2;
+    for (size_t t = 0; t < threads; ++t) {
+        thread([] {
+            for (size_t i = 0; i < TRACE_CAPACITY; ++i) { const TraceSpan span("old"); }
+        }).join();
+    }
+    thread([] { const TraceSpan span("last"); }).join();
+
+    setTracing(false);
+    const string json = traceJson();
+
+#if TEXT_BUFFER_TRACE
+    EXPECT_EQ(occurrences(json, "\"name\":\"old\""), TRACE_RETIRED_CAPACITY - 1);
+    EXPECT_EQ(occurrences(json, "\"name\":\"last\""), 1);
+#else
+    EXPECT_EQ(occurrences(json, "\"name\":\"old\""), 0);
+#endif
+
+    clearTrace();
+}
+
+
+
+
+TEST(TraceTestSuite, names_are_escaped)
+{
+    clearTrace();
+    setTracing(true);
+    { const TraceSpan span("say \"hi\" \\ bye"); }
+    setTracing(false);
+
+    const string json = traceJson();
+
+#if TEXT_BUFFER_TRACE
+    EXPECT_EQ(occurrences(json, "\"name\":\"say \\\"hi\\\" \\\\ bye\""), 1);
+#else
+    EXPECT_EQ(occurrences(json, "\"name\":"), 0);
+#endif
+
+    clearTrace();
+}